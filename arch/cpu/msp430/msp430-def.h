@@ -120,6 +120,9 @@ void *w_memset(void *out, int value, size_t n);
 
 /* Platform-specific checksum implementation */
 #define UIP_ARCH_IPCHKSUM        1
+#ifndef UIP_CONF_CHKSUM_WORD
+#define UIP_CONF_CHKSUM_WORD     2
+#endif
 
 #define BAUD2UBR(baud) ((F_CPU/baud))
 
@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         AES-128 driver of the native platform, using AES-NI when the
+ *         host CPU supports it.
+ */
+
+#include "dev/native-aes-128.h"
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <wmmintrin.h>
+#define NATIVE_AES_128_NI 1
+#else
+#define NATIVE_AES_128_NI 0
+#endif
+/*---------------------------------------------------------------------------*/
+#if NATIVE_AES_128_NI
+#define AESNI __attribute__((target("aes,sse2")))
+
+static __m128i round_keys[11];
+static uint8_t has_key;
+static int has_aesni = -1;
+/*---------------------------------------------------------------------------*/
+AESNI static __m128i
+expand_step(__m128i key, __m128i assist)
+{
+  assist = _mm_shuffle_epi32(assist, 0xff);
+  key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+  key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+  key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+  return _mm_xor_si128(key, assist);
+}
+/*---------------------------------------------------------------------------*/
+AESNI static void
+aesni_set_key(const uint8_t *key)
+{
+  __m128i k;
+
+  /* The first round key is the key itself */
+  k = _mm_loadu_si128((const __m128i *)key);
+  if(has_key && _mm_movemask_epi8(_mm_cmpeq_epi8(k, round_keys[0])) == 0xffff) {
+    return;
+  }
+  has_key = 1;
+
+  /* Unrolled, as the round constant must be an immediate */
+  round_keys[0] = k;
+  k = expand_step(k, _mm_aeskeygenassist_si128(k, 0x01));
+  round_keys[1] = k;
+  k = expand_step(k, _mm_aeskeygenassist_si128(k, 0x02));
+  round_keys[2] = k;
+  k = expand_step(k, _mm_aeskeygenassist_si128(k, 0x04));
+  round_keys[3] = k;
+  k = expand_step(k, _mm_aeskeygenassist_si128(k, 0x08));
+  round_keys[4] = k;
+  k = expand_step(k, _mm_aeskeygenassist_si128(k, 0x10));
+  round_keys[5] = k;
+  k = expand_step(k, _mm_aeskeygenassist_si128(k, 0x20));
+  round_keys[6] = k;
+  k = expand_step(k, _mm_aeskeygenassist_si128(k, 0x40));
+  round_keys[7] = k;
+  k = expand_step(k, _mm_aeskeygenassist_si128(k, 0x80));
+  round_keys[8] = k;
+  k = expand_step(k, _mm_aeskeygenassist_si128(k, 0x1b));
+  round_keys[9] = k;
+  k = expand_step(k, _mm_aeskeygenassist_si128(k, 0x36));
+  round_keys[10] = k;
+}
+/*---------------------------------------------------------------------------*/
+AESNI static void
+aesni_encrypt(uint8_t *plaintext_and_result)
+{
+  __m128i s;
+  int round;
+
+  s = _mm_loadu_si128((const __m128i *)plaintext_and_result);
+  s = _mm_xor_si128(s, round_keys[0]);
+  for(round = 1; round < 10; round++) {
+    s = _mm_aesenc_si128(s, round_keys[round]);
+  }
+  s = _mm_aesenclast_si128(s, round_keys[10]);
+  _mm_storeu_si128((__m128i *)plaintext_and_result, s);
+}
+/*---------------------------------------------------------------------------*/
+/* The two blocks go through the rounds interleaved to hide the latency
+   of the AES instructions */
+AESNI static void
+aesni_encrypt_pair(uint8_t *plaintext_and_result1,
+                   uint8_t *plaintext_and_result2)
+{
+  __m128i s1, s2;
+  int round;
+
+  s1 = _mm_loadu_si128((const __m128i *)plaintext_and_result1);
+  s2 = _mm_loadu_si128((const __m128i *)plaintext_and_result2);
+  s1 = _mm_xor_si128(s1, round_keys[0]);
+  s2 = _mm_xor_si128(s2, round_keys[0]);
+  for(round = 1; round < 10; round++) {
+    s1 = _mm_aesenc_si128(s1, round_keys[round]);
+    s2 = _mm_aesenc_si128(s2, round_keys[round]);
+  }
+  s1 = _mm_aesenclast_si128(s1, round_keys[10]);
+  s2 = _mm_aesenclast_si128(s2, round_keys[10]);
+  _mm_storeu_si128((__m128i *)plaintext_and_result1, s1);
+  _mm_storeu_si128((__m128i *)plaintext_and_result2, s2);
+}
+/*---------------------------------------------------------------------------*/
+static int
+use_aesni(void)
+{
+  if(has_aesni < 0) {
+    __builtin_cpu_init();
+    has_aesni = __builtin_cpu_supports("aes") ? 1 : 0;
+  }
+  return has_aesni;
+}
+#endif /* NATIVE_AES_128_NI */
+/*---------------------------------------------------------------------------*/
+static void
+set_key(const uint8_t *key)
+{
+#if NATIVE_AES_128_NI
+  if(use_aesni()) {
+    aesni_set_key(key);
+    return;
+  }
+#endif /* NATIVE_AES_128_NI */
+  aes_128_ttable_driver.set_key(key);
+}
+/*---------------------------------------------------------------------------*/
+static void
+encrypt(uint8_t *plaintext_and_result)
+{
+#if NATIVE_AES_128_NI
+  if(use_aesni()) {
+    aesni_encrypt(plaintext_and_result);
+    return;
+  }
+#endif /* NATIVE_AES_128_NI */
+  aes_128_ttable_driver.encrypt(plaintext_and_result);
+}
+/*---------------------------------------------------------------------------*/
+static void
+encrypt_pair(uint8_t *plaintext_and_result1, uint8_t *plaintext_and_result2)
+{
+#if NATIVE_AES_128_NI
+  if(use_aesni()) {
+    aesni_encrypt_pair(plaintext_and_result1, plaintext_and_result2);
+    return;
+  }
+#endif /* NATIVE_AES_128_NI */
+  aes_128_ttable_driver.encrypt(plaintext_and_result1);
+  aes_128_ttable_driver.encrypt(plaintext_and_result2);
+}
+/*---------------------------------------------------------------------------*/
+static void
+save_key(uint8_t *schedule)
+{
+#if NATIVE_AES_128_NI
+  if(use_aesni()) {
+    memcpy(schedule, round_keys, AES_128_SCHEDULE_SIZE);
+    return;
+  }
+#endif /* NATIVE_AES_128_NI */
+  aes_128_ttable_driver.save_key(schedule);
+}
+/*---------------------------------------------------------------------------*/
+static void
+load_key(const uint8_t *schedule)
+{
+#if NATIVE_AES_128_NI
+  if(use_aesni()) {
+    memcpy(round_keys, schedule, AES_128_SCHEDULE_SIZE);
+    has_key = 1;
+    return;
+  }
+#endif /* NATIVE_AES_128_NI */
+  aes_128_ttable_driver.load_key(schedule);
+}
+/*---------------------------------------------------------------------------*/
+const struct aes_128_driver native_aes_128_driver = {
+  set_key,
+  encrypt,
+  encrypt_pair,
+  save_key,
+  load_key
+};
+/*---------------------------------------------------------------------------*/
@@ -64,12 +64,15 @@
 #include <err.h>
 #include "net/netstack.h"
 #include "net/packetbuf.h"
+#include "tun6-net.h"
 
 static const char *config_ipaddr = "fd00::1/64";
 /* Allocate some bytes in RAM and copy the string */
 static char config_tundev[IFNAMSIZ + 1] = "tun0";
 
 
+struct tun6_net_stats tun6_net_stats;
+
 #ifndef __CYGWIN__
 static int tunfd = -1;
 
@@ -219,6 +222,13 @@ tun_init()
 
   LOG_INFO("Tun open:%d\n", tunfd);
 
+#if TUN6_NET_BATCH > 1
+  /* Drain the device until it would block instead of one packet per wakeup */
+  if(fcntl(tunfd, F_SETFL, fcntl(tunfd, F_GETFL) | O_NONBLOCK) == -1) {
+    err(1, "tun_init: fcntl");
+  }
+#endif /* TUN6_NET_BATCH > 1 */
+
   select_set_callback(tunfd, &tun_select_callback);
 
   fprintf(stderr, "opened %s device ``/dev/%s''\n",
@@ -235,10 +245,24 @@ tun_init()
 static int
 tun_output(uint8_t *data, int len)
 {
+  int size;
+
   /* fprintf(stderr, "*** Writing to tun...%d\n", len); */
-  if(tunfd != -1 && write(tunfd, data, len) != len) {
+  if(tunfd == -1) {
+    return 0;
+  }
+
+  size = write(tunfd, data, len);
+  if(size == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+    /* Only in non-blocking mode: the packet is dropped like on any
+       congested link */
+    tun6_net_stats.tx_dropped++;
+    return 0;
+  }
+  if(size != len) {
     err(1, "serial_to_tun: write");
   }
+  tun6_net_stats.tx_packets++;
   return 0;
 }
 /*---------------------------------------------------------------------------*/
@@ -253,6 +277,10 @@ tun_input(unsigned char *data, int maxlen)
   }
 
   if((size = read(tunfd, data, maxlen)) == -1) {
+    if(errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+      /* Nothing more to read */
+      return 0;
+    }
     err(1, "tun_input: read");
   }
   return size;
@@ -289,6 +317,7 @@ static void
 handle_fd(fd_set *rset, fd_set *wset)
 {
   int size;
+  int i;
 
   if(tunfd == -1) {
     /* tun is not open */
@@ -298,10 +327,19 @@ handle_fd(fd_set *rset, fd_set *wset)
   LOG_INFO("Tun6-handle FD\n");
 
   if(FD_ISSET(tunfd, rset)) {
-    size = tun_input(uip_buf, sizeof(uip_buf));
-    LOG_DBG("TUN data incoming read:%d\n", size);
-    uip_len = size;
-    tcpip_input();
+    tun6_net_stats.wakeups++;
+    /* tcpip_input() is done with uip_buf when it returns, so each
+       packet can be read straight into it */
+    for(i = 0; i < TUN6_NET_BATCH; i++) {
+      size = tun_input(uip_buf, sizeof(uip_buf));
+      LOG_DBG("TUN data incoming read:%d\n", size);
+      if(size <= 0) {
+        break;
+      }
+      tun6_net_stats.rx_packets++;
+      uip_len = size;
+      tcpip_input();
+    }
   }
 }
 #endif /*  __CYGWIN_ */
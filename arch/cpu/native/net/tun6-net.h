@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2011, Swedish Institute of Computer Science.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Header file for the native tun6 network driver
+ */
+
+#ifndef TUN6_NET_H_
+#define TUN6_NET_H_
+
+#include "contiki.h"
+#include "net/netstack.h"
+
+/*
+ * Maximum number of packets handled per select wakeup. With the
+ * default of 1, the tun device is used in blocking mode and one packet
+ * is read per wakeup. Larger values put the device in non-blocking
+ * mode: all pending packets (up to the limit) are read and passed to
+ * the stack in one go, and a packet that cannot be written without
+ * blocking is dropped and counted instead of stalling the event loop.
+ */
+#ifdef TUN6_NET_CONF_BATCH
+#define TUN6_NET_BATCH TUN6_NET_CONF_BATCH
+#else
+#define TUN6_NET_BATCH 1
+#endif
+
+struct tun6_net_stats {
+  uint32_t wakeups;   /* Select wakeups with tun data to read */
+  uint32_t rx_packets;
+  uint32_t tx_packets;
+  uint32_t tx_dropped;
+};
+
+extern struct tun6_net_stats tun6_net_stats;
+extern const struct network_driver tun6_net_driver;
+
+#endif /* TUN6_NET_H_ */
@@ -48,6 +48,9 @@
 struct select_callback {
   int  (* set_fd)(fd_set *fdr, fd_set *fdw);
   void (* handle_fd)(fd_set *fdr, fd_set *fdw);
+  /* With the epoll backend, only report the descriptor when it becomes
+     ready again: handle_fd() must then consume all there is to read */
+  uint8_t edge_triggered;
 };
 int select_set_callback(int fd, const struct select_callback *callback);
 
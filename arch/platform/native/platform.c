@@ -47,6 +47,7 @@
 #include <unistd.h>
 #include <sys/select.h>
 #include <errno.h>
+#include <time.h>
 
 #ifdef __CYGWIN__
 #include "net/wpcap-drv.h"
@@ -108,18 +109,267 @@
 #else
 #define SELECT_STDIN 1
 #endif
+
+/*
+ * Uses epoll(7) instead of select(2) to wait for the monitored file
+ * descriptors. The interest of each descriptor is kept registered with
+ * the kernel and only updated when set_fd() changes it, only the
+ * callbacks of the ready descriptors are called, and a timerfd wakes
+ * the main loop when the next etimer expires. Available on Linux only.
+ */
+#ifdef SELECT_CONF_EPOLL
+#define SELECT_EPOLL SELECT_CONF_EPOLL
+#elif defined(__linux__)
+#define SELECT_EPOLL 1
+#else
+#define SELECT_EPOLL 0
+#endif
 /** @} */
 /*---------------------------------------------------------------------------*/
 
+#if SELECT_EPOLL
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#endif /* SELECT_EPOLL */
+
 static const struct select_callback *select_callback[SELECT_MAX];
 static int select_max = 0;
 
+#if SELECT_EPOLL
+static int epoll_fd = -1;
+/* The registered descriptors, to avoid scanning all of select_callback[] */
+static int select_fds[SELECT_MAX];
+static int select_count;
+/* The events each descriptor is registered for */
+static uint32_t select_events[SELECT_MAX];
+/* Descriptors that epoll refuses (regular files): always ready */
+static uint8_t select_always_ready[SELECT_MAX];
+
+static int timer_fd = -1;
+static clock_time_t timer_deadline;
+static uint8_t timer_armed;
+#endif /* SELECT_EPOLL */
+
 #ifdef PLATFORM_CONF_MAC_ADDR
 static uint8_t mac_addr[] = PLATFORM_CONF_MAC_ADDR;
 #else /* PLATFORM_CONF_MAC_ADDR */
 static uint8_t mac_addr[] = { 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08 };
 #endif /* PLATFORM_CONF_MAC_ADDR */
 
+/*---------------------------------------------------------------------------*/
+#if SELECT_EPOLL
+static int
+epoll_init(void)
+{
+  struct epoll_event ev;
+
+  if(epoll_fd != -1) {
+    return 1;
+  }
+
+  epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  if(epoll_fd == -1) {
+    perror("epoll_create1");
+    return 0;
+  }
+
+  timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+  if(timer_fd == -1) {
+    perror("timerfd_create");
+  } else {
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.fd = timer_fd;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, timer_fd, &ev);
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+epoll_register(int fd, const struct select_callback *callback)
+{
+  struct epoll_event ev;
+  int registered;
+  int i;
+
+  if(!epoll_init()) {
+    /* The main loop falls back to select() */
+    return 1;
+  }
+
+  if(callback == NULL) {
+    for(i = 0; i < select_count; i++) {
+      if(select_fds[i] == fd) {
+        select_fds[i] = select_fds[--select_count];
+        /* Fails harmlessly if the descriptor has already been closed */
+        epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, NULL);
+        break;
+      }
+    }
+    return 1;
+  }
+
+  /* No interest until the first set_fd() call. A descriptor that is
+     registered again may have been closed and its number reused, which
+     removed it from the epoll set, so it is added if it is not there. */
+  registered = select_callback[fd] != NULL;
+  memset(&ev, 0, sizeof(ev));
+  ev.events = callback->edge_triggered ? EPOLLET : 0;
+  ev.data.fd = fd;
+  select_events[fd] = ev.events;
+  select_always_ready[fd] = 0;
+  if(epoll_ctl(epoll_fd, EPOLL_CTL_MOD, fd, &ev) == -1 &&
+     (errno != ENOENT || epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) == -1)) {
+    if(errno != EPERM) {
+      perror("epoll_ctl");
+      return 0;
+    }
+    /* A regular file, which select() always reports as ready */
+    select_always_ready[fd] = 1;
+  }
+  if(!registered) {
+    select_fds[select_count++] = fd;
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Arm the timerfd for the next etimer expiration, if it has changed */
+static void
+epoll_set_timer(void)
+{
+  struct itimerspec its;
+  struct timespec now;
+  clock_time_t deadline;
+  long diff;
+
+  if(timer_fd == -1 || !etimer_pending()) {
+    return;
+  }
+
+  deadline = etimer_next_expiration_time();
+  if(timer_armed && deadline == timer_deadline) {
+    return;
+  }
+
+  /* Convert to an absolute monotonic time, which is what clock_time()
+     counts in, without depending on clock_time_t being wide enough */
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  diff = (long)(deadline - clock_time());
+  if(diff < 1) {
+    diff = 1;
+  }
+  memset(&its, 0, sizeof(its));
+  its.it_value.tv_sec = now.tv_sec + diff / CLOCK_SECOND;
+  its.it_value.tv_nsec = (now.tv_nsec / (1000000000 / CLOCK_SECOND)) *
+    (1000000000 / CLOCK_SECOND) +
+    (diff % CLOCK_SECOND) * (1000000000 / CLOCK_SECOND);
+  if(its.it_value.tv_nsec >= 1000000000) {
+    its.it_value.tv_sec++;
+    its.it_value.tv_nsec -= 1000000000;
+  }
+  if(timerfd_settime(timer_fd, TFD_TIMER_ABSTIME, &its, NULL) == 0) {
+    timer_deadline = deadline;
+    timer_armed = 1;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+epoll_wait_fds(int busy)
+{
+  static struct epoll_event events[SELECT_MAX + 1];
+  static fd_set fdr, fdw;
+  uint64_t expirations;
+  uint32_t interest;
+  int i, fd, n, ready;
+
+  /* Collect the current interest of every callback, and only tell
+     the kernel about the changes */
+  FD_ZERO(&fdr);
+  FD_ZERO(&fdw);
+  ready = 0;
+  for(i = 0; i < select_count; i++) {
+    fd = select_fds[i];
+    interest = select_events[fd] & EPOLLET;
+    if(select_callback[fd]->set_fd(&fdr, &fdw)) {
+      if(FD_ISSET(fd, &fdr)) {
+        interest |= EPOLLIN;
+      }
+      if(FD_ISSET(fd, &fdw)) {
+        interest |= EPOLLOUT;
+      }
+    }
+    if(select_always_ready[fd]) {
+      select_events[fd] = interest;
+      ready |= (interest & (EPOLLIN | EPOLLOUT)) != 0;
+    } else if(interest != select_events[fd]) {
+      events[0].events = interest;
+      events[0].data.fd = fd;
+      if(epoll_ctl(epoll_fd, EPOLL_CTL_MOD, fd, &events[0]) == 0) {
+        select_events[fd] = interest;
+      }
+    }
+  }
+
+  epoll_set_timer();
+
+  n = epoll_wait(epoll_fd, events, SELECT_MAX + 1,
+                 busy || ready ? 0 : SELECT_TIMEOUT);
+  if(n < 0) {
+    if(errno != EINTR) {
+      perror("epoll_wait");
+    }
+    return;
+  }
+
+  /* Report the readiness in the fd_sets the callbacks expect */
+  FD_ZERO(&fdr);
+  FD_ZERO(&fdw);
+  for(i = 0; i < n; i++) {
+    fd = events[i].data.fd;
+    if(fd == timer_fd) {
+      if(read(timer_fd, &expirations, sizeof(expirations)) > 0) {
+        timer_armed = 0;
+      }
+      continue;
+    }
+    if(events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+      FD_SET(fd, &fdr);
+    }
+    if(events[i].events & (EPOLLOUT | EPOLLERR)) {
+      FD_SET(fd, &fdw);
+    }
+  }
+  if(ready) {
+    for(i = 0; i < select_count; i++) {
+      fd = select_fds[i];
+      if(select_always_ready[fd]) {
+        if(select_events[fd] & EPOLLIN) {
+          FD_SET(fd, &fdr);
+        }
+        if(select_events[fd] & EPOLLOUT) {
+          FD_SET(fd, &fdw);
+        }
+      }
+    }
+  }
+
+  for(i = 0; i < n; i++) {
+    fd = events[i].data.fd;
+    /* A callback may have unregistered another one */
+    if(fd != timer_fd && select_callback[fd] != NULL) {
+      select_callback[fd]->handle_fd(&fdr, &fdw);
+    }
+  }
+  if(ready) {
+    for(i = 0; i < select_count; i++) {
+      fd = select_fds[i];
+      if(select_always_ready[fd] && select_callback[fd] != NULL) {
+        select_callback[fd]->handle_fd(&fdr, &fdw);
+      }
+    }
+  }
+}
+#endif /* SELECT_EPOLL */
 /*---------------------------------------------------------------------------*/
 int
 select_set_callback(int fd, const struct select_callback *callback)
@@ -132,6 +382,12 @@ select_set_callback(int fd, const struct select_callback *callback)
       callback = NULL;
     }
 
+#if SELECT_EPOLL
+    if(epoll_register(fd, callback) == 0) {
+      return 0;
+    }
+#endif /* SELECT_EPOLL */
+
     select_callback[fd] = callback;
 
     /* Update fd max */
@@ -289,6 +545,10 @@ platform_init_stage_three()
 void
 platform_main_loop()
 {
+#if SELECT_EPOLL
+  /* Falls back to select() if epoll is not available */
+  epoll_init();
+#endif /* SELECT_EPOLL */
 #if SELECT_STDIN
   select_set_callback(STDIN_FILENO, &stdin_fd);
 #endif /* SELECT_STDIN */
@@ -302,6 +562,14 @@ platform_main_loop()
 
     retval = process_run();
 
+#if SELECT_EPOLL
+    if(epoll_fd != -1) {
+      epoll_wait_fds(retval);
+      etimer_request_poll();
+      continue;
+    }
+#endif /* SELECT_EPOLL */
+
     tv.tv_sec = retval ? 0 : SELECT_TIMEOUT / 1000;
     tv.tv_usec = retval ? 1 : (SELECT_TIMEOUT * 1000) % 1000000;
 
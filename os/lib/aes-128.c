@@ -65,6 +65,7 @@ static const uint8_t sbox[256] =   {
 0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16 };
 
 static uint8_t round_keys[11][AES_128_KEY_LENGTH];
+static uint8_t has_key;
 
 /*---------------------------------------------------------------------------*/
 /* multiplies by 2 in GF(2) */
@@ -81,7 +82,13 @@ set_key(const uint8_t *key)
   uint8_t i;
   uint8_t j;
   uint8_t rcon;
-  
+
+  /* The first round key is the key itself */
+  if(has_key && !memcmp(round_keys[0], key, AES_128_KEY_LENGTH)) {
+    return;
+  }
+  has_key = 1;
+
   rcon = 0x01;
   memcpy(round_keys[0], key, AES_128_KEY_LENGTH);
   for(i = 1; i <= 10; i++) {
@@ -166,8 +173,36 @@ encrypt(uint8_t *state)
   }
 }
 /*---------------------------------------------------------------------------*/
+static void
+save_key(uint8_t *schedule)
+{
+  memcpy(schedule, round_keys, AES_128_SCHEDULE_SIZE);
+}
+/*---------------------------------------------------------------------------*/
+static void
+load_key(const uint8_t *schedule)
+{
+  memcpy(round_keys, schedule, AES_128_SCHEDULE_SIZE);
+  has_key = 1;
+}
+/*---------------------------------------------------------------------------*/
 const struct aes_128_driver aes_128_driver = {
   set_key,
-  encrypt
+  encrypt,
+  NULL,
+  save_key,
+  load_key
 };
 /*---------------------------------------------------------------------------*/
+void
+aes_128_encrypt_pair(uint8_t *plaintext_and_result1,
+                     uint8_t *plaintext_and_result2)
+{
+  if(AES_128.encrypt_pair) {
+    AES_128.encrypt_pair(plaintext_and_result1, plaintext_and_result2);
+  } else {
+    AES_128.encrypt(plaintext_and_result1);
+    AES_128.encrypt(plaintext_and_result2);
+  }
+}
+/*---------------------------------------------------------------------------*/
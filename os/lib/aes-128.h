@@ -44,6 +44,8 @@
 
 #define AES_128_BLOCK_SIZE 16
 #define AES_128_KEY_LENGTH 16
+/** Size of an expanded key, as stored by aes_128_driver.save_key() */
+#define AES_128_SCHEDULE_SIZE (11 * AES_128_BLOCK_SIZE)
 
 #ifdef AES_128_CONF
 #define AES_128            AES_128_CONF
@@ -65,8 +67,41 @@ struct aes_128_driver {
    * \brief Encrypts.
    */
   void (* encrypt)(uint8_t *plaintext_and_result);
+
+  /**
+   * \brief Encrypts two independent blocks. Optional: drivers that can
+   *        overlap the two encryptions set it, others leave it NULL.
+   */
+  void (* encrypt_pair)(uint8_t *plaintext_and_result1,
+                        uint8_t *plaintext_and_result2);
+
+  /**
+   * \brief Copies the expanded current key to schedule, which is
+   *        AES_128_SCHEDULE_SIZE bytes long. Optional: drivers that
+   *        expand keys in software set it, others leave it NULL.
+   */
+  void (* save_key)(uint8_t *schedule);
+
+  /**
+   * \brief Makes a schedule saved by save_key the current key, without
+   *        expanding it again. Set if and only if save_key is.
+   */
+  void (* load_key)(const uint8_t *schedule);
 };
 
+/**
+ * \brief Encrypts two independent blocks with AES_128, at once if the
+ *        driver supports it.
+ */
+void aes_128_encrypt_pair(uint8_t *plaintext_and_result1,
+                          uint8_t *plaintext_and_result2);
+
 extern const struct aes_128_driver AES_128;
 
+/** Byte-oriented software AES-128, the smallest one */
+extern const struct aes_128_driver aes_128_driver;
+
+/** Software AES-128 using a 1 KiB table, several times faster */
+extern const struct aes_128_driver aes_128_ttable_driver;
+
 #endif /* AES_128_H_ */
@@ -64,85 +64,37 @@ set_iv(uint8_t *iv,
   iv[15] = counter;
 }
 /*---------------------------------------------------------------------------*/
-/* XORs the block m[pos] ... m[pos + 15] with K_{counter} */
 static void
-ctr_step(const uint8_t *nonce,
-    uint16_t pos,
-    uint8_t *m_and_result,
-    uint16_t m_len,
-    uint16_t counter)
+xor_block(uint8_t *x, const uint8_t *y, uint8_t len)
 {
-  uint8_t a[AES_128_BLOCK_SIZE];
   uint8_t i;
 
-  set_iv(a, CCM_STAR_ENCRYPTION_FLAGS, nonce, counter);
-  AES_128.encrypt(a);
-
-  for(i = 0; (pos + i < m_len) && (i < AES_128_BLOCK_SIZE); i++) {
-    m_and_result[pos + i] ^= a[i];
+  for(i = 0; i < len; i++) {
+    x[i] ^= y[i];
   }
 }
 /*---------------------------------------------------------------------------*/
+/* Runs CBC-MAC over the additional authenticated data; x holds the
+   encrypted B_0 block on entry */
 static void
-mic(const uint8_t *nonce,
-    const uint8_t *m, uint16_t m_len,
-    const uint8_t *a, uint16_t a_len,
-    uint8_t *result,
-    uint8_t mic_len)
+mac_a(uint8_t *x, const uint8_t *a, uint16_t a_len)
 {
-  uint8_t x[AES_128_BLOCK_SIZE];
-  uint32_t pos; /* 32-bits as can need to exceed m_len to reach end of loop */
+  uint32_t pos; /* 32-bits as can need to exceed a_len to reach end of loop */
   uint8_t i;
 
-  set_iv(x, CCM_STAR_AUTH_FLAGS(a_len > 0, mic_len), nonce, m_len);
-  AES_128.encrypt(x);
-
-  if(a_len) {
-    x[0] = x[0] ^ (a_len >> 8);
-    x[1] = x[1] ^ a_len;
-    for(i = 2; (i - 2 < a_len) && (i < AES_128_BLOCK_SIZE); i++) {
-      x[i] ^= a[i - 2];
-    }
-
-    AES_128.encrypt(x);
-
-    pos = 14;
-    while(pos < a_len) {
-      for(i = 0; (pos + i < a_len) && (i < AES_128_BLOCK_SIZE); i++) {
-        x[i] ^= a[pos + i];
-      }
-      pos += AES_128_BLOCK_SIZE;
-      AES_128.encrypt(x);
-    }
-  }
-
-  if(m_len) {
-    pos = 0;
-    while(pos < m_len) {
-      for(i = 0; (pos + i < m_len) && (i < AES_128_BLOCK_SIZE); i++) {
-        x[i] ^= m[pos + i];
-      }
-      pos += AES_128_BLOCK_SIZE;
-      AES_128.encrypt(x);
-    }
+  x[0] = x[0] ^ (a_len >> 8);
+  x[1] = x[1] ^ a_len;
+  for(i = 2; (i - 2 < a_len) && (i < AES_128_BLOCK_SIZE); i++) {
+    x[i] ^= a[i - 2];
   }
 
-  ctr_step(nonce, 0, x, AES_128_BLOCK_SIZE, 0);
-
-  memcpy(result, x, mic_len);
-}
-/*---------------------------------------------------------------------------*/
-static void
-ctr(const uint8_t *nonce, uint8_t *m, uint16_t m_len)
-{
-  uint32_t pos; /* 32-bits as can need to exceed m_len to reach end of loop */
-  uint16_t counter;
+  AES_128.encrypt(x);
 
-  pos = 0;
-  counter = 1;
-  while(pos < m_len) {
-    ctr_step(nonce, pos, m, m_len, counter++);
+  pos = 14;
+  while(pos < a_len) {
+    xor_block(x, a + pos, MIN(a_len - pos, AES_128_BLOCK_SIZE));
     pos += AES_128_BLOCK_SIZE;
+    AES_128.encrypt(x);
   }
 }
 /*---------------------------------------------------------------------------*/
@@ -152,6 +104,11 @@ set_key(const uint8_t *key)
   AES_128.set_key(key);
 }
 /*---------------------------------------------------------------------------*/
+/*
+ * CBC-MAC and CTR go through m in a single pass. Each CBC-MAC block is
+ * encrypted together with an independent key stream block, which lets
+ * drivers with aes_128_driver.encrypt_pair overlap the two.
+ */
 static void
 aead(const uint8_t* nonce,
     uint8_t* m, uint16_t m_len,
@@ -159,29 +116,93 @@ aead(const uint8_t* nonce,
     uint8_t *result, uint8_t mic_len,
     int forward)
 {
+  uint8_t x[AES_128_BLOCK_SIZE];
+  uint8_t s[AES_128_BLOCK_SIZE];
+  uint8_t s0[AES_128_BLOCK_SIZE];
+  uint32_t pos; /* 32-bits as can need to exceed m_len to reach end of loop */
+  uint16_t counter;
+  uint8_t len;
+
   if(a_len > MAX_A_LEN || !MIC_LEN_VALID(mic_len)) {
     return;
   }
 
-  if(!forward) {
-    /* decrypt */
-    ctr(nonce, m, m_len);
+  /* B_0 and the key stream block S_0 that encrypts the MIC */
+  set_iv(x, CCM_STAR_AUTH_FLAGS(a_len > 0, mic_len), nonce, m_len);
+  set_iv(s0, CCM_STAR_ENCRYPTION_FLAGS, nonce, 0);
+  aes_128_encrypt_pair(x, s0);
+
+  if(a_len) {
+    mac_a(x, a, a_len);
   }
 
-  mic(nonce,
-    m, m_len,
-    a, a_len,
-    result,
-    mic_len);
+  counter = 1;
+  if(!forward && m_len) {
+    /* The MAC of a block needs its plaintext, so the key stream runs one
+       block ahead */
+    set_iv(s, CCM_STAR_ENCRYPTION_FLAGS, nonce, counter++);
+    AES_128.encrypt(s);
+  }
+  for(pos = 0; pos < m_len; pos += AES_128_BLOCK_SIZE) {
+    len = MIN(m_len - pos, AES_128_BLOCK_SIZE);
+    if(forward) {
+      xor_block(x, m + pos, len);
+      set_iv(s, CCM_STAR_ENCRYPTION_FLAGS, nonce, counter++);
+      aes_128_encrypt_pair(x, s);
+      xor_block(m + pos, s, len);
+    } else {
+      xor_block(m + pos, s, len);
+      xor_block(x, m + pos, len);
+      if(pos + AES_128_BLOCK_SIZE < m_len) {
+        set_iv(s, CCM_STAR_ENCRYPTION_FLAGS, nonce, counter++);
+        aes_128_encrypt_pair(x, s);
+      } else {
+        AES_128.encrypt(x);
+      }
+    }
+  }
 
-  if(forward) {
-    /* encrypt */
-    ctr(nonce, m, m_len);
+  xor_block(x, s0, mic_len);
+  memcpy(result, x, mic_len);
+}
+/*---------------------------------------------------------------------------*/
+static int
+save_key(uint8_t *schedule)
+{
+  if(!AES_128.save_key) {
+    return 0;
   }
+  AES_128.save_key(schedule);
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+load_key(const uint8_t *schedule)
+{
+  AES_128.load_key(schedule);
 }
 /*---------------------------------------------------------------------------*/
 const struct ccm_star_driver ccm_star_driver = {
   set_key,
-  aead
+  aead,
+  save_key,
+  load_key
 };
 /*---------------------------------------------------------------------------*/
+void
+ccm_star_aead_batch(const uint8_t *key,
+    const struct ccm_star_frame *frames, uint16_t count,
+    int forward)
+{
+  uint16_t i;
+
+  CCM_STAR.set_key(key);
+  for(i = 0; i < count; i++) {
+    CCM_STAR.aead(frames[i].nonce,
+        frames[i].m, frames[i].m_len,
+        frames[i].a, frames[i].a_len,
+        frames[i].result, frames[i].mic_len,
+        forward);
+  }
+}
+/*---------------------------------------------------------------------------*/
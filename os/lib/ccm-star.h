@@ -75,8 +75,49 @@ struct ccm_star_driver {
       const uint8_t* a, uint16_t a_len,
       uint8_t *result, uint8_t mic_len,
       int forward);
+
+  /**
+   * \brief          Copies the expanded key in use to schedule, which is
+   *                 AES_128_SCHEDULE_SIZE bytes long. Optional, may be NULL.
+   *                 Default implementation calls AES_128.save_key().
+   * \param schedule Where to store the expanded key.
+   * \return         Non-zero on success, zero if keys cannot be saved.
+   */
+  int (* save_key)(uint8_t *schedule);
+
+  /**
+   * \brief          Makes a schedule stored by save_key() the key in use.
+   * \param schedule The expanded key.
+   */
+  void (* load_key)(const uint8_t *schedule);
 };
 
 extern const struct ccm_star_driver CCM_STAR;
 
+/**
+ * A frame to process with ccm_star_aead_batch(). The fields are the
+ * parameters of ccm_star_driver.aead().
+ */
+struct ccm_star_frame {
+  const uint8_t *nonce;
+  uint8_t *m;
+  uint16_t m_len;
+  const uint8_t *a;
+  uint16_t a_len;
+  uint8_t *result;
+  uint8_t mic_len;
+};
+
+/**
+ * \brief         Processes several frames secured with the same key
+ *                back-to-back, setting the key only once.
+ * \param key     The key of all frames.
+ * \param frames  The frames.
+ * \param count   The number of frames.
+ * \param forward != 0 if used in forward direction.
+ */
+void ccm_star_aead_batch(const uint8_t *key,
+    const struct ccm_star_frame *frames, uint16_t count,
+    int forward);
+
 #endif /* CCM_STAR_H_ */
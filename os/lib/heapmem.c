@@ -105,6 +105,25 @@
 #define ALIGN(size)						\
   (((size) + (HEAPMEM_ALIGNMENT - 1)) & ~(HEAPMEM_ALIGNMENT - 1))
 
+/*
+ * The HEAPMEM_CONF_SIZE_CLASS_MAX parameter enables segregated free
+ * lists for small chunks. Free chunks of up to this size are kept on
+ * one list per multiple of HEAPMEM_ALIGNMENT, so that allocating and
+ * deallocating such chunks takes constant time instead of a search
+ * through the general free list. Larger chunks are handled as before.
+ * A value of zero disables the size classes.
+ */
+#ifdef HEAPMEM_CONF_SIZE_CLASS_MAX
+#define HEAPMEM_SIZE_CLASS_MAX HEAPMEM_CONF_SIZE_CLASS_MAX
+#else
+#define HEAPMEM_SIZE_CLASS_MAX 0
+#endif /* HEAPMEM_CONF_SIZE_CLASS_MAX */
+
+#define SIZE_CLASSES (ALIGN(HEAPMEM_SIZE_CLASS_MAX) / HEAPMEM_ALIGNMENT)
+#define SIZE_CLASS(size) ((size) / HEAPMEM_ALIGNMENT - 1)
+#define IN_SIZE_CLASS(size)						\
+  ((size) > 0 && (size) <= SIZE_CLASSES * HEAPMEM_ALIGNMENT)
+
 /* Macros for chunk iteration. */
 #define NEXT_CHUNK(chunk)						\
   ((chunk_t *)((char *)(chunk) + sizeof(chunk_t) + (chunk)->size))
@@ -120,11 +139,15 @@
 
 /* Macros for determining the status of a chunk. */
 #define CHUNK_FLAG_ALLOCATED		0x1
+#define CHUNK_FLAG_CLASSED		0x2
 
 #define CHUNK_ALLOCATED(chunk)			\
   ((chunk)->flags & CHUNK_FLAG_ALLOCATED)
 #define CHUNK_FREE(chunk)			\
   (~(chunk)->flags & CHUNK_FLAG_ALLOCATED)
+/* A free chunk that is kept on a size class list. */
+#define CHUNK_CLASSED(chunk)			\
+  ((chunk)->flags & CHUNK_FLAG_CLASSED)
 
 /*
  * We use a double-linked list of chunks, with a slight space overhead compared
@@ -149,6 +172,12 @@ static size_t heap_usage;
 
 static chunk_t *first_chunk = (chunk_t *)heap_base;
 static chunk_t *free_list;
+#if HEAPMEM_SIZE_CLASS_MAX > 0
+static chunk_t *class_lists[SIZE_CLASSES];
+/* The amount of memory that has been put in size classes since the
+   last time that reclaim_chunks() was called. */
+static size_t reclaimable;
+#endif
 
 #define IN_HEAP(ptr) ((char *)(ptr) >= (char *)heap_base) && \
                      ((char *)(ptr) < (char *)heap_base + heap_usage)
@@ -168,6 +197,29 @@ extend_space(size_t size)
   return old_usage;
 }
 
+/* add_chunk_to_free_list: Put a free chunk on the list of its size
+   class, or on the general free list if it has no size class. */
+static void
+add_chunk_to_free_list(chunk_t * const chunk)
+{
+  chunk_t **list = &free_list;
+
+#if HEAPMEM_SIZE_CLASS_MAX > 0
+  if(IN_SIZE_CLASS(chunk->size)) {
+    chunk->flags |= CHUNK_FLAG_CLASSED;
+    list = &class_lists[SIZE_CLASS(chunk->size)];
+    reclaimable += chunk->size;
+  }
+#endif
+
+  chunk->prev = NULL;
+  chunk->next = *list;
+  if(*list != NULL) {
+    (*list)->prev = chunk;
+  }
+  *list = chunk;
+}
+
 /* free_chunk: Mark a chunk as being free, and put it on the free list. */
 static void
 free_chunk(chunk_t * const chunk)
@@ -178,25 +230,28 @@ free_chunk(chunk_t * const chunk)
     /* Release the chunk back into the wilderness. */
     heap_usage -= sizeof(chunk_t) + chunk->size;
   } else {
-    /* Put the chunk on the free list. */
-    chunk->prev = NULL;
-    chunk->next = free_list;
-    if(free_list != NULL) {
-      free_list->prev = chunk;
-    }
-    free_list = chunk;
+    add_chunk_to_free_list(chunk);
   }
 }
 
 /* remove_chunk_from_free_list: Mark a chunk as being allocated, and remove it
-   from the free list. */
+   from the free list that it is kept on. */
 static void
 remove_chunk_from_free_list(chunk_t * const chunk)
 {
-  if(chunk == free_list) {
-    free_list = chunk->next;
-    if(free_list != NULL) {
-      free_list->prev = NULL;
+  chunk_t **list = &free_list;
+
+#if HEAPMEM_SIZE_CLASS_MAX > 0
+  if(CHUNK_CLASSED(chunk)) {
+    chunk->flags &= ~CHUNK_FLAG_CLASSED;
+    list = &class_lists[SIZE_CLASS(chunk->size)];
+  }
+#endif
+
+  if(chunk == *list) {
+    *list = chunk->next;
+    if(*list != NULL) {
+      (*list)->prev = NULL;
     }
   } else {
     chunk->prev->next = chunk->next;
@@ -207,6 +262,20 @@ remove_chunk_from_free_list(chunk_t * const chunk)
   }
 }
 
+/* release_free_chunk: Release a free chunk back into the wilderness if
+   it is the last one in the heap. */
+static bool
+release_free_chunk(chunk_t * const chunk)
+{
+  if(!IS_LAST_CHUNK(chunk)) {
+    return false;
+  }
+
+  remove_chunk_from_free_list(chunk);
+  heap_usage -= sizeof(chunk_t) + chunk->size;
+  return true;
+}
+
 /*
  * split_chunk: When allocating a chunk, we may have found one that is
  * larger than needed, so this function is called to keep the rest of
@@ -233,13 +302,33 @@ split_chunk(chunk_t * const chunk, size_t offset)
 static void
 coalesce_chunks(chunk_t *chunk)
 {
-  for(chunk_t *next = NEXT_CHUNK(chunk);
+  chunk_t *next = NEXT_CHUNK(chunk);
+  if((char *)next >= &heap_base[heap_usage] || !CHUNK_FREE(next)) {
+    return;
+  }
+
+#if HEAPMEM_SIZE_CLASS_MAX > 0
+  /* A chunk on a size class list will change its class when growing,
+     so it is moved to the list of its new size afterwards. */
+  const bool refile = CHUNK_CLASSED(chunk);
+  if(refile) {
+    remove_chunk_from_free_list(chunk);
+  }
+#endif
+
+  for(;
       (char *)next < &heap_base[heap_usage] && CHUNK_FREE(next);
       next = NEXT_CHUNK(next)) {
     chunk->size += sizeof(chunk_t) + next->size;
     LOG_DBG("Coalesce chunk of %zu bytes\n", next->size);
     remove_chunk_from_free_list(next);
   }
+
+#if HEAPMEM_SIZE_CLASS_MAX > 0
+  if(refile) {
+    add_chunk_to_free_list(chunk);
+  }
+#endif
 }
 
 /* defrag_chunks: Scan the free list for chunks that can be coalesced,
@@ -297,6 +386,96 @@ get_free_chunk(const size_t size)
   return best;
 }
 
+#if HEAPMEM_SIZE_CLASS_MAX > 0
+/* get_class_chunk: Take a free chunk from the list of the smallest
+   size class that can satisfy an allocation request, starting with
+   the exact size class. */
+static chunk_t *
+get_class_chunk(const size_t size, const bool exact)
+{
+  if(!IN_SIZE_CLASS(size)) {
+    return NULL;
+  }
+
+  for(size_t i = SIZE_CLASS(size); i < SIZE_CLASSES; i++) {
+    chunk_t *chunk = class_lists[i];
+    if(chunk != NULL) {
+      remove_chunk_from_free_list(chunk);
+      split_chunk(chunk, size);
+      return chunk;
+    }
+    if(exact) {
+      break;
+    }
+  }
+
+  return NULL;
+}
+
+#endif /* HEAPMEM_SIZE_CLASS_MAX > 0 */
+
+/*
+ * reclaim_chunks: Coalesce all adjacent free chunks in the heap,
+ * including those kept on the size class lists, and release the last
+ * chunk back into the wilderness if it is free. This takes time in
+ * proportion to the number of chunks, so it is only done when an
+ * allocation would otherwise fail, or when requested through
+ * heapmem_trim().
+ */
+static void
+reclaim_chunks(void)
+{
+  for(chunk_t *chunk = first_chunk;
+      (char *)chunk < &heap_base[heap_usage];
+      chunk = NEXT_CHUNK(chunk)) {
+    if(CHUNK_FREE(chunk)) {
+      coalesce_chunks(chunk);
+      if(release_free_chunk(chunk)) {
+        break;
+      }
+    }
+  }
+
+#if HEAPMEM_SIZE_CLASS_MAX > 0
+  reclaimable = 0;
+#endif
+}
+
+/* get_chunk: Obtain a chunk for an allocation request of an aligned
+   size, or NULL if no suitable space is available. */
+static chunk_t *
+get_chunk(const size_t size)
+{
+  chunk_t *chunk;
+
+#if HEAPMEM_SIZE_CLASS_MAX > 0
+  /* Small chunks of the same size are typically allocated and
+     deallocated repeatedly, so the size class is checked first. */
+  chunk = get_class_chunk(size, true);
+  if(chunk != NULL) {
+    return chunk;
+  }
+#endif
+
+  chunk = get_free_chunk(size);
+  if(chunk != NULL) {
+    return chunk;
+  }
+
+  chunk = extend_space(sizeof(chunk_t) + size);
+  if(chunk != NULL) {
+    chunk->size = size;
+    return chunk;
+  }
+
+#if HEAPMEM_SIZE_CLASS_MAX > 0
+  /* Use a chunk of a larger size class before giving up. */
+  return get_class_chunk(size, false);
+#else
+  return NULL;
+#endif
+}
+
 /*
  * heapmem_alloc: Allocate an object of the specified size, returning
  * a pointer to it in case of success, and NULL in case of failure.
@@ -310,6 +489,10 @@ get_free_chunk(const size_t size)
  *
  * As a last resort, heapmem_alloc() will try to extend the heap
  * space, and thereby create a new chunk available for use.
+ *
+ * If size classes are enabled, requests of up to HEAPMEM_SIZE_CLASS_MAX
+ * bytes are first served from the free list of their size class, which
+ * takes constant time.
  */
 void *
 #if HEAPMEM_DEBUG
@@ -325,13 +508,20 @@ heapmem_alloc(size_t size)
 
   size = ALIGN(size);
 
-  chunk_t *chunk = get_free_chunk(size);
+  chunk_t *chunk = get_chunk(size);
+#if HEAPMEM_SIZE_CLASS_MAX > 0
+  if(chunk == NULL &&
+     reclaimable >= size && reclaimable >= heap_usage / 64) {
+    /* The free space may be scattered over many small chunks, so we
+       merge what we can and try once more. The scan of the heap is only
+       done when enough memory has been deallocated since the last scan,
+       which bounds its amortized cost when the heap is nearly full. */
+    reclaim_chunks();
+    chunk = get_chunk(size);
+  }
+#endif
   if(chunk == NULL) {
-    chunk = extend_space(sizeof(chunk_t) + size);
-    if(chunk == NULL) {
-      return NULL;
-    }
-    chunk->size = size;
+    return NULL;
   }
 
   chunk->flags = CHUNK_FLAG_ALLOCATED;
@@ -500,10 +690,25 @@ heapmem_realloc(void *ptr, size_t size)
 }
 #endif /* HEAPMEM_REALLOC */
 
-/* heapmem_stats: Calculate statistics regarding memory usage. */
+/*
+ * heapmem_trim: Coalesce the free chunks of the heap, and release the
+ * free memory at the end of the heap back into the wilderness.
+ */
+void
+heapmem_trim(void)
+{
+  reclaim_chunks();
+}
+
+/* heapmem_stats: Calculate statistics regarding memory usage. The heap
+   is not modified, so adjacent free chunks are counted as the single
+   chunk that they will be coalesced into. */
 void
 heapmem_stats(heapmem_stats_t *stats)
 {
+  bool in_free_run = false;
+  size_t free_run = 0;
+
   memset(stats, 0, sizeof(*stats));
 
   for(chunk_t *chunk = first_chunk;
@@ -512,12 +717,31 @@ heapmem_stats(heapmem_stats_t *stats)
     if(CHUNK_ALLOCATED(chunk)) {
       stats->allocated += chunk->size;
       stats->overhead += sizeof(chunk_t);
+      in_free_run = false;
     } else {
-      coalesce_chunks(chunk);
+      if(in_free_run) {
+        /* The header is reclaimed when coalescing with the previous chunk. */
+        stats->available += sizeof(chunk_t);
+        free_run += sizeof(chunk_t) + chunk->size;
+      } else {
+        in_free_run = true;
+        free_run = chunk->size;
+        stats->free_chunks++;
+        if(CHUNK_CLASSED(chunk)) {
+          stats->classed_chunks++;
+        }
+      }
       stats->available += chunk->size;
+      if(free_run > stats->largest_free) {
+        stats->largest_free = free_run;
+      }
     }
   }
   stats->available += HEAPMEM_ARENA_SIZE - heap_usage;
+  if(HEAPMEM_ARENA_SIZE - heap_usage > sizeof(chunk_t) &&
+     HEAPMEM_ARENA_SIZE - heap_usage - sizeof(chunk_t) > stats->largest_free) {
+    stats->largest_free = HEAPMEM_ARENA_SIZE - heap_usage - sizeof(chunk_t);
+  }
   stats->footprint = heap_usage;
   stats->chunks = stats->overhead / sizeof(chunk_t);
 }
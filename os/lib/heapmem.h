@@ -47,6 +47,11 @@
  * adds some memory overhead compared to a single-linked list, it
  * improves the performance of list management.
  *
+ * Optionally, free chunks of up to HEAPMEM_CONF_SIZE_CLASS_MAX bytes
+ * are instead kept on segregated lists, one per size class, which
+ * makes the allocation and deallocation of small objects take
+ * constant time.
+ *
  * Internally, allocated chunks can be retrieved using the pointer to
  * the allocated memory returned by heapmem_alloc() and
  * heapmem_realloc(), because the chunk structure immediately precedes
@@ -82,6 +87,12 @@ typedef struct heapmem_stats {
   size_t available;
   size_t footprint;
   size_t chunks;
+  /* The size of the largest allocation that can currently succeed. */
+  size_t largest_free;
+  /* The number of free chunks, counting adjacent ones as one. */
+  size_t free_chunks;
+  /* The number of free chunks that are kept in size classes. */
+  size_t classed_chunks;
 } heapmem_stats_t;
 
 #if HEAPMEM_DEBUG
@@ -158,10 +169,27 @@ bool heapmem_free(void *ptr);
  * and the number of chunks allocated. By using this information, developers
  * can tune their software to use the heapmem allocator more efficiently.
  *
+ * The fragmentation of the free memory can be estimated by comparing
+ * the largest free chunk with the total amount of available memory.
+ * Obtaining the statistics does not modify the heap.
+ *
  */
 
 void heapmem_stats(heapmem_stats_t *stats);
 
+/**
+ * \brief       Coalesce free chunks and shrink the heap footprint.
+ *
+ * This function merges all adjacent free chunks in the heap, and
+ * releases the free memory at the end of the heap into the unused
+ * part of the arena. It takes time in proportion to the number of
+ * chunks in the heap.
+ *
+ * \sa          heapmem_stats
+ */
+
+void heapmem_trim(void);
+
 /**
  * \brief       Obtain the minimum alignment of allocated addresses.
  * \return      The alignment value, which is a power of two.
@@ -47,54 +47,86 @@
 #include "contiki.h"
 #include "lib/memb.h"
 
+/*---------------------------------------------------------------------------*/
+#define IS_USED(m, i)   ((m)->used[(i) >> 3] & (1 << ((i) & 7)))
+#define SET_USED(m, i)  ((m)->used[(i) >> 3] |= 1 << ((i) & 7))
+#define CLEAR_USED(m, i) ((m)->used[(i) >> 3] &= ~(1 << ((i) & 7)))
 /*---------------------------------------------------------------------------*/
 void
 memb_init(struct memb *m)
 {
-  memset(m->used, 0, m->num);
+  memset(m->used, 0, MEMB_USED_SIZE(m->num));
   memset(m->mem, 0, m->size * m->num);
+#if MEMB_FREE_STACK
+  m->free_top = 0;
+  m->next_fresh = 0;
+#endif
 }
 /*---------------------------------------------------------------------------*/
 void *
 memb_alloc(struct memb *m)
 {
-  int i;
+  unsigned i;
 
-  for(i = 0; i < m->num; ++i) {
-    if(m->used[i] == false) {
-      /* If this block was unused, we set the used flag on
-	 and return a pointer to the memory block. */
-      m->used[i] = true;
-      return (void *)((char *)m->mem + (i * m->size));
+#if MEMB_FREE_STACK
+  if(m->free_top > 0) {
+    i = m->free_stack[--m->free_top];
+  } else if(m->next_fresh < m->num) {
+    i = m->next_fresh++;
+  } else {
+    return NULL;
+  }
+#else
+  for(i = 0; i < MEMB_USED_SIZE(m->num); ++i) {
+    if(m->used[i] != 0xff) {
+      break;
     }
   }
 
-  /* No free block was found, so we return NULL to indicate failure to
-     allocate block. */
-  return NULL;
+  /* Find the first free block within the byte of the bitmap. */
+  i *= 8;
+  while(i < m->num && IS_USED(m, i)) {
+    ++i;
+  }
+  if(i >= m->num) {
+    /* No free block was found, so we return NULL to indicate failure to
+       allocate block. */
+    return NULL;
+  }
+#endif /* MEMB_FREE_STACK */
+
+  SET_USED(m, i);
+  return (void *)((char *)m->mem + (i * m->size));
 }
 /*---------------------------------------------------------------------------*/
 int
 memb_free(struct memb *m, void *ptr)
 {
-  int i;
-  char *ptr2;
+  unsigned i;
+  unsigned long offset;
 
-  /* Walk through the list of blocks and try to find the block to
-     which the pointer "ptr" points to. */
-  ptr2 = (char *)m->mem;
-  for(i = 0; i < m->num; ++i) {
-    if(ptr2 == (char *)ptr) {
-      /* We've found the block to which "ptr" points, so we check the allocation
-         status to detect the double-free error and free the block. */
-      if (m->used[i] == false)
-        return -1;
-      m->used[i] = false;
-      return 0;
-    }
-    ptr2 += m->size;
+  if(!memb_inmemb(m, ptr)) {
+    return -1;
+  }
+
+  /* Compute the index of the block, and reject addresses that do not
+     point to the beginning of a block. */
+  offset = (unsigned long)((char *)ptr - (char *)m->mem);
+  if(offset % m->size != 0) {
+    return -1;
   }
-  return -1;
+  i = offset / m->size;
+
+  /* Check the allocation status to detect the double-free error. */
+  if(!IS_USED(m, i)) {
+    return -1;
+  }
+  CLEAR_USED(m, i);
+
+#if MEMB_FREE_STACK
+  m->free_stack[m->free_top++] = i;
+#endif
+  return 0;
 }
 /*---------------------------------------------------------------------------*/
 int
@@ -107,15 +139,21 @@ memb_inmemb(struct memb *m, void *ptr)
 int
 memb_numfree(struct memb *m)
 {
+#if MEMB_FREE_STACK
+  return m->free_top + (m->num - m->next_fresh);
+#else
   int i;
-  int num_free = 0;
+  int num_used = 0;
 
-  for(i = 0; i < m->num; ++i) {
-    if(m->used[i] == false) {
-      ++num_free;
+  for(i = 0; i < MEMB_USED_SIZE(m->num); ++i) {
+    /* Count the set bits of the byte, one per iteration. */
+    for(uint8_t bits = m->used[i]; bits != 0; bits &= bits - 1) {
+      ++num_used;
     }
   }
 
-  return num_free;
+  return m->num - num_used;
+#endif /* MEMB_FREE_STACK */
 }
+/*---------------------------------------------------------------------------*/
 /** @} */
@@ -48,6 +48,13 @@
  * memory by the memb_alloc() function, and are deallocated with the
  * memb_free() function.
  *
+ * The allocation status of the blocks is kept in a bitmap. Since
+ * memb_free() computes the index of a block from its address, it takes
+ * constant time. memb_alloc() searches the bitmap for a free block,
+ * unless MEMB_CONF_FREE_STACK is enabled, in which case the indices of
+ * free blocks are kept on a stack so that allocation also takes
+ * constant time, at the cost of two bytes of RAM per block.
+ *
  * @{
  */
 
@@ -64,8 +71,27 @@
 #define MEMB_H_
 
 #include <stdbool.h>
+#include <stdint.h>
 #include "sys/cc.h"
 
+#ifdef MEMB_CONF_FREE_STACK
+#define MEMB_FREE_STACK MEMB_CONF_FREE_STACK
+#else
+#define MEMB_FREE_STACK 0
+#endif /* MEMB_CONF_FREE_STACK */
+
+/* The number of bytes in the allocation bitmap of num blocks. */
+#define MEMB_USED_SIZE(num) (((num) + 7) / 8)
+
+#if MEMB_FREE_STACK
+#define MEMB_FREE_STACK_DECLARE(name, num) \
+        static unsigned short CC_CONCAT(name,_memb_free)[num];
+#define MEMB_FREE_STACK_INIT(name) , CC_CONCAT(name,_memb_free), 0, 0
+#else
+#define MEMB_FREE_STACK_DECLARE(name, num)
+#define MEMB_FREE_STACK_INIT(name)
+#endif /* MEMB_FREE_STACK */
+
 /**
  * Declare a memory block.
  *
@@ -88,17 +114,27 @@ MEMB(connections, struct connection, 16);
  *
  */
 #define MEMB(name, structure, num) \
-        static bool CC_CONCAT(name,_memb_used)[num]; \
+        static uint8_t CC_CONCAT(name,_memb_used)[MEMB_USED_SIZE(num)]; \
         static structure CC_CONCAT(name,_memb_mem)[num]; \
+        MEMB_FREE_STACK_DECLARE(name, num) \
         static struct memb name = {sizeof(structure), num, \
                                           CC_CONCAT(name,_memb_used), \
-                                          (void *)CC_CONCAT(name,_memb_mem)}
+                                          (void *)CC_CONCAT(name,_memb_mem) \
+                                          MEMB_FREE_STACK_INIT(name)}
 
 struct memb {
   unsigned short size;
   unsigned short num;
-  bool *used;
+  uint8_t *used;
   void *mem;
+#if MEMB_FREE_STACK
+  /* Indices of deallocated blocks. */
+  unsigned short *free_stack;
+  unsigned short free_top;
+  /* Blocks from this index onwards have never been allocated, which
+     lets an uninitialized set of blocks be used with an empty stack. */
+  unsigned short next_fresh;
+#endif
 };
 
 /**
@@ -124,7 +160,8 @@ void *memb_alloc(struct memb *m);
  * \param ptr A pointer to the memory block that is to be deallocated.
  *
  * \return error code, should be 0 if successfully deallocated or -1 if the
- * pointer "ptr" did not point to a legal memory block.
+ * pointer "ptr" did not point to a legal memory block, or if the block
+ * was not allocated.
  */
 int  memb_free(struct memb *m, void *ptr);
 
@@ -112,5 +112,23 @@
 #define COAP_OBSERVER_URL_LEN 20
 #endif
 
+/*
+ * Number of path-segment trie nodes used to dispatch requests to resources.
+ * Each distinct path prefix of the active resources takes one node. With 0,
+ * requests are dispatched by comparing the URI path against every resource.
+ */
+#ifdef COAP_CONF_RESOURCE_TRIE_NODES
+#define COAP_RESOURCE_TRIE_NODES COAP_CONF_RESOURCE_TRIE_NODES
+#else
+#define COAP_RESOURCE_TRIE_NODES 0
+#endif
+
+/* Number of hash buckets indexing the trie nodes. */
+#ifdef COAP_CONF_RESOURCE_TRIE_HASH_SIZE
+#define COAP_RESOURCE_TRIE_HASH_SIZE COAP_CONF_RESOURCE_TRIE_HASH_SIZE
+#else
+#define COAP_RESOURCE_TRIE_HASH_SIZE COAP_RESOURCE_TRIE_NODES
+#endif
+
 #endif /* COAP_CONF_H_ */
 /** @} */
@@ -44,6 +44,7 @@
 #include "coap-engine.h"
 #include "sys/cc.h"
 #include "lib/list.h"
+#include "lib/memb.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <inttypes.h>
@@ -72,6 +73,176 @@ LIST(coap_handlers);
 LIST(coap_resource_services);
 static uint8_t is_initialized = 0;
 
+#if COAP_RESOURCE_TRIE_NODES
+/*
+ * Path-segment trie over the URLs of the active resources. A node stands for
+ * a path prefix and is found in a hash table from its parent node and its
+ * last path segment. Each node keeps the first activated resource with that
+ * exact URL and the first one with that URL and sub-resources, along with
+ * their activation order, so that lookups pick the same resource as a walk
+ * over the resource list.
+ */
+typedef struct trie_node {
+  struct trie_node *hash_next;
+  const struct trie_node *parent;
+  const char *segment;
+  uint16_t segment_len;
+  uint16_t exact_order;
+  uint16_t sub_order;
+  coap_resource_t *exact;
+  coap_resource_t *sub;
+} trie_node_t;
+
+MEMB(trie_memb, trie_node_t, COAP_RESOURCE_TRIE_NODES);
+static trie_node_t *trie_hash[COAP_RESOURCE_TRIE_HASH_SIZE];
+/* The empty path */
+static trie_node_t trie_root;
+static uint16_t trie_order;
+/* Cleared when the trie ran out of nodes: requests then walk the list */
+static uint8_t trie_complete = 1;
+#endif /* COAP_RESOURCE_TRIE_NODES */
+
+#if COAP_RESOURCE_TRIE_NODES
+/*---------------------------------------------------------------------------*/
+/*- Resource trie -----------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+static trie_node_t **
+trie_bucket(const trie_node_t *parent, const char *segment, uint16_t len)
+{
+  uint32_t hash = 2166136261UL;
+  uint16_t i;
+
+  for(i = 0; i < len; i++) {
+    hash ^= (uint8_t)segment[i];
+    hash *= 16777619UL;
+  }
+  hash ^= (uint32_t)(uintptr_t)parent;
+  hash *= 16777619UL;
+  return &trie_hash[hash % COAP_RESOURCE_TRIE_HASH_SIZE];
+}
+/*---------------------------------------------------------------------------*/
+static trie_node_t *
+trie_child(const trie_node_t *parent, const char *segment, uint16_t len)
+{
+  trie_node_t *node;
+
+  for(node = *trie_bucket(parent, segment, len); node != NULL;
+      node = node->hash_next) {
+    if(node->parent == parent && node->segment_len == len
+       && memcmp(node->segment, segment, len) == 0) {
+      return node;
+    }
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+static void
+trie_reset(void)
+{
+  memb_init(&trie_memb);
+  memset(trie_hash, 0, sizeof(trie_hash));
+  memset(&trie_root, 0, sizeof(trie_root));
+  trie_order = 0;
+  trie_complete = 1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+trie_insert(coap_resource_t *resource)
+{
+  trie_node_t *node = &trie_root;
+  const char *segment = resource->url;
+  const char *end = segment + strlen(segment);
+  const char *next;
+  trie_node_t **bucket;
+  trie_node_t *child;
+
+  /* Add one node per path segment that is not in the trie yet */
+  if(segment != end) {
+    for(;;) {
+      next = memchr(segment, '/', end - segment);
+      if(next == NULL) {
+        next = end;
+      }
+      child = trie_child(node, segment, next - segment);
+      if(child == NULL) {
+        child = memb_alloc(&trie_memb);
+        if(child == NULL) {
+          LOG_WARN("Resource trie full, dispatching by list\n");
+          trie_complete = 0;
+          return;
+        }
+        memset(child, 0, sizeof(*child));
+        child->parent = node;
+        child->segment = segment;
+        child->segment_len = next - segment;
+        bucket = trie_bucket(node, segment, child->segment_len);
+        child->hash_next = *bucket;
+        *bucket = child;
+      }
+      node = child;
+      if(next == end) {
+        break;
+      }
+      segment = next + 1;
+    }
+  }
+
+  if(node->exact == NULL) {
+    node->exact = resource;
+    node->exact_order = trie_order;
+  }
+  if(node->sub == NULL && (resource->flags & HAS_SUB_RESOURCES)) {
+    node->sub = resource;
+    node->sub_order = trie_order;
+  }
+  trie_order++;
+}
+/*---------------------------------------------------------------------------*/
+static coap_resource_t *
+trie_lookup(const char *url, int url_len)
+{
+  const trie_node_t *node = &trie_root;
+  const char *next;
+  coap_resource_t *best = NULL;
+  uint16_t best_order = 0;
+  int pos;
+  int next_pos;
+
+  if(url_len <= 0) {
+    return trie_root.exact;
+  }
+
+  /* Resources with the empty URL only take sub-resources under a path that
+     starts with a slash, as the path must continue with one after a prefix */
+  if(url[0] == '/' && trie_root.sub != NULL) {
+    best = trie_root.sub;
+    best_order = trie_root.sub_order;
+  }
+
+  /* Walk down the path one segment per pass, looking for the earliest
+     activated resource that either has the whole path or a prefix of it
+     with sub-resources. A path ending with a slash ends with an empty
+     segment. */
+  for(pos = 0; pos <= url_len; pos = next_pos + 1) {
+    if(node != &trie_root && node->sub != NULL &&
+       (best == NULL || node->sub_order < best_order)) {
+      best = node->sub;
+      best_order = node->sub_order;
+    }
+    next = memchr(url + pos, '/', url_len - pos);
+    next_pos = next == NULL ? url_len : next - url;
+    node = trie_child(node, url + pos, next_pos - pos);
+    if(node == NULL) {
+      return best;
+    }
+  }
+
+  if(node->exact != NULL && (best == NULL || node->exact_order < best_order)) {
+    best = node->exact;
+  }
+  return best;
+}
+#endif /* COAP_RESOURCE_TRIE_NODES */
 /*---------------------------------------------------------------------------*/
 /*- CoAP service handlers---------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
@@ -379,6 +550,9 @@ coap_engine_init(void)
 
   list_init(coap_handlers);
   list_init(coap_resource_services);
+#if COAP_RESOURCE_TRIE_NODES
+  trie_reset();
+#endif /* COAP_RESOURCE_TRIE_NODES */
 
   coap_activate_resource(&res_well_known_core, ".well-known/core");
 
@@ -397,9 +571,25 @@ void
 coap_activate_resource(coap_resource_t *resource, const char *path)
 {
   coap_periodic_resource_t *periodic;
+#if COAP_RESOURCE_TRIE_NODES
+  uint8_t reactivated = list_contains(coap_resource_services, resource);
+#endif /* COAP_RESOURCE_TRIE_NODES */
   resource->url = path;
   list_add(coap_resource_services, resource);
 
+#if COAP_RESOURCE_TRIE_NODES
+  if(reactivated) {
+    /* The resource moved to the end of the list, maybe with a new URL */
+    coap_resource_t *r;
+    trie_reset();
+    for(r = list_head(coap_resource_services); r != NULL; r = r->next) {
+      trie_insert(r);
+    }
+  } else if(trie_complete) {
+    trie_insert(resource);
+  }
+#endif /* COAP_RESOURCE_TRIE_NODES */
+
   LOG_INFO("Activating: %s\n", resource->url);
 
   /* Only add periodic resources with a periodic_handler and a period > 0. */
@@ -430,19 +620,19 @@ coap_get_next_resource(coap_resource_t *resource)
   return list_item_next(resource);
 }
 /*---------------------------------------------------------------------------*/
-static int
-invoke_coap_resource_service(coap_message_t *request, coap_message_t *response,
-                             uint8_t *buffer, uint16_t buffer_size,
-                             int32_t *offset)
+coap_resource_t *
+coap_get_resource_by_url(const char *url, int url_len)
 {
-  uint8_t found = 0;
-  uint8_t allowed = 1;
+  coap_resource_t *resource;
+  int res_url_len;
 
-  coap_resource_t *resource = NULL;
-  const char *url = NULL;
-  int url_len, res_url_len;
+#if COAP_RESOURCE_TRIE_NODES
+  /* Resources that did not fit in the trie are only found on the list */
+  if(trie_complete) {
+    return trie_lookup(url, url_len);
+  }
+#endif /* COAP_RESOURCE_TRIE_NODES */
 
-  url_len = coap_get_header_uri_path(request, &url);
   for(resource = list_head(coap_resource_services);
       resource; resource = resource->next) {
 
@@ -453,31 +643,50 @@ invoke_coap_resource_service(coap_message_t *request, coap_message_t *response,
             && (resource->flags & HAS_SUB_RESOURCES)
             && url[res_url_len] == '/'))
        && strncmp(resource->url, url, res_url_len) == 0) {
-      coap_resource_flags_t method = coap_get_method_type(request);
-      found = 1;
-
-      LOG_INFO("/%s, method %u, resource->flags %u\n", resource->url,
-               (uint16_t)method, resource->flags);
-
-      if((method & METHOD_GET) && resource->get_handler != NULL) {
-        /* call handler function */
-        resource->get_handler(request, response, buffer, buffer_size, offset);
-      } else if((method & METHOD_POST) && resource->post_handler != NULL) {
-        /* call handler function */
-        resource->post_handler(request, response, buffer, buffer_size,
+      return resource;
+    }
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+static int
+invoke_coap_resource_service(coap_message_t *request, coap_message_t *response,
+                             uint8_t *buffer, uint16_t buffer_size,
+                             int32_t *offset)
+{
+  uint8_t found = 0;
+  uint8_t allowed = 1;
+
+  coap_resource_t *resource = NULL;
+  const char *url = NULL;
+  int url_len;
+
+  url_len = coap_get_header_uri_path(request, &url);
+  resource = coap_get_resource_by_url(url, url_len);
+  if(resource != NULL) {
+    coap_resource_flags_t method = coap_get_method_type(request);
+    found = 1;
+
+    LOG_INFO("/%s, method %u, resource->flags %u\n", resource->url,
+             (uint16_t)method, resource->flags);
+
+    if((method & METHOD_GET) && resource->get_handler != NULL) {
+      /* call handler function */
+      resource->get_handler(request, response, buffer, buffer_size, offset);
+    } else if((method & METHOD_POST) && resource->post_handler != NULL) {
+      /* call handler function */
+      resource->post_handler(request, response, buffer, buffer_size,
+                             offset);
+    } else if((method & METHOD_PUT) && resource->put_handler != NULL) {
+      /* call handler function */
+      resource->put_handler(request, response, buffer, buffer_size, offset);
+    } else if((method & METHOD_DELETE) && resource->delete_handler != NULL) {
+      /* call handler function */
+      resource->delete_handler(request, response, buffer, buffer_size,
                                offset);
-      } else if((method & METHOD_PUT) && resource->put_handler != NULL) {
-        /* call handler function */
-        resource->put_handler(request, response, buffer, buffer_size, offset);
-      } else if((method & METHOD_DELETE) && resource->delete_handler != NULL) {
-        /* call handler function */
-        resource->delete_handler(request, response, buffer, buffer_size,
-                                 offset);
-      } else {
-        allowed = 0;
-        coap_set_status_code(response, METHOD_NOT_ALLOWED_4_05);
-      }
-      break;
+    } else {
+      allowed = 0;
+      coap_set_status_code(response, METHOD_NOT_ALLOWED_4_05);
     }
   }
   if(!found) {
@@ -167,6 +167,15 @@ coap_resource_t *coap_get_first_resource(void);
  */
 coap_resource_t *coap_get_next_resource(coap_resource_t *resource);
 /*---------------------------------------------------------------------------*/
+/**
+ * \brief      Returns the resource that handles a given URI path.
+ * \param url  The URI path, not null-terminated.
+ * \param url_len The length of the URI path.
+ * \return     The first activated resource whose URL is the path, or a
+ *             parent of the path for resources with sub-resources, or NULL.
+ */
+coap_resource_t *coap_get_resource_by_url(const char *url, int url_len);
+/*---------------------------------------------------------------------------*/
 
 #include "coap-transactions.h"
 #include "coap-observe.h"
@@ -241,6 +241,231 @@ static uint16_t my_tag;
 /* Assuming that the worst growth for uncompression is 38 bytes */
 #define SICSLOWPAN_FIRST_FRAGMENT_SIZE (SICSLOWPAN_FRAGMENT_SIZE + 38)
 
+/* With SICSLOWPAN_CONF_REASS_WITH_BITMAP, each reassembly context
+ * holds a whole packet that fragments are copied into directly at
+ * their offset, and a bitmap of the 8-byte units received so far.
+ * Fragments may then arrive in any order and duplicates are harmless.
+ * When all contexts are busy, the least recently used one is evicted.
+ * SICSLOWPAN_FRAGMENT_BUFFERS is not used in this mode.
+ **/
+#ifdef SICSLOWPAN_CONF_REASS_WITH_BITMAP
+#define SICSLOWPAN_REASS_WITH_BITMAP SICSLOWPAN_CONF_REASS_WITH_BITMAP
+#else
+#define SICSLOWPAN_REASS_WITH_BITMAP 0
+#endif
+
+/* The largest packet that a bitmap reassembly context can hold */
+#ifdef SICSLOWPAN_CONF_REASS_BUF_SIZE
+#define SICSLOWPAN_REASS_BUF_SIZE SICSLOWPAN_CONF_REASS_BUF_SIZE
+#else
+#define SICSLOWPAN_REASS_BUF_SIZE UIP_BUFSIZE
+#endif
+
+#if SICSLOWPAN_REASS_STATS
+struct sicslowpan_reass_stats sicslowpan_reass_stats;
+#define REASS_STAT(field) (sicslowpan_reass_stats.field++)
+#else /* SICSLOWPAN_REASS_STATS */
+#define REASS_STAT(field)
+#endif /* SICSLOWPAN_REASS_STATS */
+
+#if SICSLOWPAN_REASS_WITH_BITMAP
+
+/* Fragment offsets are in units of 8 bytes */
+#define REASS_UNITS ((SICSLOWPAN_REASS_BUF_SIZE + 7) / 8)
+
+/* The first fragment is uncompressed directly into the packet */
+#define REASS_FIRST_FRAG_SIZE SICSLOWPAN_REASS_BUF_SIZE
+
+/* all information needed for reassembly */
+struct sicslowpan_frag_info {
+  /** When reassembling, the source address of the fragments being merged */
+  linkaddr_t sender;
+  /** When reassembling, the tag in the fragments being merged. */
+  uint16_t tag;
+  /** Total length of the fragmented packet (zero if the context is free) */
+  uint16_t len;
+  /** Number of 8-byte units of the packet not received yet */
+  uint16_t missing;
+  /** Reassembly %process %timer. */
+  struct timer reass_timer;
+  /** Value of reass_clock when the context was last used */
+  uint16_t last_use;
+  /** One bit per received 8-byte unit of the packet */
+  uint8_t received[(REASS_UNITS + 7) / 8];
+  /** The packet being reassembled */
+  uint8_t buf[SICSLOWPAN_REASS_BUF_SIZE];
+};
+
+static struct sicslowpan_frag_info frag_info[SICSLOWPAN_REASS_CONTEXTS];
+
+/* Counts context uses, to find the least recently used context */
+static uint16_t reass_clock;
+
+/*---------------------------------------------------------------------------*/
+static void
+clear_fragments(uint8_t frag_info_index)
+{
+  frag_info[frag_info_index].len = 0;
+}
+/*---------------------------------------------------------------------------*/
+static void
+mark_received(struct sicslowpan_frag_info *info, uint16_t start, uint16_t len)
+{
+  uint16_t unit;
+
+  for(unit = start / 8; unit < (start + len + 7) / 8; unit++) {
+    if((info->received[unit / 8] & (1 << (unit % 8))) == 0) {
+      info->received[unit / 8] |= 1 << (unit % 8);
+      info->missing--;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Find the context of a packet, or set up a new one */
+static int8_t
+find_context(uint16_t tag, uint16_t frag_size)
+{
+  const linkaddr_t *sender = packetbuf_addr(PACKETBUF_ADDR_SENDER);
+  struct sicslowpan_frag_info *info;
+  int8_t found = -1;
+  int8_t lru = -1;
+  int i;
+
+  for(i = 0; i < SICSLOWPAN_REASS_CONTEXTS; i++) {
+    info = &frag_info[i];
+    if(info->len > 0 && timer_expired(&info->reass_timer)) {
+      LOG_WARN("reassembly: timed out - tag: %d\n", info->tag);
+      REASS_STAT(timeouts);
+      clear_fragments(i);
+    }
+    if(info->len > 0 && info->tag == tag &&
+       linkaddr_cmp(&info->sender, sender)) {
+      if(info->len == frag_size) {
+        return i;
+      }
+      /* The sender has reused the tag for another packet */
+      REASS_STAT(evictions);
+      clear_fragments(i);
+    }
+    if(info->len == 0) {
+      if(found < 0) {
+        found = i;
+      }
+    } else if(lru < 0 ||
+              (int16_t)(info->last_use - frag_info[lru].last_use) < 0) {
+      lru = i;
+    }
+  }
+
+  if(found < 0) {
+    LOG_WARN("reassembly: evicting session - tag: %d\n", frag_info[lru].tag);
+    REASS_STAT(evictions);
+    found = lru;
+  }
+
+  info = &frag_info[found];
+  linkaddr_copy(&info->sender, sender);
+  info->tag = tag;
+  info->len = frag_size;
+  info->missing = (frag_size + 7) / 8;
+  memset(info->received, 0, sizeof(info->received));
+  timer_set(&info->reass_timer, SICSLOWPAN_REASS_MAXAGE * CLOCK_SECOND / 16);
+  return found;
+}
+/*---------------------------------------------------------------------------*/
+/* add a new fragment to the buffer */
+static int8_t
+add_fragment(uint16_t tag, uint16_t frag_size, uint8_t offset)
+{
+  struct sicslowpan_frag_info *info;
+  uint16_t start;
+  int8_t context;
+  int len;
+
+  if(frag_size == 0 || frag_size > SICSLOWPAN_REASS_BUF_SIZE) {
+    LOG_WARN("reassembly: unsupported packet size %u - tag: %d\n",
+             frag_size, tag);
+    REASS_STAT(drops);
+    return -1;
+  }
+
+  start = (uint16_t)offset << 3;
+  len = packetbuf_datalen() - packetbuf_hdr_len;
+  if(offset > 0 && (len <= 0 || start >= frag_size)) {
+    LOG_WARN("reassembly: invalid fragment - tag: %d offset: %d\n",
+             tag, offset);
+    REASS_STAT(drops);
+    return -1;
+  }
+
+  context = find_context(tag, frag_size);
+  info = &frag_info[context];
+  info->last_use = ++reass_clock;
+
+  if(offset == 0) {
+    /* first fragment is uncompressed directly into the context buffer
+       by the caller */
+    return context;
+  }
+
+  if(start + len > frag_size) {
+    /* Ignore extraneous bytes at the end of the packet */
+    len = frag_size - start;
+  }
+
+  memcpy(info->buf + start, packetbuf_ptr + packetbuf_hdr_len, len);
+  mark_received(info, start, len);
+  return context;
+}
+/*---------------------------------------------------------------------------*/
+static uint8_t *
+first_fragment_buf(int8_t context)
+{
+  return frag_info[context].buf;
+}
+/*---------------------------------------------------------------------------*/
+/* Account for the first fragment, once uncompressed into its buffer */
+static bool
+first_fragment_stored(int8_t context, uint16_t len)
+{
+  if(len > frag_info[context].len) {
+    LOG_WARN("input: invalid total size of fragments\n");
+    REASS_STAT(drops);
+    clear_fragments(context);
+    return false;
+  }
+  mark_received(&frag_info[context], 0, len);
+  return true;
+}
+/*---------------------------------------------------------------------------*/
+static bool
+fragments_complete(int8_t context)
+{
+  return frag_info[context].missing == 0;
+}
+/*---------------------------------------------------------------------------*/
+/* Copy the reassembled packet of a context into uip */
+static bool
+copy_frags2uip(int context)
+{
+  if(frag_info[context].len > sizeof(uip_buf)) {
+    LOG_WARN("input: invalid total size of fragments\n");
+    REASS_STAT(drops);
+    clear_fragments(context);
+    return false;
+  }
+
+  memcpy((uint8_t *)UIP_IP_BUF, frag_info[context].buf, frag_info[context].len);
+  clear_fragments(context);
+  REASS_STAT(completed);
+
+  return true;
+}
+
+#else /* SICSLOWPAN_REASS_WITH_BITMAP */
+
+#define REASS_FIRST_FRAG_SIZE SICSLOWPAN_FIRST_FRAGMENT_SIZE
+
 /* all information needed for reassembly */
 struct sicslowpan_frag_info {
   /** When reassembling, the source address of the fragments being merged */
@@ -303,6 +528,7 @@ timeout_fragments(int not_context)
     if(frag_info[i].len > 0 && i != not_context &&
        timer_expired(&frag_info[i].reass_timer)) {
       /* This context can be freed */
+      REASS_STAT(timeouts);
       count += clear_fragments(i);
     }
   }
@@ -351,6 +577,7 @@ add_fragment(uint16_t tag, uint16_t frag_size, uint8_t offset)
     for(i = 0; i < SICSLOWPAN_REASS_CONTEXTS; i++) {
       /* clear all fragment info with expired timer to free all fragment buffers */
       if(frag_info[i].len > 0 && timer_expired(&frag_info[i].reass_timer)) {
+        REASS_STAT(timeouts);
         clear_fragments(i);
       }
 
@@ -364,6 +591,7 @@ add_fragment(uint16_t tag, uint16_t frag_size, uint8_t offset)
 
     if(found < 0) {
       LOG_WARN("reassembly: failed to store new fragment session - tag: %d\n", tag);
+      REASS_STAT(drops);
       return -1;
     }
 
@@ -391,6 +619,7 @@ add_fragment(uint16_t tag, uint16_t frag_size, uint8_t offset)
   if(found < 0) {
     /* no entry found for storing the new fragment */
     LOG_WARN("reassembly: failed to store N-fragment - could not find session - tag: %d offset: %d\n", tag, offset);
+    REASS_STAT(drops);
     return -1;
   }
 
@@ -406,10 +635,32 @@ add_fragment(uint16_t tag, uint16_t frag_size, uint8_t offset)
     /* should we also clear all fragments since we failed to store
        this fragment? */
     LOG_WARN("reassembly: failed to store fragment - packet reassembly will fail tag:%d l\n", frag_info[i].tag);
+    REASS_STAT(drops);
     return -1;
   }
 }
 /*---------------------------------------------------------------------------*/
+static uint8_t *
+first_fragment_buf(int8_t context)
+{
+  return frag_info[context].first_frag;
+}
+/*---------------------------------------------------------------------------*/
+/* Account for the first fragment, once uncompressed into its buffer */
+static bool
+first_fragment_stored(int8_t context, uint16_t len)
+{
+  frag_info[context].reassembled_len = len;
+  frag_info[context].first_frag_len = len;
+  return true;
+}
+/*---------------------------------------------------------------------------*/
+static bool
+fragments_complete(int8_t context)
+{
+  return frag_info[context].reassembled_len >= frag_info[context].len;
+}
+/*---------------------------------------------------------------------------*/
 /* Copy all the fragments that are associated with a specific context
    into uip */
 static bool
@@ -421,6 +672,7 @@ copy_frags2uip(int context)
   if(frag_info[context].len < frag_info[context].first_frag_len ||
      frag_info[context].len > sizeof(uip_buf)) {
     LOG_WARN("input: invalid total size of fragments\n");
+    REASS_STAT(drops);
     clear_fragments(context);
     return false;
   }
@@ -438,6 +690,7 @@ copy_frags2uip(int context)
     if(frag_buf[i].len > 0 && frag_buf[i].index == context) {
       if(((size_t)frag_buf[i].offset << 3) + frag_buf[i].len > sizeof(uip_buf)) {
         LOG_WARN("input: invalid fragment offset\n");
+        REASS_STAT(drops);
         clear_fragments(context);
         return false;
       }
@@ -447,9 +700,11 @@ copy_frags2uip(int context)
   }
   /* deallocate all the fragments for this context */
   clear_fragments(context);
+  REASS_STAT(completed);
 
   return true;
 }
+#endif /* SICSLOWPAN_REASS_WITH_BITMAP */
 #endif /* SICSLOWPAN_CONF_FRAG */
 
 /* -------------------------------------------------------------------------- */
@@ -1594,9 +1849,11 @@ fragment_copy_payload_and_send(uint16_t uip_offset, linkaddr_t *dest) {
   /* Send fragment */
   send_packet(dest);
 
-  /* Restore packetbuf from queuebuf */
-  queuebuf_to_packetbuf(q);
+  /* Restore packetbuf from queuebuf. The MAC layer may have taken over
+     the packetbuf storage, so refresh our pointer into it. */
+  queuebuf_move_to_packetbuf(q);
   queuebuf_free(q);
+  packetbuf_ptr = packetbuf_dataptr();
 
   /* Check tx result. */
   if((last_tx_status == MAC_TX_COLLISION) ||
@@ -1928,8 +2185,8 @@ input(void)
         return;
       }
 
-      buffer = frag_info[frag_context].first_frag;
-      buffer_size = SICSLOWPAN_FIRST_FRAGMENT_SIZE;
+      buffer = first_fragment_buf(frag_context);
+      buffer_size = REASS_FIRST_FRAG_SIZE;
       break;
     case SICSLOWPAN_DISPATCH_FRAGN:
       /*
@@ -1954,7 +2211,7 @@ input(void)
          we should not store more */
       buffer = NULL;
 
-      if(frag_info[frag_context].reassembled_len >= frag_size) {
+      if(fragments_complete(frag_context)) {
         last_fragment = 1;
       }
       is_fragment = 1;
@@ -2053,7 +2310,12 @@ input(void)
       LOG_ERR("input: cannot copy the payload into the buffer\n");
       return;
     }
-    memcpy((uint8_t *)buffer + uncomp_hdr_len, packetbuf_ptr + packetbuf_hdr_len, packetbuf_payload_len);
+    if(buffer == (uint8_t *)UIP_IP_BUF) {
+      /* Sum the payload on the way for the upper-layer checksum */
+      uip_copy_chksum(uncomp_hdr_len, packetbuf_ptr + packetbuf_hdr_len, packetbuf_payload_len);
+    } else {
+      memcpy((uint8_t *)buffer + uncomp_hdr_len, packetbuf_ptr + packetbuf_hdr_len, packetbuf_payload_len);
+    }
   }
 
   /* update processed_ip_in_len if fragment, sicslowpan_len otherwise */
@@ -2062,13 +2324,16 @@ input(void)
   if(frag_size > 0) {
     /* Add the size of the header only for the first fragment. */
     if(first_fragment != 0) {
-      frag_info[frag_context].reassembled_len = uncomp_hdr_len + packetbuf_payload_len;
-      frag_info[frag_context].first_frag_len = uncomp_hdr_len + packetbuf_payload_len;
+      if(!first_fragment_stored(frag_context,
+                                uncomp_hdr_len + packetbuf_payload_len)) {
+        return;
+      }
+      /* The other fragments may have arrived first */
+      last_fragment = fragments_complete(frag_context);
     }
     /* For the last fragment, we are OK if there is extrenous bytes at
        the end of the packet. */
     if(last_fragment != 0) {
-      frag_info[frag_context].reassembled_len = frag_size;
       /* copy to uip */
       if(!copy_frags2uip(frag_context)) {
         return;
@@ -2123,6 +2388,7 @@ input(void)
 #endif /*  LLSEC802154_USES_AUX_HEADER */
 
     tcpip_input();
+    uip_forget_chksum();
 #if SICSLOWPAN_CONF_FRAG
   }
 #endif /* SICSLOWPAN_CONF_FRAG */
@@ -332,6 +332,24 @@ struct sicslowpan_nh_compressor {
 
 };
 
+#ifdef SICSLOWPAN_CONF_REASS_STATS
+#define SICSLOWPAN_REASS_STATS SICSLOWPAN_CONF_REASS_STATS
+#else
+#define SICSLOWPAN_REASS_STATS 0
+#endif
+
+#if SICSLOWPAN_REASS_STATS
+/** \brief Fragment reassembly counters */
+struct sicslowpan_reass_stats {
+  uint16_t completed; /**< Packets reassembled */
+  uint16_t drops;     /**< Fragments dropped */
+  uint16_t timeouts;  /**< Packets dropped on reassembly timeout */
+  uint16_t evictions; /**< Packets dropped to make room for another */
+};
+
+extern struct sicslowpan_reass_stats sicslowpan_reass_stats;
+#endif /* SICSLOWPAN_REASS_STATS */
+
 extern CC_DEPRECATED("Use UIPBUF_ATTR_RSSI instead") int sicslowpan_get_last_rssi(void);
 
 extern const struct network_driver sicslowpan_driver;
@@ -99,6 +99,41 @@ simple_udp_sendto_port(struct simple_udp_connection *c,
 }
 /*---------------------------------------------------------------------------*/
 int
+simple_udp_sendv(struct simple_udp_connection *c,
+                 const struct uip_iov *iov, int iovcnt)
+{
+  if(c->udp_conn != NULL) {
+    uip_udp_packet_sendtov(c->udp_conn, iov, iovcnt,
+                           &c->remote_addr, UIP_HTONS(c->remote_port));
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+int
+simple_udp_sendtov(struct simple_udp_connection *c,
+                   const struct uip_iov *iov, int iovcnt,
+                   const uip_ipaddr_t *to)
+{
+  if(c->udp_conn != NULL) {
+    uip_udp_packet_sendtov(c->udp_conn, iov, iovcnt,
+                           to, UIP_HTONS(c->remote_port));
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+int
+simple_udp_sendto_portv(struct simple_udp_connection *c,
+                        const struct uip_iov *iov, int iovcnt,
+                        const uip_ipaddr_t *to, uint16_t port)
+{
+  if(c->udp_conn != NULL) {
+    uip_udp_packet_sendtov(c->udp_conn, iov, iovcnt,
+                           to, UIP_HTONS(port));
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+int
 simple_udp_register(struct simple_udp_connection *c,
                     uint16_t local_port,
                     uip_ipaddr_t *remote_addr,
@@ -157,6 +157,49 @@ int simple_udp_sendto_port(struct simple_udp_connection *c,
 			   const void *data, uint16_t datalen,
 			   const uip_ipaddr_t *to, uint16_t to_port);
 
+/**
+ * \brief      Send a UDP packet gathered from several buffers
+ * \param c    A pointer to a struct simple_udp_connection
+ * \param iov  The buffers holding the data, in order
+ * \param iovcnt The number of buffers
+ *
+ *     This function works as simple_udp_send(), but copies the
+ *     data straight from the buffers into the outgoing packet,
+ *     e.g. a protocol header and its payload, so that they do
+ *     not have to be put together first.
+ *
+ * \sa simple_udp_send()
+ */
+int simple_udp_sendv(struct simple_udp_connection *c,
+                     const struct uip_iov *iov, int iovcnt);
+
+/**
+ * \brief      Send a UDP packet gathered from several buffers to a specified IP address
+ * \param c    A pointer to a struct simple_udp_connection
+ * \param iov  The buffers holding the data, in order
+ * \param iovcnt The number of buffers
+ * \param to   The IP address of the receiver
+ *
+ * \sa simple_udp_sendto(), simple_udp_sendv()
+ */
+int simple_udp_sendtov(struct simple_udp_connection *c,
+                       const struct uip_iov *iov, int iovcnt,
+                       const uip_ipaddr_t *to);
+
+/**
+ * \brief      Send a UDP packet gathered from several buffers to a specified IP address and UDP port
+ * \param c    A pointer to a struct simple_udp_connection
+ * \param iov  The buffers holding the data, in order
+ * \param iovcnt The number of buffers
+ * \param to   The IP address of the receiver
+ * \param to_port   The UDP port of the receiver, in host byte order
+ *
+ * \sa simple_udp_sendto_port(), simple_udp_sendv()
+ */
+int simple_udp_sendto_portv(struct simple_udp_connection *c,
+                            const struct uip_iov *iov, int iovcnt,
+                            const uip_ipaddr_t *to, uint16_t to_port);
+
 void simple_udp_init(void);
 
 #endif /* SIMPLE_UDP_H */
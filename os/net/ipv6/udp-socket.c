@@ -144,6 +144,54 @@ udp_socket_sendto(struct udp_socket *c,
   return -1;
 }
 /*---------------------------------------------------------------------------*/
+static int
+iov_len(const struct uip_iov *iov, int iovcnt)
+{
+  int i, len;
+
+  len = 0;
+  for(i = 0; i < iovcnt; i++) {
+    len += iov[i].len;
+  }
+  return len <= UIP_BUFSIZE - UIP_IPUDPH_LEN ? len : -1;
+}
+/*---------------------------------------------------------------------------*/
+int
+udp_socket_sendv(struct udp_socket *c,
+                 const struct uip_iov *iov, int iovcnt)
+{
+  int len;
+
+  if(c == NULL || c->udp_conn == NULL) {
+    return -1;
+  }
+
+  len = iov_len(iov, iovcnt);
+  if(len >= 0) {
+    uip_udp_packet_sendv(c->udp_conn, iov, iovcnt);
+  }
+  return len;
+}
+/*---------------------------------------------------------------------------*/
+int
+udp_socket_sendtov(struct udp_socket *c,
+                   const struct uip_iov *iov, int iovcnt,
+                   const uip_ipaddr_t *to,
+                   uint16_t port)
+{
+  int len;
+
+  if(c == NULL || c->udp_conn == NULL) {
+    return -1;
+  }
+
+  len = iov_len(iov, iovcnt);
+  if(len >= 0) {
+    uip_udp_packet_sendtov(c->udp_conn, iov, iovcnt, to, UIP_HTONS(port));
+  }
+  return len;
+}
+/*---------------------------------------------------------------------------*/
 PROCESS_THREAD(udp_socket_process, ev, data)
 {
   struct udp_socket *c;
@@ -175,6 +175,39 @@ int udp_socket_sendto(struct udp_socket *c,
                       const void *data, uint16_t datalen,
                       const uip_ipaddr_t *addr, uint16_t port);
 
+/**
+ * \brief      Send data gathered from several buffers on a UDP socket
+ * \param c    A pointer to the struct udp_socket on which the data should be sent
+ * \param iov  The buffers holding the data, in order
+ * \param iovcnt The number of buffers
+ * \return     The number of bytes sent, or -1 if an error occurred
+ *
+ *             This function works as udp_socket_send(), but copies
+ *             the data straight from the buffers into the outgoing
+ *             packet, e.g. a protocol header and its payload, so that
+ *             they do not have to be put together first.
+ *
+ */
+int udp_socket_sendv(struct udp_socket *c,
+                     const struct uip_iov *iov, int iovcnt);
+
+/**
+ * \brief      Send data gathered from several buffers on a UDP socket to a specific address and port
+ * \param c    A pointer to the struct udp_socket on which the data should be sent
+ * \param iov  The buffers holding the data, in order
+ * \param iovcnt The number of buffers
+ * \param addr The IP address to which the data should be sent
+ * \param port The UDP port number, in host byte order, to which the data should be sent
+ * \return     The number of bytes sent, or -1 if an error occurred
+ *
+ *             This function works as udp_socket_sendto(), with the
+ *             data gathered as by udp_socket_sendv().
+ *
+ */
+int udp_socket_sendtov(struct udp_socket *c,
+                       const struct uip_iov *iov, int iovcnt,
+                       const uip_ipaddr_t *addr, uint16_t port);
+
 /**
  * \brief      Close a UDP socket
  * \param c    A pointer to the struct udp_socket to be closed
@@ -106,6 +106,20 @@ uint16_t uip_tcpchksum(void);
 
 uint16_t uip_udpchksum(void);
 
+/**
+ * Add data to a 16-bit one's complement sum.
+ *
+ * Only used when the platform defines UIP_ARCH_CHKSUM_ADD, in which
+ * case it replaces the portable checksum kernel of uIP.
+ *
+ * \param sum The sum so far, in host byte order.
+ * \param data A pointer to the data, with no alignment guarantee.
+ * \param len The length of the data. An odd last byte is summed as if
+ * followed by a zero byte.
+ * \return The new sum, in host byte order.
+ */
+uint16_t uip_arch_chksum_add(uint16_t sum, const uint8_t *data, uint16_t len);
+
 /** @} */
 
 #endif /* UIP_ARCH_H_ */
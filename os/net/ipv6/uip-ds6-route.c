@@ -91,6 +91,19 @@ MEMB(routememb, uip_ds6_route_t, UIP_DS6_ROUTE_NB);
 static int num_routes = 0;
 static void rm_routelist_callback(nbr_table_item_t *ptr);
 
+#if UIP_DS6_ROUTE_WITH_HASH
+/* Host routes are chained in hash buckets, prefix routes on a list of
+   their own. Both use the hash_next field of the route. */
+static uip_ds6_route_t *host_routes[UIP_DS6_ROUTE_HASH_SIZE];
+static uip_ds6_route_t *prefix_routes;
+#if UIP_DS6_ROUTE_REMOVE_LEAST_RECENTLY_USED
+/* The routelist is not reordered on lookups, so routes are stamped
+   with this counter when used and the oldest stamp is evicted. */
+static uint32_t route_use_counter;
+#define ROUTE_TOUCH(r) ((r)->last_used = ++route_use_counter)
+#endif /* UIP_DS6_ROUTE_REMOVE_LEAST_RECENTLY_USED */
+#endif /* UIP_DS6_ROUTE_WITH_HASH */
+
 #endif /* (UIP_MAX_ROUTES != 0) */
 
 /* Default routes are held on the defaultrouterlist and their
@@ -102,6 +115,49 @@ MEMB(defaultroutermemb, uip_ds6_defrt_t, UIP_DS6_DEFRT_NB);
 LIST(notificationlist);
 #endif
 
+#if UIP_DS6_ROUTE_WITH_HASH
+/*---------------------------------------------------------------------------*/
+static uip_ds6_route_t **
+route_chain(const uip_ipaddr_t *ipaddr, uint8_t length)
+{
+  uint32_t hash = 2166136261UL;
+  int i;
+
+  if(length != 128) {
+    return &prefix_routes;
+  }
+
+  /* FNV-1a over the address bytes */
+  for(i = 0; i < sizeof(uip_ipaddr_t); i++) {
+    hash = (hash ^ ipaddr->u8[i]) * 16777619UL;
+  }
+  return &host_routes[hash % UIP_DS6_ROUTE_HASH_SIZE];
+}
+/*---------------------------------------------------------------------------*/
+static void
+route_index_add(uip_ds6_route_t *route)
+{
+  uip_ds6_route_t **chain = route_chain(&route->ipaddr, route->length);
+
+  route->hash_next = *chain;
+  *chain = route;
+}
+/*---------------------------------------------------------------------------*/
+static void
+route_index_rm(uip_ds6_route_t *route)
+{
+  uip_ds6_route_t **prev;
+
+  for(prev = route_chain(&route->ipaddr, route->length);
+      *prev != NULL; prev = &(*prev)->hash_next) {
+    if(*prev == route) {
+      *prev = route->hash_next;
+      route->hash_next = NULL;
+      return;
+    }
+  }
+}
+#endif /* UIP_DS6_ROUTE_WITH_HASH */
 /*---------------------------------------------------------------------------*/
 static void
 assert_nbr_routes_list_sane(void)
@@ -174,6 +230,10 @@ uip_ds6_route_init(void)
 #if (UIP_MAX_ROUTES != 0)
   memb_init(&routememb);
   list_init(routelist);
+#if UIP_DS6_ROUTE_WITH_HASH
+  memset(host_routes, 0, sizeof(host_routes));
+  prefix_routes = NULL;
+#endif /* UIP_DS6_ROUTE_WITH_HASH */
   nbr_table_register(nbr_routes,
                      (nbr_table_callback *)rm_routelist_callback);
 #endif /* (UIP_MAX_ROUTES != 0) */
@@ -295,6 +355,25 @@ uip_ds6_route_lookup(const uip_ipaddr_t *addr)
 
   found_route = NULL;
   longestmatch = 0;
+#if UIP_DS6_ROUTE_WITH_HASH
+  /* A host route is always the longest match, so look for one first
+     and only fall back to the prefix routes if there is none. */
+  for(r = *route_chain(addr, 128); r != NULL; r = r->hash_next) {
+    if(uip_ipaddr_cmp(addr, &r->ipaddr)) {
+      found_route = r;
+      break;
+    }
+  }
+  for(r = found_route == NULL ? prefix_routes : NULL;
+      r != NULL;
+      r = r->hash_next) {
+    if(r->length >= longestmatch &&
+       uip_ipaddr_prefixcmp(addr, &r->ipaddr, r->length)) {
+      longestmatch = r->length;
+      found_route = r;
+    }
+  }
+#else /* UIP_DS6_ROUTE_WITH_HASH */
   for(r = uip_ds6_route_head();
       r != NULL;
       r = uip_ds6_route_next(r)) {
@@ -308,6 +387,7 @@ uip_ds6_route_lookup(const uip_ipaddr_t *addr)
       }
     }
   }
+#endif /* UIP_DS6_ROUTE_WITH_HASH */
 
   if(found_route != NULL) {
     LOG_INFO("Found route: ");
@@ -319,6 +399,7 @@ uip_ds6_route_lookup(const uip_ipaddr_t *addr)
     LOG_WARN("No route found\n");
   }
 
+#if !UIP_DS6_ROUTE_WITH_HASH
   if(found_route != NULL && found_route != list_head(routelist)) {
     /* If we found a route, we put it at the start of the routeslist
        list. The list is ordered by how recently we looked them up:
@@ -328,6 +409,11 @@ uip_ds6_route_lookup(const uip_ipaddr_t *addr)
     list_remove(routelist, found_route);
     list_push(routelist, found_route);
   }
+#elif UIP_DS6_ROUTE_REMOVE_LEAST_RECENTLY_USED
+  if(found_route != NULL) {
+    ROUTE_TOUCH(found_route);
+  }
+#endif /* !UIP_DS6_ROUTE_WITH_HASH */
 
   return found_route;
 #else /* (UIP_MAX_ROUTES != 0) */
@@ -387,9 +473,21 @@ uip_ds6_route_add(const uip_ipaddr_t *ipaddr, uint8_t length,
       uip_ds6_route_t *oldest;
       oldest = NULL;
 #if UIP_DS6_ROUTE_REMOVE_LEAST_RECENTLY_USED
+#if UIP_DS6_ROUTE_WITH_HASH
+      /* Removing the route entry with the oldest use stamp. The
+         difference to the counter is the age even if it wrapped. */
+      for(r = list_head(routelist); r != NULL; r = list_item_next(r)) {
+        if(oldest == NULL ||
+           route_use_counter - r->last_used >
+           route_use_counter - oldest->last_used) {
+          oldest = r;
+        }
+      }
+#else /* UIP_DS6_ROUTE_WITH_HASH */
       /* Removing the oldest route entry from the route table. The
          least recently used route is the first route on the list. */
       oldest = list_tail(routelist);
+#endif /* UIP_DS6_ROUTE_WITH_HASH */
 #endif
       if(oldest == NULL) {
         return NULL;
@@ -446,6 +544,9 @@ uip_ds6_route_add(const uip_ipaddr_t *ipaddr, uint8_t length,
     /* add new routes first - assuming that there is a reason to add this
        and that there is a packet coming soon. */
     list_push(routelist, r);
+#if UIP_DS6_ROUTE_WITH_HASH && UIP_DS6_ROUTE_REMOVE_LEAST_RECENTLY_USED
+    ROUTE_TOUCH(r);
+#endif /* UIP_DS6_ROUTE_WITH_HASH && UIP_DS6_ROUTE_REMOVE_LEAST_RECENTLY_USED */
 
     nbrr = memb_alloc(&neighborroutememb);
     if(nbrr == NULL) {
@@ -470,6 +571,9 @@ uip_ds6_route_add(const uip_ipaddr_t *ipaddr, uint8_t length,
 
   uip_ipaddr_copy(&(r->ipaddr), ipaddr);
   r->length = length;
+#if UIP_DS6_ROUTE_WITH_HASH
+  route_index_add(r);
+#endif /* UIP_DS6_ROUTE_WITH_HASH */
 
 #ifdef UIP_DS6_ROUTE_STATE_TYPE
   memset(&r->state, 0, sizeof(UIP_DS6_ROUTE_STATE_TYPE));
@@ -515,6 +619,9 @@ uip_ds6_route_rm(uip_ds6_route_t *route)
 
     /* Remove the route from the route list */
     list_remove(routelist, route);
+#if UIP_DS6_ROUTE_WITH_HASH
+    route_index_rm(route);
+#endif /* UIP_DS6_ROUTE_WITH_HASH */
 
     /* Find the corresponding neighbor_route and remove it. */
     for(neighbor_route = list_head(route->neighbor_routes->route_list);
@@ -111,6 +111,26 @@ void uip_ds6_notification_rm(struct uip_ds6_notification *n);
 #define UIP_DS6_ROUTE_NB 4
 #endif /* UIP_MAX_ROUTES */
 
+/** \brief Index host routes (/128) in a hash table, and keep prefix
+ *  routes on a separate list, so that route lookups do not scan the
+ *  whole routing table. With the hash index, the routing table is
+ *  kept in insertion order rather than in least-recently-used order;
+ *  with UIP_DS6_ROUTE_REMOVE_LEAST_RECENTLY_USED, each route then
+ *  records when it was last used so that eviction still removes the
+ *  least recently used route. */
+#ifdef UIP_DS6_ROUTE_CONF_WITH_HASH
+#define UIP_DS6_ROUTE_WITH_HASH UIP_DS6_ROUTE_CONF_WITH_HASH
+#else /* UIP_DS6_ROUTE_CONF_WITH_HASH */
+#define UIP_DS6_ROUTE_WITH_HASH 0
+#endif /* UIP_DS6_ROUTE_CONF_WITH_HASH */
+
+/** \brief Number of buckets in the host route hash table */
+#ifdef UIP_DS6_ROUTE_CONF_HASH_SIZE
+#define UIP_DS6_ROUTE_HASH_SIZE UIP_DS6_ROUTE_CONF_HASH_SIZE
+#else /* UIP_DS6_ROUTE_CONF_HASH_SIZE */
+#define UIP_DS6_ROUTE_HASH_SIZE UIP_DS6_ROUTE_NB
+#endif /* UIP_DS6_ROUTE_CONF_HASH_SIZE */
+
 /** \brief define some additional RPL related route state and
  *  neighbor callback for RPL - if not a DS6_ROUTE_STATE is already set */
 #ifndef UIP_DS6_ROUTE_STATE_TYPE
@@ -176,6 +196,14 @@ typedef struct uip_ds6_route {
      belong to the neighbor table entry that this routing table entry
      uses. */
   struct uip_ds6_route_neighbor_routes *neighbor_routes;
+#if UIP_DS6_ROUTE_WITH_HASH
+  /* Next route in the same hash bucket, or on the prefix route list */
+  struct uip_ds6_route *hash_next;
+#if UIP_DS6_ROUTE_REMOVE_LEAST_RECENTLY_USED
+  /* Value of the route use counter when the route was last used */
+  uint32_t last_used;
+#endif /* UIP_DS6_ROUTE_REMOVE_LEAST_RECENTLY_USED */
+#endif /* UIP_DS6_ROUTE_WITH_HASH */
   uip_ipaddr_t ipaddr;
 #ifdef UIP_DS6_ROUTE_STATE_TYPE
   UIP_DS6_ROUTE_STATE_TYPE state;
@@ -186,6 +186,7 @@ uip_icmp6_error_output(uint8_t type, uint8_t code, uint32_t param)
   uip_len += shift;
   uip_len = MIN(uip_len, UIP_LINK_MTU);
   uip_ext_len = 0;
+  uip_forget_chksum();
   memmove(uip_buf + shift, (void *)UIP_IP_BUF, uip_len - shift);
 
   UIP_IP_BUF->vtc = 0x60;
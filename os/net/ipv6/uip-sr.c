@@ -58,6 +58,19 @@ static int num_nodes;
 LIST(nodelist);
 MEMB(nodememb, uip_sr_node_t, UIP_SR_LINK_NUM);
 
+#if UIP_SR_WITH_HASH
+/* Nodes chained by the hash of their link identifier */
+static uip_sr_node_t *node_hash[UIP_SR_HASH_SIZE];
+#endif /* UIP_SR_WITH_HASH */
+
+#if UIP_SR_PATH_CACHE
+/* Incremented whenever the graph changes, which invalidates all cached
+ * path lengths. Zero is never used, so that new nodes start invalid. */
+static uint16_t graph_version = 1;
+/* The root node that the cached path lengths lead to */
+static const uip_sr_node_t *cached_root;
+#endif /* UIP_SR_PATH_CACHE */
+
 /*---------------------------------------------------------------------------*/
 int
 uip_sr_num_nodes(void)
@@ -65,6 +78,72 @@ uip_sr_num_nodes(void)
   return num_nodes;
 }
 /*---------------------------------------------------------------------------*/
+#if UIP_SR_WITH_HASH
+static uip_sr_node_t **
+hash_bucket(const unsigned char *link_identifier)
+{
+  uint32_t hash = 2166136261UL;
+  int i;
+
+  /* FNV-1a over the link identifier */
+  for(i = 0; i < 8; i++) {
+    hash = (hash ^ link_identifier[i]) * 16777619UL;
+  }
+  return &node_hash[hash % UIP_SR_HASH_SIZE];
+}
+/*---------------------------------------------------------------------------*/
+static void
+hash_add(uip_sr_node_t *node)
+{
+  uip_sr_node_t **bucket = hash_bucket(node->link_identifier);
+
+  node->hash_next = *bucket;
+  *bucket = node;
+}
+/*---------------------------------------------------------------------------*/
+static void
+hash_remove(uip_sr_node_t *node)
+{
+  uip_sr_node_t **prev;
+
+  for(prev = hash_bucket(node->link_identifier); *prev != NULL;
+      prev = &(*prev)->hash_next) {
+    if(*prev == node) {
+      *prev = node->hash_next;
+      return;
+    }
+  }
+}
+#endif /* UIP_SR_WITH_HASH */
+/*---------------------------------------------------------------------------*/
+static void
+graph_changed(void)
+{
+#if UIP_SR_PATH_CACHE
+  uip_sr_node_t *l;
+
+  if(++graph_version == 0) {
+    /* Wrapped around: make sure no node has a stale version */
+    for(l = list_head(nodelist); l != NULL; l = list_item_next(l)) {
+      l->path_version = 0;
+    }
+    graph_version = 1;
+  }
+#endif /* UIP_SR_PATH_CACHE */
+}
+/*---------------------------------------------------------------------------*/
+static void
+remove_node(uip_sr_node_t *node)
+{
+  list_remove(nodelist, node);
+#if UIP_SR_WITH_HASH
+  hash_remove(node);
+#endif /* UIP_SR_WITH_HASH */
+  memb_free(&nodememb, node);
+  num_nodes--;
+  graph_changed();
+}
+/*---------------------------------------------------------------------------*/
 static int
 node_matches_address(const void *graph, const uip_sr_node_t *node,
                      const uip_ipaddr_t *addr)
@@ -82,19 +161,70 @@ uip_sr_node_t *
 uip_sr_get_node(const void *graph, const uip_ipaddr_t *addr)
 {
   uip_sr_node_t *l;
+#if UIP_SR_WITH_HASH
+  const unsigned char *link_identifier;
+
+  if(addr == NULL) {
+    return NULL;
+  }
+  link_identifier = ((const unsigned char *)addr) + 8;
+  for(l = *hash_bucket(link_identifier); l != NULL; l = l->hash_next) {
+    /* Compare node identifier first, then the full address */
+    if(memcmp(l->link_identifier, link_identifier, 8) == 0
+       && node_matches_address(graph, l, addr)) {
+      return l;
+    }
+  }
+#else /* UIP_SR_WITH_HASH */
   for(l = list_head(nodelist); l != NULL; l = list_item_next(l)) {
     /* Compare prefix and node identifier */
     if(node_matches_address(graph, l, addr)) {
       return l;
     }
   }
+#endif /* UIP_SR_WITH_HASH */
   return NULL;
 }
 /*---------------------------------------------------------------------------*/
 int
-uip_sr_is_addr_reachable(const void *graph, const uip_ipaddr_t *addr)
+uip_sr_path_length(uip_sr_node_t *node, const uip_sr_node_t *root_node)
 {
   int max_depth = UIP_SR_LINK_NUM;
+  uip_sr_node_t *l = node;
+  int len = 0;
+
+#if UIP_SR_PATH_CACHE
+  if(root_node != cached_root) {
+    cached_root = root_node;
+    graph_changed();
+  }
+  if(node != NULL && node->path_version == graph_version) {
+    return node->path_len;
+  }
+#endif /* UIP_SR_PATH_CACHE */
+
+  while(l != NULL && l != root_node && max_depth > 0) {
+    l = l->parent;
+    max_depth--;
+    len++;
+  }
+  if(l == NULL || l != root_node) {
+    len = -1;
+  }
+
+#if UIP_SR_PATH_CACHE
+  if(node != NULL) {
+    node->path_version = graph_version;
+    node->path_len = len;
+  }
+#endif /* UIP_SR_PATH_CACHE */
+
+  return len;
+}
+/*---------------------------------------------------------------------------*/
+int
+uip_sr_is_addr_reachable(const void *graph, const uip_ipaddr_t *addr)
+{
   uip_ipaddr_t root_ipaddr;
   uip_sr_node_t *node;
   uip_sr_node_t *root_node;
@@ -103,11 +233,7 @@ uip_sr_is_addr_reachable(const void *graph, const uip_ipaddr_t *addr)
   node = uip_sr_get_node(graph, addr);
   root_node = uip_sr_get_node(graph, &root_ipaddr);
 
-  while(node != NULL && node != root_node && max_depth > 0) {
-    node = node->parent;
-    max_depth--;
-  }
-  return node != NULL && node == root_node;
+  return uip_sr_path_length(node, root_node) >= 0;
 }
 /*---------------------------------------------------------------------------*/
 void
@@ -153,29 +279,38 @@ uip_sr_update_node(void *graph, const uip_ipaddr_t *child,
       return NULL;
     }
     child_node->parent = NULL;
+    memcpy(child_node->link_identifier, ((const unsigned char *)child) + 8, 8);
+#if UIP_SR_PATH_CACHE
+    child_node->path_version = 0;
+#endif /* UIP_SR_PATH_CACHE */
     list_add(nodelist, child_node);
+#if UIP_SR_WITH_HASH
+    hash_add(child_node);
+#endif /* UIP_SR_WITH_HASH */
     num_nodes++;
   }
 
   /* Initialize node */
   child_node->graph = graph;
   child_node->lifetime = lifetime;
-  memcpy(child_node->link_identifier, ((const unsigned char *)child) + 8, 8);
 
   /* Is the node reachable before the update? */
   if(uip_sr_is_addr_reachable(graph, child)) {
     old_parent_node = child_node->parent;
     /* Update node */
     child_node->parent = parent_node;
+    graph_changed();
     /* Has the node become unreachable? May happen if we create a loop. */
     if(!uip_sr_is_addr_reachable(graph, child)) {
       /* The new parent makes the node unreachable, restore old parent.
        * We will take the update next time, with chances we know more of
        * the topology and the loop is gone. */
       child_node->parent = old_parent_node;
+      graph_changed();
     }
   } else {
     child_node->parent = parent_node;
+    graph_changed();
   }
 
   LOG_INFO("NS: updating link, child ");
@@ -193,6 +328,10 @@ uip_sr_init(void)
   num_nodes = 0;
   memb_init(&nodememb);
   list_init(nodelist);
+#if UIP_SR_WITH_HASH
+  memset(node_hash, 0, sizeof(node_hash));
+#endif /* UIP_SR_WITH_HASH */
+  graph_changed();
 }
 /*---------------------------------------------------------------------------*/
 uip_sr_node_t *
@@ -234,9 +373,7 @@ uip_sr_periodic(unsigned seconds)
           LOG_INFO_6ADDR(&node_addr);
           LOG_INFO_("\n");
         }
-        list_remove(nodelist, l);
-        memb_free(&nodememb, l);
-        num_nodes--;
+        remove_node(l);
       }
     } else if(l->lifetime != UIP_SR_INFINITE_LIFETIME) {
       l->lifetime = l->lifetime > seconds ? l->lifetime - seconds : 0;
@@ -251,9 +388,7 @@ uip_sr_free_all(void)
   uip_sr_node_t *next;
   for(l = list_head(nodelist); l != NULL; l = next) {
     next = list_item_next(l);
-    list_remove(nodelist, l);
-    memb_free(&nodememb, l);
-    num_nodes--;
+    remove_node(l);
   }
 }
 /*---------------------------------------------------------------------------*/
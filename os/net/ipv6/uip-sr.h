@@ -85,6 +85,30 @@
 
 #define UIP_SR_INFINITE_LIFETIME           0xFFFFFFFF
 
+/* Index the nodes by link identifier in a hash table, so that looking
+ * up a node from its address does not walk the whole node list */
+#ifdef UIP_SR_CONF_WITH_HASH
+#define UIP_SR_WITH_HASH              UIP_SR_CONF_WITH_HASH
+#else /* UIP_SR_CONF_WITH_HASH */
+#define UIP_SR_WITH_HASH              0
+#endif /* UIP_SR_CONF_WITH_HASH */
+
+/* Number of buckets in the node hash table */
+#ifdef UIP_SR_CONF_HASH_SIZE
+#define UIP_SR_HASH_SIZE              UIP_SR_CONF_HASH_SIZE
+#else /* UIP_SR_CONF_HASH_SIZE */
+#define UIP_SR_HASH_SIZE              UIP_SR_LINK_NUM
+#endif /* UIP_SR_CONF_HASH_SIZE */
+
+/* Cache the path length from each node to the root, so that
+ * reachability checks do not walk the path again until the graph
+ * changes */
+#ifdef UIP_SR_CONF_PATH_CACHE
+#define UIP_SR_PATH_CACHE             UIP_SR_CONF_PATH_CACHE
+#else /* UIP_SR_CONF_PATH_CACHE */
+#define UIP_SR_PATH_CACHE             0
+#endif /* UIP_SR_CONF_PATH_CACHE */
+
 /********** Data Structures  **********/
 
 /** \brief A node in a source routing graph, stored at the root and representing
@@ -98,6 +122,16 @@ typedef struct uip_sr_node {
   us with the prefix */
   unsigned char link_identifier[8];
   struct uip_sr_node *parent;
+#if UIP_SR_WITH_HASH
+  /* Next node in the same hash bucket */
+  struct uip_sr_node *hash_next;
+#endif /* UIP_SR_WITH_HASH */
+#if UIP_SR_PATH_CACHE
+  /* Graph version for which path_len is valid */
+  uint16_t path_version;
+  /* Number of hops to the root, or -1 if unreachable */
+  int16_t path_len;
+#endif /* UIP_SR_PATH_CACHE */
 } uip_sr_node_t;
 
 /********** Public functions **********/
@@ -165,6 +199,17 @@ uip_sr_node_t *uip_sr_get_node(const void *graph, const uip_ipaddr_t *addr);
  */
 int uip_sr_is_addr_reachable(const void *graph, const uip_ipaddr_t *addr);
 
+/**
+ * Tells the number of hops from a node to the root. With
+ * UIP_SR_CONF_PATH_CACHE, the result is cached until the graph changes.
+ *
+ * \param node The node
+ * \param root_node The root node of the graph
+ * \return The number of hops, or -1 if there is no path from the node
+ * to the root
+ */
+int uip_sr_path_length(uip_sr_node_t *node, const uip_sr_node_t *root_node);
+
 /**
  * A function called periodically. Used to age the links (decrease lifetime
  * and expire links accordingly)
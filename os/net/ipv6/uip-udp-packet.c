@@ -48,13 +48,12 @@ extern uint16_t uip_slen;
 
 /*---------------------------------------------------------------------------*/
 void
-uip_udp_packet_send(struct uip_udp_conn *c, const void *data, int len)
+uip_udp_packet_sendv(struct uip_udp_conn *c, const struct uip_iov *iov,
+                     int iovcnt)
 {
 #if UIP_UDP
-  if(data != NULL && len <= (UIP_BUFSIZE - UIP_IPUDPH_LEN)) {
+  if(uip_udp_gather(iov, iovcnt) >= 0) {
     uip_udp_conn = c;
-    uip_slen = len;
-    memmove(&uip_buf[UIP_IPUDPH_LEN], data, len);
     uip_process(UIP_UDP_SEND_CONN);
 
 #if UIP_IPV6_MULTICAST
@@ -77,8 +76,21 @@ uip_udp_packet_send(struct uip_udp_conn *c, const void *data, int len)
 }
 /*---------------------------------------------------------------------------*/
 void
-uip_udp_packet_sendto(struct uip_udp_conn *c, const void *data, int len,
-		      const uip_ipaddr_t *toaddr, uint16_t toport)
+uip_udp_packet_send(struct uip_udp_conn *c, const void *data, int len)
+{
+  struct uip_iov iov;
+
+  if(data != NULL && len <= (UIP_BUFSIZE - UIP_IPUDPH_LEN)) {
+    iov.data = data;
+    iov.len = len;
+    uip_udp_packet_sendv(c, &iov, 1);
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+uip_udp_packet_sendtov(struct uip_udp_conn *c, const struct uip_iov *iov,
+                       int iovcnt, const uip_ipaddr_t *toaddr,
+                       uint16_t toport)
 {
   uip_ipaddr_t curaddr;
   uint16_t curport;
@@ -92,7 +104,7 @@ uip_udp_packet_sendto(struct uip_udp_conn *c, const void *data, int len,
     uip_ipaddr_copy(&c->ripaddr, toaddr);
     c->rport = toport;
 
-    uip_udp_packet_send(c, data, len);
+    uip_udp_packet_sendv(c, iov, iovcnt);
 
     /* Restore old IP addr/port */
     uip_ipaddr_copy(&c->ripaddr, &curaddr);
@@ -100,3 +112,16 @@ uip_udp_packet_sendto(struct uip_udp_conn *c, const void *data, int len,
   }
 }
 /*---------------------------------------------------------------------------*/
+void
+uip_udp_packet_sendto(struct uip_udp_conn *c, const void *data, int len,
+		      const uip_ipaddr_t *toaddr, uint16_t toport)
+{
+  struct uip_iov iov;
+
+  if(data != NULL && len <= (UIP_BUFSIZE - UIP_IPUDPH_LEN)) {
+    iov.data = data;
+    iov.len = len;
+    uip_udp_packet_sendtov(c, &iov, 1, toaddr, toport);
+  }
+}
+/*---------------------------------------------------------------------------*/
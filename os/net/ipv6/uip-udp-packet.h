@@ -46,4 +46,12 @@ void uip_udp_packet_send(struct uip_udp_conn *c, const void *data, int len);
 void uip_udp_packet_sendto(struct uip_udp_conn *c, const void *data, int len,
 			   const uip_ipaddr_t *toaddr, uint16_t toport);
 
+/* Send a datagram whose payload is gathered from several fragments,
+   see uip_udp_gather() */
+void uip_udp_packet_sendv(struct uip_udp_conn *c, const struct uip_iov *iov,
+                          int iovcnt);
+void uip_udp_packet_sendtov(struct uip_udp_conn *c, const struct uip_iov *iov,
+                            int iovcnt, const uip_ipaddr_t *toaddr,
+                            uint16_t toport);
+
 #endif /* UIP_UDP_PACKET_H_ */
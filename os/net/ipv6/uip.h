@@ -815,7 +815,11 @@ struct uip_udp_conn *uip_udp_new(const uip_ipaddr_t *ripaddr, uint16_t rport);
  *
  * \hideinitializer
  */
+#if UIP_CONN_HASH_SIZE
+#define uip_udp_remove(conn) uip_udp_set_lport(conn, 0)
+#else /* UIP_CONN_HASH_SIZE */
 #define uip_udp_remove(conn) (conn)->lport = 0
+#endif /* UIP_CONN_HASH_SIZE */
 
 /**
  * Bind a UDP connection to a local port.
@@ -827,7 +831,24 @@ struct uip_udp_conn *uip_udp_new(const uip_ipaddr_t *ripaddr, uint16_t rport);
  *
  * \hideinitializer
  */
+#if UIP_CONN_HASH_SIZE
+#define uip_udp_bind(conn, port) uip_udp_set_lport(conn, port)
+#else /* UIP_CONN_HASH_SIZE */
 #define uip_udp_bind(conn, port) (conn)->lport = port
+#endif /* UIP_CONN_HASH_SIZE */
+
+/**
+ * Set the local port of a UDP connection, keeping the connection
+ * index up to date. Used by uip_udp_bind() and uip_udp_remove() when
+ * the index is enabled with UIP_CONF_CONN_HASH_SIZE.
+ *
+ * \param conn A pointer to the uip_udp_conn structure for the
+ * connection.
+ *
+ * \param port The local port number, in network byte order, or 0 to
+ * remove the connection.
+ */
+void uip_udp_set_lport(struct uip_udp_conn *conn, uint16_t port);
 
 /**
  * Send a UDP datagram of length len on the current connection.
@@ -842,6 +863,35 @@ struct uip_udp_conn *uip_udp_new(const uip_ipaddr_t *ripaddr, uint16_t rport);
  */
 #define uip_udp_send(len) uip_send((char *)uip_appdata, len)
 
+/**
+ * A fragment of the payload of a datagram sent from several buffers.
+ */
+struct uip_iov {
+  const void *data;
+  uint16_t len;
+};
+
+/**
+ * Gather the payload of the next UDP datagram into uip_buf.
+ *
+ * The fragments are copied in order behind the space for the IP and
+ * UDP headers and uip_slen is set to their total length. The checksum
+ * of the payload is summed while copying, so that it does not have to
+ * be summed again when the datagram is sent with
+ * uip_process(UIP_UDP_SEND_CONN).
+ *
+ * A fragment may already be at its place in uip_buf; no other
+ * fragment may point into uip_buf.
+ *
+ * \param iov The fragments of the payload.
+ *
+ * \param iovcnt The number of fragments.
+ *
+ * \return The length of the payload, or -1 if it does not fit in
+ * uip_buf.
+ */
+int uip_udp_gather(const struct uip_iov *iov, int iovcnt);
+
 
 /** @} */
 
@@ -2010,6 +2060,28 @@ uint16_t uip_udpchksum(void);
  */
 uint16_t uip_icmp6chksum(void);
 
+/**
+ * Copy data into uip_buf, computing its Internet checksum on the way.
+ *
+ * The sum is remembered until the next TCP, UDP or ICMPv6 checksum is
+ * calculated. If the copied data ends the message that checksum is
+ * taken over, it is reused instead of reading the data again.
+ *
+ * \param offset The offset in uip_buf to copy the data to.
+ * \param data The data, which may itself lie in uip_buf.
+ * \param len The length of the data.
+ */
+void uip_copy_chksum(uint16_t offset, const void *data, uint16_t len);
+
+/**
+ * Drop the sum remembered by uip_copy_chksum().
+ *
+ * Must be called by code that hands uip_buf to the stack after
+ * uip_copy_chksum() once the stack is done with it, in case the packet
+ * was consumed without its checksum being calculated.
+ */
+void uip_forget_chksum(void);
+
 /**
  * Removes all IPv6 extension headers from uip_buf, updates length fields
  * (uip_len and uip_ext_len)
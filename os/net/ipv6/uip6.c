@@ -229,9 +229,187 @@ uint8_t uip_acc32[4];
 #if UIP_UDP
 struct uip_udp_conn *uip_udp_conn;
 struct uip_udp_conn uip_udp_conns[UIP_UDP_CONNS];
+
 #endif /* UIP_UDP */
 /** @} */
 
+/*---------------------------------------------------------------------------*/
+/**
+ * \name Connection index
+ * @{
+ */
+/*---------------------------------------------------------------------------*/
+#if UIP_CONN_HASH_SIZE
+#if UIP_CONN_HASH_SIZE & (UIP_CONN_HASH_SIZE - 1)
+#error UIP_CONF_CONN_HASH_SIZE must be a power of two
+#endif
+
+/* The connections are chained by index per bucket, in table order, so
+   that the first match is the same as with a scan of the table. */
+#define CONN_HASH_END 0xffff
+#define CONN_HASH(port) (((port) ^ ((port) >> 8)) & (UIP_CONN_HASH_SIZE - 1))
+
+#if UIP_TCP
+static uint16_t tcp_hash_head[UIP_CONN_HASH_SIZE];
+static uint16_t tcp_hash_next[UIP_TCP_CONNS];
+#endif /* UIP_TCP */
+#if UIP_UDP
+static uint16_t udp_hash_head[UIP_CONN_HASH_SIZE];
+static uint16_t udp_hash_next[UIP_UDP_CONNS];
+#endif /* UIP_UDP */
+/*---------------------------------------------------------------------------*/
+static void
+conn_hash_insert(uint16_t *head, uint16_t *next, uint16_t port, uint16_t c)
+{
+  uint16_t *p;
+
+  for(p = &head[CONN_HASH(port)]; *p != CONN_HASH_END && *p < c;
+      p = &next[*p]);
+  next[c] = *p;
+  *p = c;
+}
+/*---------------------------------------------------------------------------*/
+static void
+conn_hash_remove(uint16_t *head, uint16_t *next, uint16_t port, uint16_t c)
+{
+  uint16_t *p;
+
+  for(p = &head[CONN_HASH(port)]; *p != CONN_HASH_END; p = &next[*p]) {
+    if(*p == c) {
+      *p = next[c];
+      return;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+conn_hash_init(void)
+{
+  int c;
+
+  for(c = 0; c < UIP_CONN_HASH_SIZE; c++) {
+#if UIP_TCP
+    tcp_hash_head[c] = CONN_HASH_END;
+#endif /* UIP_TCP */
+#if UIP_UDP
+    udp_hash_head[c] = CONN_HASH_END;
+#endif /* UIP_UDP */
+  }
+}
+/*---------------------------------------------------------------------------*/
+#if UIP_TCP
+/* Give a TCP connection a new local port. Closed connections stay in
+   the index until they are reused. */
+static void
+tcp_conn_set_lport(struct uip_conn *conn, uint16_t port)
+{
+  uint16_t c = conn - uip_conns;
+
+  if(conn->lport != 0) {
+    conn_hash_remove(tcp_hash_head, tcp_hash_next, conn->lport, c);
+  }
+  conn->lport = port;
+  conn_hash_insert(tcp_hash_head, tcp_hash_next, port, c);
+}
+/*---------------------------------------------------------------------------*/
+static struct uip_conn *
+tcp_conn_lookup(uint16_t lport, uint16_t rport, const uip_ipaddr_t *ripaddr)
+{
+  struct uip_conn *conn;
+  uint16_t c;
+
+  for(c = tcp_hash_head[CONN_HASH(lport)]; c != CONN_HASH_END;
+      c = tcp_hash_next[c]) {
+    conn = &uip_conns[c];
+    if(conn->tcpstateflags != UIP_CLOSED &&
+       conn->lport == lport &&
+       conn->rport == rport &&
+       uip_ipaddr_cmp(ripaddr, &conn->ripaddr)) {
+      return conn;
+    }
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+#if UIP_ACTIVE_OPEN
+static int
+tcp_lport_used(uint16_t lport)
+{
+  uint16_t c;
+
+  for(c = tcp_hash_head[CONN_HASH(lport)]; c != CONN_HASH_END;
+      c = tcp_hash_next[c]) {
+    if(uip_conns[c].tcpstateflags != UIP_CLOSED &&
+       uip_conns[c].lport == lport) {
+      return 1;
+    }
+  }
+  return 0;
+}
+#endif /* UIP_ACTIVE_OPEN */
+#endif /* UIP_TCP */
+/*---------------------------------------------------------------------------*/
+#if UIP_UDP
+void
+uip_udp_set_lport(struct uip_udp_conn *conn, uint16_t port)
+{
+  uint16_t c = conn - uip_udp_conns;
+
+  if(conn->lport != 0) {
+    conn_hash_remove(udp_hash_head, udp_hash_next, conn->lport, c);
+  }
+  conn->lport = port;
+  if(port != 0) {
+    conn_hash_insert(udp_hash_head, udp_hash_next, port, c);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Find the connection for a datagram, preferring one bound to its
+   source over one accepting any source */
+static struct uip_udp_conn *
+udp_conn_lookup(uint16_t lport, uint16_t rport, const uip_ipaddr_t *ripaddr)
+{
+  struct uip_udp_conn *conn, *wildcard;
+  uint16_t c;
+
+  wildcard = NULL;
+  for(c = udp_hash_head[CONN_HASH(lport)]; c != CONN_HASH_END;
+      c = udp_hash_next[c]) {
+    conn = &uip_udp_conns[c];
+    if(conn->lport != lport) {
+      continue;
+    }
+    if(conn->rport == rport &&
+       uip_ipaddr_cmp(ripaddr, &conn->ripaddr)) {
+      return conn;
+    }
+    if(wildcard == NULL &&
+       (conn->rport == 0 || conn->rport == rport) &&
+       (uip_is_addr_unspecified(&conn->ripaddr) ||
+        uip_ipaddr_cmp(ripaddr, &conn->ripaddr))) {
+      wildcard = conn;
+    }
+  }
+  return wildcard;
+}
+/*---------------------------------------------------------------------------*/
+static int
+udp_lport_used(uint16_t lport)
+{
+  uint16_t c;
+
+  for(c = udp_hash_head[CONN_HASH(lport)]; c != CONN_HASH_END;
+      c = udp_hash_next[c]) {
+    if(uip_udp_conns[c].lport == lport) {
+      return 1;
+    }
+  }
+  return 0;
+}
+#endif /* UIP_UDP */
+#endif /* UIP_CONN_HASH_SIZE */
+/** @} */
+
 /*---------------------------------------------------------------------------*/
 /**
  * \name ICMPv6 variables
@@ -277,10 +455,49 @@ uip_add32(uint8_t *op32, uint16_t op16)
 #endif /* UIP_TCP */
 
 #if ! UIP_ARCH_CHKSUM
+/* Sum of a run of uip_buf computed by uip_copy_chksum(), valid until
+   the next upper-layer checksum or until copy_sum_len is reset */
+#define COPY_SUM_NONE 0xffff
+static uint16_t copy_sum;
+static uint16_t copy_sum_off;
+static uint16_t copy_sum_len = COPY_SUM_NONE;
+
+#if UIP_CHKSUM_WORD == 4
+typedef uint32_t chksum_word_t;
+typedef uint64_t chksum_acc_t;
+#elif UIP_CHKSUM_WORD == 2
+typedef uint16_t chksum_word_t;
+typedef uint32_t chksum_acc_t;
+#endif /* UIP_CHKSUM_WORD */
 /*---------------------------------------------------------------------------*/
 static uint16_t
-chksum(uint16_t sum, const uint8_t *data, uint16_t len)
+chksum_add(uint16_t sum, uint16_t t)
 {
+  sum += t;
+  if(sum < t) {
+    sum++;      /* carry */
+  }
+  return sum;
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * Sum data, copying it to dst on the way unless dst is NULL. The copy
+ * is done word by word, so dst may overlap data only if it comes
+ * first.
+ */
+static uint16_t
+chksum_copy(uint16_t sum, uint8_t *dst, const uint8_t *data, uint16_t len)
+{
+#if defined(UIP_ARCH_CHKSUM_ADD) || UIP_CHKSUM_WORD == 1
+  if(dst != NULL) {
+    memmove(dst, data, len);
+    data = dst;
+  }
+#endif
+
+#ifdef UIP_ARCH_CHKSUM_ADD
+  return uip_arch_chksum_add(sum, data, len);
+#elif UIP_CHKSUM_WORD == 1
   uint16_t t;
   const uint8_t *dataptr;
   const uint8_t *last_byte;
@@ -307,6 +524,96 @@ chksum(uint16_t sum, const uint8_t *data, uint16_t len)
 
   /* Return sum in host byte order. */
   return sum;
+#else
+  chksum_word_t w[4];
+  chksum_acc_t acc;
+  uint16_t t;
+
+  /*
+   * Sum whole words in CPU byte order, leaving the carries in the upper
+   * half of the accumulator. The one's complement sum does not depend
+   * on byte order (RFC 1071), so only the folded result is swapped.
+   * memcpy() makes the loads safe for any alignment of the data.
+   */
+  acc = 0;
+  while(len >= sizeof(w)) {
+    memcpy(w, data, sizeof(w));
+    if(dst != NULL) {
+      memcpy(dst, w, sizeof(w));
+      dst += sizeof(w);
+    }
+    acc += (chksum_acc_t)w[0] + w[1] + w[2] + w[3];
+    data += sizeof(w);
+    len -= sizeof(w);
+  }
+  while(len >= sizeof(w[0])) {
+    memcpy(w, data, sizeof(w[0]));
+    if(dst != NULL) {
+      memcpy(dst, w, sizeof(w[0]));
+      dst += sizeof(w[0]);
+    }
+    acc += w[0];
+    data += sizeof(w[0]);
+    len -= sizeof(w[0]);
+  }
+
+  while(acc >> 16) {
+    acc = (acc & 0xffff) + (acc >> 16);
+  }
+  t = (uint16_t)acc;
+#if UIP_BYTE_ORDER == UIP_LITTLE_ENDIAN
+  t = (t << 8) | (t >> 8);
+#endif /* UIP_BYTE_ORDER == UIP_LITTLE_ENDIAN */
+  sum = chksum_add(sum, t);
+
+  /* At most three bytes are left */
+  if(len >= 2) {
+    sum = chksum_add(sum, (data[0] << 8) + data[1]);
+  }
+  if(len & 1) {
+    sum = chksum_add(sum, data[len - 1] << 8);
+  }
+  if(dst != NULL) {
+    memmove(dst, data, len);
+  }
+
+  /* Return sum in host byte order. */
+  return sum;
+#endif /* UIP_CHKSUM_WORD */
+}
+/*---------------------------------------------------------------------------*/
+static uint16_t
+chksum(uint16_t sum, const uint8_t *data, uint16_t len)
+{
+  return chksum_copy(sum, NULL, data, len);
+}
+/*---------------------------------------------------------------------------*/
+/* Copy data to dst, which may overlap it, and return the sum of it */
+static uint16_t
+copy_chksum(uint8_t *dst, const uint8_t *data, uint16_t len)
+{
+  if(dst == data) {
+    return chksum(0, dst, len);
+  }
+  if(dst > data && dst < data + len) {
+    memmove(dst, data, len);
+    return chksum(0, dst, len);
+  }
+  return chksum_copy(0, dst, data, len);
+}
+/*---------------------------------------------------------------------------*/
+void
+uip_copy_chksum(uint16_t offset, const void *data, uint16_t len)
+{
+  copy_sum = copy_chksum(&uip_buf[offset], data, len);
+  copy_sum_off = offset;
+  copy_sum_len = len;
+}
+/*---------------------------------------------------------------------------*/
+void
+uip_forget_chksum(void)
+{
+  copy_sum_len = COPY_SUM_NONE;
 }
 /*---------------------------------------------------------------------------*/
 uint16_t
@@ -341,6 +648,7 @@ upper_layer_chksum(uint8_t proto)
  */
   volatile uint16_t upper_layer_len;
   uint16_t sum;
+  uint16_t head_len;
 
   upper_layer_len = uipbuf_get_len_field(UIP_IP_BUF) - uip_ext_len;
 
@@ -353,8 +661,21 @@ upper_layer_chksum(uint8_t proto)
   /* Sum IP source and destination addresses. */
   sum = chksum(sum, (uint8_t *)&UIP_IP_BUF->srcipaddr, 2 * sizeof(uip_ipaddr_t));
 
-  /* Sum upper-layer header and data. */
-  sum = chksum(sum, UIP_IP_PAYLOAD(uip_ext_len), upper_layer_len);
+  /* Sum upper-layer header and data. If the data at the end was summed
+     when it was copied in, only the part before it is read here. */
+  head_len = copy_sum_off - (UIP_IPH_LEN + uip_ext_len);
+  if(copy_sum_len != COPY_SUM_NONE &&
+     copy_sum_off >= UIP_IPH_LEN + uip_ext_len &&
+     head_len + copy_sum_len == upper_layer_len) {
+    sum = chksum(sum, UIP_IP_PAYLOAD(uip_ext_len), head_len);
+    if(head_len & 1) {
+      copy_sum = (copy_sum << 8) | (copy_sum >> 8);
+    }
+    sum = chksum_add(sum, copy_sum);
+  } else {
+    sum = chksum(sum, UIP_IP_PAYLOAD(uip_ext_len), upper_layer_len);
+  }
+  copy_sum_len = COPY_SUM_NONE;
 
   return (sum == 0) ? 0xffff : uip_htons(sum);
 }
@@ -381,6 +702,18 @@ uip_udpchksum(void)
   return upper_layer_chksum(UIP_PROTO_UDP);
 }
 #endif /* UIP_UDP && UIP_UDP_CHECKSUMS */
+#else /* UIP_ARCH_CHKSUM */
+/*---------------------------------------------------------------------------*/
+void
+uip_copy_chksum(uint16_t offset, const void *data, uint16_t len)
+{
+  memmove(&uip_buf[offset], data, len);
+}
+/*---------------------------------------------------------------------------*/
+void
+uip_forget_chksum(void)
+{
+}
 #endif /* UIP_ARCH_CHKSUM */
 /*---------------------------------------------------------------------------*/
 void
@@ -399,6 +732,9 @@ uip_init(void)
   }
   for(c = 0; c < UIP_TCP_CONNS; ++c) {
     uip_conns[c].tcpstateflags = UIP_CLOSED;
+#if UIP_CONN_HASH_SIZE
+    uip_conns[c].lport = 0;
+#endif /* UIP_CONN_HASH_SIZE */
   }
 #endif /* UIP_TCP */
 
@@ -406,6 +742,10 @@ uip_init(void)
   lastport = 1024;
 #endif /* UIP_ACTIVE_OPEN || UIP_UDP */
 
+#if UIP_CONN_HASH_SIZE
+  conn_hash_init();
+#endif /* UIP_CONN_HASH_SIZE */
+
 #if UIP_UDP
   for(c = 0; c < UIP_UDP_CONNS; ++c) {
     uip_udp_conns[c].lport = 0;
@@ -434,6 +774,11 @@ uip_connect(const uip_ipaddr_t *ripaddr, uint16_t rport)
 
   /* Check if this port is already in use, and if so try to find
      another one. */
+#if UIP_CONN_HASH_SIZE
+  if(tcp_lport_used(uip_htons(lastport))) {
+    goto again;
+  }
+#else /* UIP_CONN_HASH_SIZE */
   for(c = 0; c < UIP_TCP_CONNS; ++c) {
     conn = &uip_conns[c];
     if(conn->tcpstateflags != UIP_CLOSED &&
@@ -441,6 +786,7 @@ uip_connect(const uip_ipaddr_t *ripaddr, uint16_t rport)
       goto again;
     }
   }
+#endif /* UIP_CONN_HASH_SIZE */
 
   conn = 0;
   for(c = 0; c < UIP_TCP_CONNS; ++c) {
@@ -481,7 +827,11 @@ uip_connect(const uip_ipaddr_t *ripaddr, uint16_t rport)
   conn->rto = UIP_RTO;
   conn->sa = 0;
   conn->sv = 16;   /* Initial value of the RTT variance. */
+#if UIP_CONN_HASH_SIZE
+  tcp_conn_set_lport(conn, uip_htons(lastport));
+#else /* UIP_CONN_HASH_SIZE */
   conn->lport = uip_htons(lastport);
+#endif /* UIP_CONN_HASH_SIZE */
   conn->rport = rport;
   uip_ipaddr_copy(&conn->ripaddr, ripaddr);
 
@@ -505,6 +855,7 @@ uip_remove_ext_hdr(void)
     /* Set proto */
     UIP_IP_BUF->proto = uip_last_proto;
     /* Move IP payload to the "left"*/
+    uip_forget_chksum();
     memmove(UIP_IP_PAYLOAD(0), UIP_IP_PAYLOAD(uip_ext_len),
 	    uip_len - UIP_IPH_LEN - uip_ext_len);
 
@@ -532,11 +883,17 @@ uip_udp_new(const uip_ipaddr_t *ripaddr, uint16_t rport)
     lastport = 4096;
   }
 
+#if UIP_CONN_HASH_SIZE
+  if(udp_lport_used(uip_htons(lastport))) {
+    goto again;
+  }
+#else /* UIP_CONN_HASH_SIZE */
   for(c = 0; c < UIP_UDP_CONNS; ++c) {
     if(uip_udp_conns[c].lport == uip_htons(lastport)) {
       goto again;
     }
   }
+#endif /* UIP_CONN_HASH_SIZE */
 
   conn = 0;
   for(c = 0; c < UIP_UDP_CONNS; ++c) {
@@ -550,7 +907,7 @@ uip_udp_new(const uip_ipaddr_t *ripaddr, uint16_t rport)
     return 0;
   }
 
-  conn->lport = UIP_HTONS(lastport);
+  uip_udp_bind(conn, UIP_HTONS(lastport));
   conn->rport = rport;
   if(ripaddr == NULL) {
     memset(&conn->ripaddr, 0, sizeof(uip_ipaddr_t));
@@ -563,6 +920,52 @@ uip_udp_new(const uip_ipaddr_t *ripaddr, uint16_t rport)
 }
 #endif /* UIP_UDP */
 /*---------------------------------------------------------------------------*/
+#if UIP_UDP
+int
+uip_udp_gather(const struct uip_iov *iov, int iovcnt)
+{
+  uint8_t *payload = &uip_buf[UIP_IPUDPH_LEN];
+  uint16_t len;
+  int i;
+#if UIP_UDP_CHECKSUMS && !UIP_ARCH_CHKSUM
+  uint16_t sum, t;
+
+  sum = 0;
+  copy_sum_len = COPY_SUM_NONE;
+#endif /* UIP_UDP_CHECKSUMS && !UIP_ARCH_CHKSUM */
+
+  len = 0;
+  for(i = 0; i < iovcnt; i++) {
+    if(iov[i].len > UIP_BUFSIZE - UIP_IPUDPH_LEN - len) {
+      uip_slen = 0;
+      return -1;
+    }
+#if UIP_UDP_CHECKSUMS && !UIP_ARCH_CHKSUM
+    /* Sum each fragment while copying it. A fragment starting at an
+       odd offset has its sum byte-swapped. */
+    t = copy_chksum(payload + len, iov[i].data, iov[i].len);
+    if(len & 1) {
+      t = (t << 8) | (t >> 8);
+    }
+    sum = chksum_add(sum, t);
+#else /* UIP_UDP_CHECKSUMS && !UIP_ARCH_CHKSUM */
+    if(iov[i].data != payload + len) {
+      memmove(payload + len, iov[i].data, iov[i].len);
+    }
+#endif /* UIP_UDP_CHECKSUMS && !UIP_ARCH_CHKSUM */
+    len += iov[i].len;
+  }
+
+  uip_slen = len;
+#if UIP_UDP_CHECKSUMS && !UIP_ARCH_CHKSUM
+  copy_sum = sum;
+  copy_sum_off = UIP_IPUDPH_LEN;
+  copy_sum_len = len;
+#endif /* UIP_UDP_CHECKSUMS && !UIP_ARCH_CHKSUM */
+  return len;
+}
+#endif /* UIP_UDP */
+/*---------------------------------------------------------------------------*/
 #if UIP_TCP
 void
 uip_unlisten(uint16_t port)
@@ -634,6 +1037,9 @@ uip_reass(uint8_t *prev_proto_ptr)
   uint16_t i;
   struct uip_frag_hdr *frag_buf = (struct uip_frag_hdr *)UIP_IP_PAYLOAD(uip_ext_len);
 
+  /* The fragment is moved out of uip_buf */
+  uip_forget_chksum();
+
   /* If ip_reasstmr is zero, no packet is present in the buffer */
   /* We first write the unfragmentable part of IP header into the reassembly
      buffer. The reset the other reassembly variables. */
@@ -1454,6 +1860,9 @@ uip_process(uint8_t flag)
     goto drop;
   }
 #endif /*UIP_CONF_IPV6_CHECKS*/
+  /* Forget the sum of the payload copied in even if it was not checked,
+     as replies such as echo replies are written over the packet */
+  uip_forget_chksum();
 
   UIP_STAT(++uip_stat.icmp.recv);
   /*
@@ -1515,6 +1924,9 @@ uip_process(uint8_t flag)
     goto drop;
   }
 #endif /* UIP_UDP_CHECKSUMS */
+  /* The check is skipped for a zero checksum, which leaves the sum of
+     the payload copied in for the application to reply with */
+  uip_forget_chksum();
 
   /* Make sure that the UDP destination port number is not zero. */
   if(UIP_UDP_BUF->destport == 0) {
@@ -1523,6 +1935,13 @@ uip_process(uint8_t flag)
   }
 
   /* Demultiplex this UDP packet between the UDP "connections". */
+#if UIP_CONN_HASH_SIZE
+  uip_udp_conn = udp_conn_lookup(UIP_UDP_BUF->destport, UIP_UDP_BUF->srcport,
+                                 &UIP_IP_BUF->srcipaddr);
+  if(uip_udp_conn != NULL) {
+    goto udp_found;
+  }
+#else /* UIP_CONN_HASH_SIZE */
   for(uip_udp_conn = &uip_udp_conns[0];
       uip_udp_conn < &uip_udp_conns[UIP_UDP_CONNS];
       ++uip_udp_conn) {
@@ -1542,6 +1961,7 @@ uip_process(uint8_t flag)
       goto udp_found;
     }
   }
+#endif /* UIP_CONN_HASH_SIZE */
   LOG_ERR("udp: no matching connection found\n");
   UIP_STAT(++uip_stat.udp.drop);
 
@@ -1627,6 +2047,13 @@ uip_process(uint8_t flag)
 
   /* Demultiplex this segment. */
   /* First check any active connections. */
+#if UIP_CONN_HASH_SIZE
+  uip_connr = tcp_conn_lookup(UIP_TCP_BUF->destport, UIP_TCP_BUF->srcport,
+                              &UIP_IP_BUF->srcipaddr);
+  if(uip_connr != NULL) {
+    goto found;
+  }
+#else /* UIP_CONN_HASH_SIZE */
   for(uip_connr = &uip_conns[0]; uip_connr <= &uip_conns[UIP_TCP_CONNS - 1];
       ++uip_connr) {
     if(uip_connr->tcpstateflags != UIP_CLOSED &&
@@ -1636,6 +2063,7 @@ uip_process(uint8_t flag)
       goto found;
     }
   }
+#endif /* UIP_CONN_HASH_SIZE */
 
   /* If we didn't find and active connection that expected the packet,
      either this packet is an old duplicate, or this is a SYN packet
@@ -1748,7 +2176,11 @@ uip_process(uint8_t flag)
   uip_connr->sa = 0;
   uip_connr->sv = 4;
   uip_connr->nrtx = 0;
+#if UIP_CONN_HASH_SIZE
+  tcp_conn_set_lport(uip_connr, UIP_TCP_BUF->destport);
+#else /* UIP_CONN_HASH_SIZE */
   uip_connr->lport = UIP_TCP_BUF->destport;
+#endif /* UIP_CONN_HASH_SIZE */
   uip_connr->rport = UIP_TCP_BUF->srcport;
   uip_ipaddr_copy(&uip_connr->ripaddr, &UIP_IP_BUF->srcipaddr);
   uip_connr->tcpstateflags = UIP_SYN_RCVD;
@@ -2330,6 +2762,7 @@ uip_process(uint8_t flag)
   UIP_IP_BUF->flow = 0x00;
   send:
   LOG_INFO("Sending packet with length %d (%d)\n", uip_len, uipbuf_get_len_field(UIP_IP_BUF));
+  uip_forget_chksum();
 
   UIP_STAT(++uip_stat.ip.sent);
   /* Return and let the caller do the actual transmission. */
@@ -2337,6 +2770,7 @@ uip_process(uint8_t flag)
   return;
 
   drop:
+  uip_forget_chksum();
   uipbuf_clear();
   uip_ext_bitmap = 0;
   uip_flags = 0;
@@ -2369,10 +2803,11 @@ uip_send(const void *data, int len)
   if(copylen > 0) {
     uip_slen = copylen;
     if(data != uip_sappdata) {
+      /* Sum the data while copying it, for the TCP checksum. */
       if(uip_sappdata == NULL) {
-        memcpy(UIP_TCP_PAYLOAD, (data), uip_slen);
+        uip_copy_chksum(UIP_TCP_PAYLOAD - uip_buf, data, uip_slen);
       } else {
-        memcpy(uip_sappdata, (data), uip_slen);
+        uip_copy_chksum((uint8_t *)uip_sappdata - uip_buf, data, uip_slen);
       }
     }
   }
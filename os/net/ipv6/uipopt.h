@@ -249,6 +249,26 @@ void uip_log(char *msg);
 #define UIP_UDP_CONNS    10
 #endif /* UIP_CONF_UDP_CONNS */
 
+/**
+ * The number of buckets of the index of the UDP and TCP connections
+ * by local port. With the index, incoming datagrams and segments are
+ * matched against the connections bound to their destination port
+ * only, instead of scanning all connections, which pays off when
+ * UIP_UDP_CONNS or UIP_TCP_CONNS are large. A UDP connection bound to
+ * the source address and port of a datagram is preferred over one
+ * accepting any source. Must be a power of two, 0 disables the index.
+ *
+ * With the index enabled, the local port of a UDP connection must
+ * only be changed with uip_udp_bind() and uip_udp_remove().
+ *
+ * \hideinitializer
+ */
+#ifdef UIP_CONF_CONN_HASH_SIZE
+#define UIP_CONN_HASH_SIZE (UIP_CONF_CONN_HASH_SIZE)
+#else /* UIP_CONF_CONN_HASH_SIZE */
+#define UIP_CONN_HASH_SIZE 0
+#endif /* UIP_CONF_CONN_HASH_SIZE */
+
 /**
  * The name of the function that should be called when UDP datagrams arrive.
  *
@@ -531,6 +551,25 @@ void uip_log(char *msg);
 #define UIP_BYTE_ORDER     (UIP_LITTLE_ENDIAN)
 #endif /* UIP_CONF_BYTE_ORDER */
 
+/**
+ * The number of bytes the Internet checksum loads at a time.
+ *
+ * With 4, 32-bit words are summed into a 64-bit accumulator; with 2,
+ * 16-bit words are summed into a 32-bit accumulator. Either way the
+ * carries are only folded once at the end. CPUs without cheap 32-bit
+ * arithmetic should use 2, and 1 selects the original byte-pair loop.
+ *
+ * A platform may instead provide its own kernel by defining
+ * UIP_ARCH_CHKSUM_ADD and implementing uip_arch_chksum_add().
+ *
+ * \hideinitializer
+ */
+#ifdef UIP_CONF_CHKSUM_WORD
+#define UIP_CHKSUM_WORD    (UIP_CONF_CHKSUM_WORD)
+#else /* UIP_CONF_CHKSUM_WORD */
+#define UIP_CHKSUM_WORD    4
+#endif /* UIP_CONF_CHKSUM_WORD */
+
 /** @} */
 /*------------------------------------------------------------------------------*/
 
@@ -40,6 +40,7 @@
  */
 
 #include "net/mac/csma/csma.h"
+#include "net/mac/csma/csma-output.h"
 #include "net/mac/csma/csma-security.h"
 #include "net/packetbuf.h"
 #include "net/queuebuf.h"
@@ -94,13 +95,47 @@ struct qbuf_metadata {
   uint8_t max_transmissions;
 };
 
+/*
+ * With CSMA_CONF_WITH_DRR, the neighbor queues are served in deficit
+ * round robin order by a single transmission timer, instead of each
+ * neighbor transmitting on its own timer. A neighbor may also only
+ * queue a packet while its queue is shorter than CSMA_QUEUE_SHARE
+ * times the number of free packet buffers, so that a single busy
+ * neighbor cannot take all buffers from the others.
+ */
+#ifdef CSMA_CONF_WITH_DRR
+#define CSMA_WITH_DRR CSMA_CONF_WITH_DRR
+#else
+#define CSMA_WITH_DRR 0
+#endif /* CSMA_CONF_WITH_DRR */
+
+/* The number of bytes that a neighbor may send per round. Must be at
+   least the size of the largest packet. */
+#ifdef CSMA_CONF_DRR_QUANTUM
+#define CSMA_DRR_QUANTUM CSMA_CONF_DRR_QUANTUM
+#else
+#define CSMA_DRR_QUANTUM PACKETBUF_SIZE
+#endif /* CSMA_CONF_DRR_QUANTUM */
+
+#ifdef CSMA_CONF_QUEUE_SHARE
+#define CSMA_QUEUE_SHARE CSMA_CONF_QUEUE_SHARE
+#else
+#define CSMA_QUEUE_SHARE 2
+#endif /* CSMA_CONF_QUEUE_SHARE */
+
 /* Every neighbor has its own packet queue */
 struct neighbor_queue {
   struct neighbor_queue *next;
   linkaddr_t addr;
+#if CSMA_WITH_DRR
+  uint16_t deficit;
+  uint8_t in_round;
+#else /* CSMA_WITH_DRR */
   struct ctimer transmit_timer;
+#endif /* CSMA_WITH_DRR */
   uint8_t transmissions;
   uint8_t collisions;
+  uint16_t dropped;
   LIST_STRUCT(packet_queue);
 };
 
@@ -120,6 +155,22 @@ struct neighbor_queue {
 
 #define MAX_QUEUED_PACKETS QUEUEBUF_NUM
 
+/* Index the neighbor queues by link-layer address in an open-addressing
+   hash table, so that queuing a packet does not walk the neighbor list. */
+#ifdef CSMA_CONF_WITH_NEIGHBOR_HASH
+#define CSMA_WITH_NEIGHBOR_HASH CSMA_CONF_WITH_NEIGHBOR_HASH
+#else
+#define CSMA_WITH_NEIGHBOR_HASH 0
+#endif /* CSMA_CONF_WITH_NEIGHBOR_HASH */
+
+/* Number of slots in the hash table. Must be larger than
+   CSMA_MAX_NEIGHBOR_QUEUES. */
+#ifdef CSMA_CONF_NEIGHBOR_HASH_SIZE
+#define CSMA_NEIGHBOR_HASH_SIZE CSMA_CONF_NEIGHBOR_HASH_SIZE
+#else
+#define CSMA_NEIGHBOR_HASH_SIZE (2 * CSMA_MAX_NEIGHBOR_QUEUES)
+#endif /* CSMA_CONF_NEIGHBOR_HASH_SIZE */
+
 /* Neighbor packet queue */
 struct packet_queue {
   struct packet_queue *next;
@@ -132,15 +183,115 @@ MEMB(packet_memb, struct packet_queue, MAX_QUEUED_PACKETS);
 MEMB(metadata_memb, struct qbuf_metadata, MAX_QUEUED_PACKETS);
 LIST(neighbor_list);
 
+static struct csma_output_stats stats;
+
+#if CSMA_WITH_NEIGHBOR_HASH
+/* Each slot holds a neighbor queue index plus one, zero marks an
+   empty slot. */
+static uint16_t hash_slots[CSMA_NEIGHBOR_HASH_SIZE];
+#endif /* CSMA_WITH_NEIGHBOR_HASH */
+
+#if CSMA_WITH_DRR
+static struct ctimer transmit_timer;
+/* The neighbor whose turn it is in the current round */
+static struct neighbor_queue *drr_current;
+#endif /* CSMA_WITH_DRR */
+
 static void packet_sent(struct neighbor_queue *n,
     struct packet_queue *q,
     int status,
     int num_transmissions);
 static void transmit_from_queue(void *ptr);
 /*---------------------------------------------------------------------------*/
+#if CSMA_WITH_NEIGHBOR_HASH
+static unsigned
+hash_from_addr(const linkaddr_t *addr)
+{
+  uint32_t hash = 2166136261UL;
+  int i;
+
+  /* FNV-1a over the address bytes */
+  for(i = 0; i < LINKADDR_SIZE; i++) {
+    hash = (hash ^ addr->u8[i]) * 16777619UL;
+  }
+  return hash % CSMA_NEIGHBOR_HASH_SIZE;
+}
+/*---------------------------------------------------------------------------*/
+static uint16_t
+neighbor_index(const struct neighbor_queue *n)
+{
+  return n - (struct neighbor_queue *)neighbor_memb.mem;
+}
+/*---------------------------------------------------------------------------*/
+static struct neighbor_queue *
+neighbor_from_index(uint16_t index)
+{
+  return (struct neighbor_queue *)neighbor_memb.mem + index;
+}
+/*---------------------------------------------------------------------------*/
+/* Add a neighbor queue to the hash index. It must not already be indexed. */
+static void
+hash_add(const struct neighbor_queue *n)
+{
+  unsigned slot = hash_from_addr(&n->addr);
+
+  while(hash_slots[slot] != 0) {
+    slot = (slot + 1) % CSMA_NEIGHBOR_HASH_SIZE;
+  }
+  hash_slots[slot] = neighbor_index(n) + 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Remove a neighbor queue from the hash index, shifting back the
+   entries that follow it so that no probe sequence is broken */
+static void
+hash_remove(const struct neighbor_queue *n)
+{
+  unsigned slot = hash_from_addr(&n->addr);
+  unsigned next;
+  unsigned home;
+
+  while(hash_slots[slot] != neighbor_index(n) + 1) {
+    if(hash_slots[slot] == 0) {
+      /* Not indexed */
+      return;
+    }
+    slot = (slot + 1) % CSMA_NEIGHBOR_HASH_SIZE;
+  }
+
+  next = slot;
+  while(1) {
+    hash_slots[slot] = 0;
+    do {
+      next = (next + 1) % CSMA_NEIGHBOR_HASH_SIZE;
+      if(hash_slots[next] == 0) {
+        return;
+      }
+      home = hash_from_addr(&neighbor_from_index(hash_slots[next] - 1)->addr);
+      /* Leave the entry in place if its home slot is cyclically
+         within (slot, next] */
+    } while(slot <= next ? (slot < home && home <= next)
+                         : (slot < home || home <= next));
+    hash_slots[slot] = hash_slots[next];
+    slot = next;
+  }
+}
+#endif /* CSMA_WITH_NEIGHBOR_HASH */
+/*---------------------------------------------------------------------------*/
 static struct neighbor_queue *
 neighbor_queue_from_addr(const linkaddr_t *addr)
 {
+#if CSMA_WITH_NEIGHBOR_HASH
+  unsigned slot;
+
+  for(slot = hash_from_addr(addr); hash_slots[slot] != 0;
+      slot = (slot + 1) % CSMA_NEIGHBOR_HASH_SIZE) {
+    struct neighbor_queue *n = neighbor_from_index(hash_slots[slot] - 1);
+    if(linkaddr_cmp(&n->addr, addr)) {
+      return n;
+    }
+  }
+  return NULL;
+#else /* CSMA_WITH_NEIGHBOR_HASH */
   struct neighbor_queue *n = list_head(neighbor_list);
   while(n != NULL) {
     if(linkaddr_cmp(&n->addr, addr)) {
@@ -149,6 +300,24 @@ neighbor_queue_from_addr(const linkaddr_t *addr)
     n = list_item_next(n);
   }
   return NULL;
+#endif /* CSMA_WITH_NEIGHBOR_HASH */
+}
+/*---------------------------------------------------------------------------*/
+/* Remove a neighbor whose packet queue is empty */
+static void
+neighbor_queue_free(struct neighbor_queue *n)
+{
+#if CSMA_WITH_DRR
+  if(n == drr_current) {
+    /* Hand the turn over to the next neighbor */
+    drr_current = list_item_next(n);
+  }
+#endif /* CSMA_WITH_DRR */
+  list_remove(neighbor_list, n);
+#if CSMA_WITH_NEIGHBOR_HASH
+  hash_remove(n);
+#endif /* CSMA_WITH_NEIGHBOR_HASH */
+  memb_free(&neighbor_memb, n);
 }
 /*---------------------------------------------------------------------------*/
 static clock_time_t
@@ -272,8 +441,8 @@ transmit_from_queue(void *ptr)
   }
 }
 /*---------------------------------------------------------------------------*/
-static void
-schedule_transmission(struct neighbor_queue *n)
+static clock_time_t
+transmission_delay(struct neighbor_queue *n)
 {
   clock_time_t delay;
   int backoff_exponent; /* BE in IEEE 802.15.4 */
@@ -289,7 +458,73 @@ schedule_transmission(struct neighbor_queue *n)
 
   LOG_DBG("scheduling transmission in %u ticks, NB=%u, BE=%u\n",
       (unsigned)delay, n->collisions, backoff_exponent);
-  ctimer_set(&n->transmit_timer, delay, transmit_from_queue, n);
+  return delay;
+}
+/*---------------------------------------------------------------------------*/
+#if CSMA_WITH_DRR
+/* Select the neighbor that may transmit next. A neighbor is given
+   CSMA_DRR_QUANTUM more bytes of credit each time that its turn comes,
+   and keeps the turn for as long as its credit covers the first packet
+   in its queue. */
+static struct neighbor_queue *
+drr_select(void)
+{
+  struct neighbor_queue *n;
+
+  n = drr_current != NULL ? drr_current : list_head(neighbor_list);
+  while(n != NULL) {
+    struct packet_queue *q = list_head(n->packet_queue);
+
+    if(!n->in_round) {
+      n->in_round = 1;
+      n->deficit += CSMA_DRR_QUANTUM;
+    }
+    if(q != NULL && queuebuf_datalen(q->buf) <= n->deficit) {
+      drr_current = n;
+      return n;
+    }
+
+    /* End of the turn of this neighbor */
+    n->in_round = 0;
+    if(q == NULL) {
+      n->deficit = 0;
+    }
+    n = list_item_next(n);
+    if(n == NULL) {
+      n = list_head(neighbor_list);
+    }
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+static void
+drr_transmit(void *ptr)
+{
+  struct neighbor_queue *n = ptr;
+  struct packet_queue *q = list_head(n->packet_queue);
+
+  /* Every transmission attempt is charged, including retransmissions */
+  n->deficit -= queuebuf_datalen(q->buf);
+  transmit_from_queue(n);
+}
+#endif /* CSMA_WITH_DRR */
+/*---------------------------------------------------------------------------*/
+static void
+schedule_transmission(struct neighbor_queue *n)
+{
+#if CSMA_WITH_DRR
+  /* A single transmission is scheduled at a time, for the neighbor
+     selected by the round robin scheduler rather than for n. */
+  if(!ctimer_expired(&transmit_timer)) {
+    return;
+  }
+  n = drr_select();
+  if(n != NULL) {
+    ctimer_set(&transmit_timer, transmission_delay(n), drr_transmit, n);
+  }
+#else /* CSMA_WITH_DRR */
+  ctimer_set(&n->transmit_timer, transmission_delay(n), transmit_from_queue, n);
+#endif /* CSMA_WITH_DRR */
 }
 /*---------------------------------------------------------------------------*/
 static void
@@ -312,9 +547,14 @@ free_packet(struct neighbor_queue *n, struct packet_queue *p, int status)
       schedule_transmission(n);
     } else {
       /* This was the last packet in the queue, we free the neighbor */
+#if CSMA_WITH_DRR
+      neighbor_queue_free(n);
+      /* Let the other neighbors transmit */
+      schedule_transmission(NULL);
+#else /* CSMA_WITH_DRR */
       ctimer_stop(&n->transmit_timer);
-      list_remove(neighbor_list, n);
-      memb_free(&neighbor_memb, n);
+      neighbor_queue_free(n);
+#endif /* CSMA_WITH_DRR */
     }
   }
 }
@@ -437,6 +677,22 @@ packet_sent(struct neighbor_queue *n,
   }
 }
 /*---------------------------------------------------------------------------*/
+/* Check whether a neighbor may queue one more packet */
+static int
+queue_has_room(struct neighbor_queue *n)
+{
+  int len = list_length(n->packet_queue);
+
+  if(len >= CSMA_MAX_PACKET_PER_NEIGHBOR) {
+    return 0;
+  }
+#if CSMA_WITH_DRR
+  return len < CSMA_QUEUE_SHARE * memb_numfree(&packet_memb);
+#else /* CSMA_WITH_DRR */
+  return 1;
+#endif /* CSMA_WITH_DRR */
+}
+/*---------------------------------------------------------------------------*/
 void
 csma_output_packet(mac_callback_t sent, void *ptr)
 {
@@ -470,21 +726,29 @@ csma_output_packet(mac_callback_t sent, void *ptr)
       linkaddr_copy(&n->addr, addr);
       n->transmissions = 0;
       n->collisions = 0;
+      n->dropped = 0;
+#if CSMA_WITH_DRR
+      n->deficit = 0;
+      n->in_round = 0;
+#endif /* CSMA_WITH_DRR */
       /* Init packet queue for this neighbor */
       LIST_STRUCT_INIT(n, packet_queue);
       /* Add neighbor to the neighbor list */
       list_add(neighbor_list, n);
+#if CSMA_WITH_NEIGHBOR_HASH
+      hash_add(n);
+#endif /* CSMA_WITH_NEIGHBOR_HASH */
     }
   }
 
   if(n != NULL) {
     /* Add packet to the neighbor's queue */
-    if(list_length(n->packet_queue) < CSMA_MAX_PACKET_PER_NEIGHBOR) {
+    if(queue_has_room(n)) {
       q = memb_alloc(&packet_memb);
       if(q != NULL) {
         q->ptr = memb_alloc(&metadata_memb);
         if(q->ptr != NULL) {
-          q->buf = queuebuf_new_from_packetbuf();
+          q->buf = queuebuf_move_from_packetbuf();
           if(q->buf != NULL) {
             struct qbuf_metadata *metadata = (struct qbuf_metadata *)q->ptr;
             /* Neighbor and packet successfully allocated */
@@ -496,11 +760,12 @@ csma_output_packet(mac_callback_t sent, void *ptr)
             metadata->sent = sent;
             metadata->cptr = ptr;
             list_add(n->packet_queue, q);
+            stats.queued++;
 
             LOG_INFO("sending to ");
             LOG_INFO_LLADDR(addr);
             LOG_INFO_(", len %u, seqno %u, queue length %d, free packets %d\n",
-                    packetbuf_datalen(),
+                    queuebuf_datalen(q->buf),
                     packetbuf_attr(PACKETBUF_ATTR_MAC_SEQNO),
                     list_length(n->packet_queue), memb_numfree(&packet_memb));
             /* If q is the first packet in the neighbor's queue, send asap */
@@ -515,22 +780,56 @@ csma_output_packet(mac_callback_t sent, void *ptr)
         memb_free(&packet_memb, q);
         LOG_WARN("could not allocate queuebuf, dropping packet\n");
       }
+      stats.dropped_no_buffer++;
       /* The packet allocation failed. Remove and free neighbor entry if empty. */
       if(list_length(n->packet_queue) == 0) {
-        list_remove(neighbor_list, n);
-        memb_free(&neighbor_memb, n);
+        neighbor_queue_free(n);
+        n = NULL;
+      }
+    } else if(list_length(n->packet_queue) < CSMA_MAX_PACKET_PER_NEIGHBOR) {
+      /* The neighbor's share of the remaining packet buffers is used up */
+      LOG_WARN("Packet buffers exhausted\n");
+      stats.dropped_no_buffer++;
+      if(list_length(n->packet_queue) == 0) {
+        neighbor_queue_free(n);
+        n = NULL;
       }
     } else {
       LOG_WARN("Neighbor queue full\n");
+      stats.dropped_queue_full++;
+    }
+    if(n != NULL) {
+      n->dropped++;
     }
     LOG_WARN("could not allocate packet, dropping packet\n");
   } else {
     LOG_WARN("could not allocate neighbor, dropping packet\n");
+    stats.dropped_no_neighbor++;
   }
   mac_call_sent_callback(sent, ptr, MAC_TX_QUEUE_FULL, 1);
 }
 /*---------------------------------------------------------------------------*/
 void
+csma_output_get_stats(struct csma_output_stats *s)
+{
+  *s = stats;
+}
+/*---------------------------------------------------------------------------*/
+int
+csma_output_neighbor_stats(const linkaddr_t *addr,
+                           uint8_t *queued, uint16_t *dropped)
+{
+  struct neighbor_queue *n = neighbor_queue_from_addr(addr);
+
+  if(n == NULL) {
+    return 0;
+  }
+  *queued = list_length(n->packet_queue);
+  *dropped = n->dropped;
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+void
 csma_output_init(void)
 {
   memb_init(&packet_memb);
@@ -45,7 +45,25 @@
 #include "contiki.h"
 #include "net/mac/mac.h"
 
+/* Statistics of the CSMA output queues */
+struct csma_output_stats {
+  uint32_t queued;
+  /* Packets dropped because no neighbor queue was available */
+  uint32_t dropped_no_neighbor;
+  /* Packets dropped because the queue of the neighbor was full */
+  uint32_t dropped_queue_full;
+  /* Packets dropped because no packet buffer was available */
+  uint32_t dropped_no_buffer;
+};
+
 void csma_output_packet(mac_callback_t sent, void *ptr);
 void csma_output_init(void);
+void csma_output_get_stats(struct csma_output_stats *stats);
+
+/* Get the number of packets queued for a neighbor, and the number of
+   packets to it that have been dropped since its queue was created.
+   Returns 0 if there is no queue for the neighbor. */
+int csma_output_neighbor_stats(const linkaddr_t *addr,
+                               uint8_t *queued, uint16_t *dropped);
 
 #endif /* CSMA_OUTPUT_H_ */
@@ -53,6 +53,7 @@
 #include "net/packetbuf.h"
 #include "lib/ccm-star.h"
 #include "lib/aes-128.h"
+#include "lib/list.h"
 #include <stdio.h>
 #include <string.h>
 #include "ccm-star-packetbuf.h"
@@ -87,16 +88,115 @@ typedef struct {
 } aes_key_t;
 static aes_key_t keys[CSMA_LLSEC_MAXKEYS];
 
+static struct csma_security_key_cache_stats key_cache_stats;
+
+#if CSMA_LLSEC_KEY_CACHE_SIZE > 0
+/**
+ *  Expanded key schedules, most recently used first
+ */
+struct key_cache_entry {
+  struct key_cache_entry *next;
+  uint8_t key_mode;
+  uint8_t key_index;
+  uint8_t schedule[AES_128_SCHEDULE_SIZE];
+};
+static struct key_cache_entry key_cache_entries[CSMA_LLSEC_KEY_CACHE_SIZE];
+LIST(key_cache);
+
+/*---------------------------------------------------------------------------*/
+static void
+key_cache_invalidate(uint8_t index)
+{
+  struct key_cache_entry *e;
+  struct key_cache_entry *next;
+
+  for(e = list_head(key_cache); e != NULL; e = next) {
+    next = list_item_next(e);
+    if(e->key_index == index) {
+      list_remove(key_cache, e);
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static struct key_cache_entry *
+key_cache_alloc(void)
+{
+  struct key_cache_entry *e;
+  int i;
+
+  if(list_length(key_cache) < CSMA_LLSEC_KEY_CACHE_SIZE) {
+    /* Find an entry that is not in the list */
+    for(i = 0; i < CSMA_LLSEC_KEY_CACHE_SIZE; i++) {
+      for(e = list_head(key_cache); e != NULL; e = list_item_next(e)) {
+        if(e == &key_cache_entries[i]) {
+          break;
+        }
+      }
+      if(e == NULL) {
+        return &key_cache_entries[i];
+      }
+    }
+  }
+  /* Evict the least recently used entry */
+  return list_chop(key_cache);
+}
+#endif /* CSMA_LLSEC_KEY_CACHE_SIZE > 0 */
+/*---------------------------------------------------------------------------*/
+/* Makes key index the key of CCM_STAR, from the cache when possible */
+static void
+use_key(uint8_t key_mode, uint8_t index)
+{
+#if CSMA_LLSEC_KEY_CACHE_SIZE > 0
+  struct key_cache_entry *e;
+
+  if(CCM_STAR.save_key != NULL) {
+    for(e = list_head(key_cache); e != NULL; e = list_item_next(e)) {
+      if(e->key_mode == key_mode && e->key_index == index) {
+        key_cache_stats.hits++;
+        list_remove(key_cache, e);
+        list_push(key_cache, e);
+        CCM_STAR.load_key(e->schedule);
+        return;
+      }
+    }
+
+    key_cache_stats.misses++;
+    CCM_STAR.set_key(keys[index].u8);
+    e = key_cache_alloc();
+    if(CCM_STAR.save_key(e->schedule)) {
+      e->key_mode = key_mode;
+      e->key_index = index;
+      list_push(key_cache, e);
+    }
+    return;
+  }
+#endif /* CSMA_LLSEC_KEY_CACHE_SIZE > 0 */
+  key_cache_stats.misses++;
+  CCM_STAR.set_key(keys[index].u8);
+}
+/*---------------------------------------------------------------------------*/
 /* assumed to be 16 bytes */
 int
 csma_security_set_key(uint8_t index, const uint8_t *key)
 {
   if(key != NULL && index < CSMA_LLSEC_MAXKEYS) {
     memcpy(keys[index].u8, key, 16);
+#if CSMA_LLSEC_KEY_CACHE_SIZE > 0
+    key_cache_invalidate(index);
+#endif /* CSMA_LLSEC_KEY_CACHE_SIZE > 0 */
     return 1;
   }
   return 0;
 }
+/*---------------------------------------------------------------------------*/
+void
+csma_security_get_key_cache_stats(struct csma_security_key_cache_stats *stats)
+{
+  *stats = key_cache_stats;
+#if CSMA_LLSEC_KEY_CACHE_SIZE > 0
+  stats->entries = list_length(key_cache);
+#endif /* CSMA_LLSEC_KEY_CACHE_SIZE > 0 */
+}
 
 #define N_KEYS (sizeof(keys) / sizeof(aes_key))
 /*---------------------------------------------------------------------------*/
@@ -114,7 +214,6 @@ aead(uint8_t hdrlen, int forward)
   uint8_t generated_mic[MIC_LEN(7)];
   uint8_t *mic;
   uint8_t key_index;
-  aes_key_t *key;
   uint8_t with_encryption;
 
   key_index = LLSEC_KEY_INDEX;
@@ -123,8 +222,6 @@ aead(uint8_t hdrlen, int forward)
     return 0;
   }
 
-  key = &keys[key_index];
-
   ccm_star_packetbuf_set_nonce(nonce, forward);
   totlen = packetbuf_totlen();
   a = packetbuf_hdrptr();
@@ -145,7 +242,7 @@ aead(uint8_t hdrlen, int forward)
   mic = a + totlen;
   result = forward ? mic : generated_mic;
 
-  CCM_STAR.set_key(key->u8);
+  use_key(LLSEC_KEY_MODE, key_index);
   CCM_STAR.aead(nonce,
       m, m_len,
       a, a_len,
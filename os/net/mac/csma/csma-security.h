@@ -71,4 +71,12 @@
 #define CSMA_LLSEC_MAXKEYS 1
 #endif
 
+/* The number of expanded key schedules to keep, so that frames do not
+   have to expand their key again. 0 disables the cache. */
+#ifdef CSMA_CONF_LLSEC_KEY_CACHE_SIZE
+#define CSMA_LLSEC_KEY_CACHE_SIZE CSMA_CONF_LLSEC_KEY_CACHE_SIZE
+#else
+#define CSMA_LLSEC_KEY_CACHE_SIZE MIN(CSMA_LLSEC_MAXKEYS, 2)
+#endif /* CSMA_CONF_LLSEC_KEY_CACHE_SIZE */
+
 #endif /* CSMA_SECURITY_H_ */
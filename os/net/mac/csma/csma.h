@@ -87,6 +87,14 @@ int csma_security_parse_frame(void);
 /* key management for CSMA */
 int csma_security_set_key(uint8_t index, const uint8_t *key);
 
+/* statistics of the key schedule cache of CSMA */
+struct csma_security_key_cache_stats {
+  uint32_t hits;
+  uint32_t misses;
+  uint8_t entries;
+};
+void csma_security_get_key_cache_stats(struct csma_security_key_cache_stats *stats);
+
 
 #endif /* CSMA_H_ */
 /**
@@ -353,6 +353,16 @@
 #define TSCH_SCHEDULE_MAX_LINKS 32
 #endif
 
+/* Keep a per-slotframe array of links sorted by timeslot, so that
+ * tsch_schedule_get_next_active_link() can binary-search each slotframe
+ * instead of walking every link. Adding or removing a link inserts or
+ * removes only its own entry, in time linear in the number of links. */
+#ifdef TSCH_SCHEDULE_CONF_WITH_LINK_CACHE
+#define TSCH_SCHEDULE_WITH_LINK_CACHE TSCH_SCHEDULE_CONF_WITH_LINK_CACHE
+#else
+#define TSCH_SCHEDULE_WITH_LINK_CACHE 0
+#endif
+
 /* To include Sixtop Implementation */
 #ifdef TSCH_CONF_WITH_SIXTOP
 #define TSCH_WITH_SIXTOP TSCH_CONF_WITH_SIXTOP
@@ -250,7 +250,7 @@ tsch_queue_add_packet(const linkaddr_t *addr, uint8_t max_transmissions,
         p = memb_alloc(&packet_memb);
         if(p != NULL) {
           /* Enqueue packet */
-          p->qb = queuebuf_new_from_packetbuf();
+          p->qb = queuebuf_move_from_packetbuf();
           if(p->qb != NULL) {
             p->sent = sent;
             p->ptr = ptr;
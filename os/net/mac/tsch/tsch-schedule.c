@@ -68,6 +68,87 @@ MEMB(slotframe_memb, struct tsch_slotframe, TSCH_SCHEDULE_MAX_SLOTFRAMES);
 /* List of slotframes (each slotframe holds its own list of links) */
 LIST(slotframe_list);
 
+#if TSCH_SCHEDULE_WITH_LINK_CACHE
+/* Links of all slotframes, grouped per slotframe and sorted by timeslot.
+ * Links sharing a timeslot are kept in list order, so that overlapping
+ * links are arbitrated exactly as when walking the lists. */
+static struct tsch_link *link_cache[TSCH_SCHEDULE_MAX_LINKS];
+/* Number of links in the cache */
+static uint16_t link_cache_len;
+/*---------------------------------------------------------------------------*/
+/* Returns the cache index of the first link of a slotframe that occurs
+ * after a given timeslot, or the end of the slotframe's range */
+static uint16_t
+link_cache_upper_bound(const struct tsch_slotframe *sf, uint16_t timeslot)
+{
+  uint16_t lo = sf->cache_first;
+  uint16_t hi = sf->cache_first + sf->cache_count;
+  while(lo < hi) {
+    uint16_t mid = lo + (hi - lo) / 2;
+    if(link_cache[mid]->timeslot > timeslot) {
+      hi = mid;
+    } else {
+      lo = mid + 1;
+    }
+  }
+  return lo;
+}
+/*---------------------------------------------------------------------------*/
+/* Moves the ranges of the slotframes that follow a given one */
+static void
+link_cache_shift(struct tsch_slotframe *sf, int offset)
+{
+  for(sf = list_item_next(sf); sf != NULL; sf = list_item_next(sf)) {
+    sf->cache_first += offset;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Adds a link that was added last to the list of its slotframe. Must be
+ * called with the lock taken. */
+static void
+link_cache_add(struct tsch_slotframe *sf, struct tsch_link *l)
+{
+  /* After the links of the same timeslot, which come before it in the list */
+  uint16_t i = link_cache_upper_bound(sf, l->timeslot);
+  memmove(&link_cache[i + 1], &link_cache[i],
+          (link_cache_len - i) * sizeof(link_cache[0]));
+  link_cache[i] = l;
+  link_cache_len++;
+  sf->cache_count++;
+  link_cache_shift(sf, 1);
+}
+/*---------------------------------------------------------------------------*/
+/* Removes a link of a slotframe. Must be called with the lock taken. */
+static void
+link_cache_remove(struct tsch_slotframe *sf, struct tsch_link *l)
+{
+  uint16_t i = link_cache_upper_bound(sf, l->timeslot);
+  while(i > sf->cache_first) {
+    i--;
+    if(link_cache[i] == l) {
+      memmove(&link_cache[i], &link_cache[i + 1],
+              (link_cache_len - i - 1) * sizeof(link_cache[0]));
+      link_cache_len--;
+      sf->cache_count--;
+      link_cache_shift(sf, -1);
+      return;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Returns the cache index of the first link of a non-empty slotframe that
+ * occurs after a given timeslot, wrapping around to its earliest link */
+static uint16_t
+link_cache_search(const struct tsch_slotframe *sf, uint16_t timeslot)
+{
+  uint16_t i = link_cache_upper_bound(sf, timeslot);
+  if(i == sf->cache_first + sf->cache_count) {
+    i = sf->cache_first;
+  }
+  return i;
+}
+#endif /* TSCH_SCHEDULE_WITH_LINK_CACHE */
+
 /* Adds and returns a slotframe (NULL if failure) */
 struct tsch_slotframe *
 tsch_schedule_add_slotframe(uint16_t handle, uint16_t size)
@@ -90,6 +171,11 @@ tsch_schedule_add_slotframe(uint16_t handle, uint16_t size)
       LIST_STRUCT_INIT(sf, links_list);
       /* Add the slotframe to the global list */
       list_add(slotframe_list, sf);
+#if TSCH_SCHEDULE_WITH_LINK_CACHE
+      /* The last slotframe has no links yet */
+      sf->cache_first = link_cache_len;
+      sf->cache_count = 0;
+#endif /* TSCH_SCHEDULE_WITH_LINK_CACHE */
     }
     LOG_INFO("add_slotframe %u %u\n",
            handle, size);
@@ -256,6 +342,9 @@ tsch_schedule_add_link(struct tsch_slotframe *slotframe,
           address = &linkaddr_null;
         }
         linkaddr_copy(&l->addr, address);
+#if TSCH_SCHEDULE_WITH_LINK_CACHE
+        link_cache_add(slotframe, l);
+#endif /* TSCH_SCHEDULE_WITH_LINK_CACHE */
 
         LOG_INFO("add_link sf=%u opt=%s type=%s ts=%u ch=%u addr=",
                  slotframe->handle,
@@ -308,6 +397,9 @@ tsch_schedule_remove_link(struct tsch_slotframe *slotframe, struct tsch_link *l)
       LOG_INFO_LLADDR(&l->addr);
       LOG_INFO_("\n");
 
+#if TSCH_SCHEDULE_WITH_LINK_CACHE
+      link_cache_remove(slotframe, l);
+#endif /* TSCH_SCHEDULE_WITH_LINK_CACHE */
       list_remove(slotframe->links_list, l);
       memb_free(&link_memb, l);
 
@@ -418,7 +510,18 @@ tsch_schedule_get_next_active_link(struct tsch_asn_t *asn, uint16_t *time_offset
     while(sf != NULL) {
       /* Get timeslot from ASN, given the slotframe length */
       uint16_t timeslot = TSCH_ASN_MOD(*asn, sf->size);
+#if TSCH_SCHEDULE_WITH_LINK_CACHE
+      /* Only the links at the earliest upcoming timeslot of this slotframe
+       * can be selected: visit those and skip the rest of the slotframe */
+      uint16_t i = 0;
+      struct tsch_link *l = NULL;
+      if(sf->cache_count > 0) {
+        i = link_cache_search(sf, timeslot);
+        l = link_cache[i];
+      }
+#else /* TSCH_SCHEDULE_WITH_LINK_CACHE */
       struct tsch_link *l = list_head(sf->links_list);
+#endif /* TSCH_SCHEDULE_WITH_LINK_CACHE */
       while(l != NULL) {
         uint16_t time_to_timeslot =
           l->timeslot > timeslot ?
@@ -469,7 +572,17 @@ tsch_schedule_get_next_active_link(struct tsch_asn_t *asn, uint16_t *time_offset
           }
         }
 
+#if TSCH_SCHEDULE_WITH_LINK_CACHE
+        i++;
+        if(i < sf->cache_first + sf->cache_count
+           && link_cache[i]->timeslot == l->timeslot) {
+          l = link_cache[i];
+        } else {
+          l = NULL;
+        }
+#else /* TSCH_SCHEDULE_WITH_LINK_CACHE */
         l = list_item_next(l);
+#endif /* TSCH_SCHEDULE_WITH_LINK_CACHE */
       }
       sf = list_item_next(sf);
     }
@@ -491,6 +604,9 @@ tsch_schedule_init(void)
     memb_init(&link_memb);
     memb_init(&slotframe_memb);
     list_init(slotframe_list);
+#if TSCH_SCHEDULE_WITH_LINK_CACHE
+    link_cache_len = 0;
+#endif /* TSCH_SCHEDULE_WITH_LINK_CACHE */
     tsch_release_lock();
     return 1;
   } else {
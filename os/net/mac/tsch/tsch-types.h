@@ -44,6 +44,7 @@
 
 /********** Includes **********/
 
+#include "net/mac/tsch/tsch-conf.h"
 #include "net/mac/tsch/tsch-asn.h"
 #include "lib/list.h"
 #include "lib/ringbufindex.h"
@@ -91,6 +92,11 @@ struct tsch_slotframe {
   struct tsch_asn_divisor_t size;
   /* List of links belonging to this slotframe */
   LIST_STRUCT(links_list);
+#if TSCH_SCHEDULE_WITH_LINK_CACHE
+  /* Range of this slotframe's links in the sorted link cache */
+  uint16_t cache_first;
+  uint16_t cache_count;
+#endif /* TSCH_SCHEDULE_WITH_LINK_CACHE */
 };
 
 /** \brief TSCH packet information */
@@ -536,7 +536,7 @@ tsch_tx_process_pending(void)
   while((dequeued_index = ringbufindex_peek_get(&dequeued_ringbuf)) != -1) {
     struct tsch_packet *p = dequeued_array[dequeued_index];
     /* Put packet into packetbuf for packet_sent callback */
-    queuebuf_to_packetbuf(p->qb);
+    queuebuf_move_to_packetbuf(p->qb);
     LOG_INFO("packet sent to ");
     LOG_INFO_LLADDR(packetbuf_addr(PACKETBUF_ADDR_RECEIVER));
     LOG_INFO_(", seqno %u, status %d, tx %d\n",
@@ -946,7 +946,7 @@ PROCESS_THREAD(tsch_send_eb_process, ev, data)
           LOG_ERR("! could not enqueue EB packet\n");
         } else {
           LOG_INFO("TSCH: enqueue EB packet %u %u\n",
-                   packetbuf_totlen(), packetbuf_hdrlen());
+                   queuebuf_datalen(p->qb), hdr_len);
           p->tsch_sync_ie_offset = tsch_sync_ie_offset;
           p->header_len = hdr_len;
         }
@@ -70,6 +70,12 @@ static unsigned num_tables;
 MEMB(neighbor_addr_mem, nbr_table_key_t, NBR_TABLE_MAX_NEIGHBORS);
 LIST(nbr_table_keys);
 
+#if NBR_TABLE_WITH_HASH
+/* Hash index of the neighbor address table, using linear probing.
+ * Each slot holds a neighbor index plus one, zero marks an empty slot. */
+static uint16_t hash_slots[NBR_TABLE_HASH_SIZE];
+#endif /* NBR_TABLE_WITH_HASH */
+
 /*---------------------------------------------------------------------------*/
 static void remove_key(nbr_table_key_t *key, bool do_free);
 /*---------------------------------------------------------------------------*/
@@ -115,16 +121,92 @@ key_from_item(const nbr_table_t *table, const nbr_table_item_t *item)
   return key_from_index(index_from_item(table, item));
 }
 /*---------------------------------------------------------------------------*/
+#if NBR_TABLE_WITH_HASH
+/* Get the home slot of a link-layer address in the hash index */
+static unsigned
+hash_from_lladdr(const linkaddr_t *lladdr)
+{
+  uint32_t hash = 2166136261UL;
+  int i;
+
+  /* FNV-1a over the address bytes */
+  for(i = 0; i < LINKADDR_SIZE; i++) {
+    hash = (hash ^ lladdr->u8[i]) * 16777619UL;
+  }
+  return hash % NBR_TABLE_HASH_SIZE;
+}
+/*---------------------------------------------------------------------------*/
+/* Add a key to the hash index. The key must not already be indexed. */
+static void
+hash_add(const nbr_table_key_t *key)
+{
+  unsigned slot = hash_from_lladdr(&key->lladdr);
+
+  while(hash_slots[slot] != 0) {
+    slot = (slot + 1) % NBR_TABLE_HASH_SIZE;
+  }
+  hash_slots[slot] = index_from_key(key) + 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Remove a key from the hash index, shifting back the entries that
+ * follow it so that no probe sequence is broken */
+static void
+hash_remove(const nbr_table_key_t *key)
+{
+  unsigned slot = hash_from_lladdr(&key->lladdr);
+  unsigned next;
+  unsigned home;
+
+  while(hash_slots[slot] != index_from_key(key) + 1) {
+    if(hash_slots[slot] == 0) {
+      /* Not indexed */
+      return;
+    }
+    slot = (slot + 1) % NBR_TABLE_HASH_SIZE;
+  }
+
+  next = slot;
+  while(1) {
+    hash_slots[slot] = 0;
+    do {
+      next = (next + 1) % NBR_TABLE_HASH_SIZE;
+      if(hash_slots[next] == 0) {
+        return;
+      }
+      home = hash_from_lladdr(&key_from_index(hash_slots[next] - 1)->lladdr);
+      /* Leave the entry in place if its home slot is cyclically
+       * within (slot, next] */
+    } while(slot <= next ? (slot < home && home <= next)
+                         : (slot < home || home <= next));
+    hash_slots[slot] = hash_slots[next];
+    slot = next;
+  }
+}
+#endif /* NBR_TABLE_WITH_HASH */
+/*---------------------------------------------------------------------------*/
 /* Get the index of a neighbor from its link-layer address */
 static int
 index_from_lladdr(const linkaddr_t *lladdr)
 {
+#if NBR_TABLE_WITH_HASH
+  unsigned slot;
+#else /* NBR_TABLE_WITH_HASH */
   nbr_table_key_t *key;
+#endif /* NBR_TABLE_WITH_HASH */
   /* Allow lladdr-free insertion, useful e.g. for IPv6 ND.
    * Only one such entry is possible at a time, indexed by linkaddr_null. */
   if(lladdr == NULL) {
     lladdr = &linkaddr_null;
   }
+#if NBR_TABLE_WITH_HASH
+  for(slot = hash_from_lladdr(lladdr); hash_slots[slot] != 0;
+      slot = (slot + 1) % NBR_TABLE_HASH_SIZE) {
+    if(linkaddr_cmp(lladdr, &key_from_index(hash_slots[slot] - 1)->lladdr)) {
+      return hash_slots[slot] - 1;
+    }
+  }
+  return -1;
+#else /* NBR_TABLE_WITH_HASH */
   key = list_head(nbr_table_keys);
   while(key != NULL) {
     if(lladdr && linkaddr_cmp(lladdr, &key->lladdr)) {
@@ -133,6 +215,7 @@ index_from_lladdr(const linkaddr_t *lladdr)
     key = list_item_next(key);
   }
   return -1;
+#endif /* NBR_TABLE_WITH_HASH */
 }
 /*---------------------------------------------------------------------------*/
 /* Get bit from "used" or "locked" bitmap */
@@ -187,6 +270,9 @@ remove_key(nbr_table_key_t *key, bool do_free)
   locked_map[index_from_key(key)] = 0;
   /* Remove neighbor from list */
   list_remove(nbr_table_keys, key);
+#if NBR_TABLE_WITH_HASH
+  hash_remove(key);
+#endif /* NBR_TABLE_WITH_HASH */
   if(do_free) {
     /* Release the memory */
     memb_free(&neighbor_addr_mem, key);
@@ -434,6 +520,9 @@ nbr_table_add_lladdr(const nbr_table_t *table, const linkaddr_t *lladdr,
 
     /* Set link-layer address */
     linkaddr_copy(&key->lladdr, lladdr);
+#if NBR_TABLE_WITH_HASH
+    hash_add(key);
+#endif /* NBR_TABLE_WITH_HASH */
   }
 
   /* Get item in the current table */
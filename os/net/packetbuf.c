@@ -103,6 +103,26 @@ packetbuf_copyto(void *to)
   return hdrlen + buflen;
 }
 /*---------------------------------------------------------------------------*/
+uint16_t
+packetbuf_exchange(void **block, uint16_t len)
+{
+  uint8_t *old = packetbuf;
+  uint16_t old_len = hdrlen + buflen;
+
+  if(old_len > PACKETBUF_SIZE) {
+    old_len = 0;
+  } else if(bufptr > 0) {
+    /* Make the header and data contiguous, as packetbuf_copyto() would */
+    memmove(old + hdrlen, old + bufptr + hdrlen, buflen);
+  }
+  packetbuf = *block;
+  buflen = MIN(PACKETBUF_SIZE, len);
+  bufptr = 0;
+  hdrlen = 0;
+  *block = old;
+  return old_len;
+}
+/*---------------------------------------------------------------------------*/
 int
 packetbuf_hdralloc(int size)
 {
@@ -164,6 +164,28 @@ int packetbuf_copyfrom(const void *from, uint16_t len);
  */
 int packetbuf_copyto(void *to);
 
+/**
+ * \brief      Exchange the packetbuf storage with an external buffer
+ * \param block A pointer to a 32-bit aligned buffer of PACKETBUF_SIZE
+ *              bytes, replaced with the previous packetbuf storage
+ * \param len  The length of the packet held in the buffer
+ * \retval     The length of the packet in the previous storage
+ *
+ *             This function swaps the packetbuf storage with an
+ *             external buffer instead of copying the packet. On
+ *             return, *block holds the previous packet laid out as
+ *             packetbuf_copyto() would have written it, and the
+ *             packetbuf holds the \a len bytes of the new storage as
+ *             data, as after packetbuf_copyfrom(). The attributes
+ *             are left untouched.
+ *
+ *             Pointers previously obtained from packetbuf_dataptr()
+ *             or packetbuf_hdrptr() refer to the old storage and must
+ *             not be used on the packetbuf afterwards.
+ *
+ */
+uint16_t packetbuf_exchange(void **block, uint16_t len);
+
 /**
  * \brief      Extend the header of the packetbuf, for outbound packets
  * \param size The number of bytes the header should be extended
@@ -73,7 +73,11 @@ struct queuebuf {
 
 /* The actual queuebuf data */
 struct queuebuf_data {
+#if QUEUEBUF_ZERO_COPY
+  uint8_t *data;
+#else /* QUEUEBUF_ZERO_COPY */
   uint8_t data[PACKETBUF_SIZE];
+#endif /* QUEUEBUF_ZERO_COPY */
   uint16_t len;
   struct packetbuf_attr attrs[PACKETBUF_NUM_ATTRS];
   struct packetbuf_addr addrs[PACKETBUF_NUM_ADDRS];
@@ -82,6 +86,17 @@ struct queuebuf_data {
 MEMB(bufmem, struct queuebuf, QUEUEBUF_NUM);
 MEMB(buframmem, struct queuebuf_data, QUEUEBUFRAM_NUM);
 
+#if QUEUEBUF_ZERO_COPY
+/* The packet storage blocks. Blocks are exchanged with the packetbuf
+   rather than copied, so the packetbuf's own storage may end up in a
+   queuebuf and one of these blocks in the packetbuf. There is always
+   one block per queuebuf_data in use and QUEUEBUFRAM_NUM blocks in
+   total outside the packetbuf, whichever those are. */
+static uint32_t blockmem[QUEUEBUFRAM_NUM][(PACKETBUF_SIZE + 3) / 4];
+static uint8_t *free_blocks[QUEUEBUFRAM_NUM];
+static uint8_t free_block_count;
+#endif /* QUEUEBUF_ZERO_COPY */
+
 #if WITH_SWAP
 
 /* Swapping allows to store up to QUEUEBUF_NUM - QUEUEBUFRAM_NUM
@@ -125,14 +140,12 @@ LIST(queuebuf_list);
 #define PRINTF(...)
 #endif
 
-#ifdef QUEUEBUF_CONF_STATS
-#define QUEUEBUF_STATS QUEUEBUF_CONF_STATS
-#else
-#define QUEUEBUF_STATS 0
-#endif /* QUEUEBUF_CONF_STATS */
-
 #if QUEUEBUF_STATS
 uint8_t queuebuf_len, queuebuf_max_len;
+uint32_t queuebuf_copied_bytes;
+#define COUNT_COPY(len) (queuebuf_copied_bytes += (len))
+#else /* QUEUEBUF_STATS */
+#define COUNT_COPY(len)
 #endif /* QUEUEBUF_STATS */
 
 #if WITH_SWAP
@@ -289,8 +302,15 @@ queuebuf_init(void)
 #endif
   memb_init(&buframmem);
   memb_init(&bufmem);
+#if QUEUEBUF_ZERO_COPY
+  for(free_block_count = 0; free_block_count < QUEUEBUFRAM_NUM;
+      free_block_count++) {
+    free_blocks[free_block_count] = (uint8_t *)blockmem[free_block_count];
+  }
+#endif /* QUEUEBUF_ZERO_COPY */
 #if QUEUEBUF_STATS
   queuebuf_max_len = 0;
+  queuebuf_copied_bytes = 0;
 #endif /* QUEUEBUF_STATS */
 }
 /*---------------------------------------------------------------------------*/
@@ -300,13 +320,8 @@ queuebuf_numfree(void)
   return memb_numfree(&bufmem);
 }
 /*---------------------------------------------------------------------------*/
-#if QUEUEBUF_DEBUG
-struct queuebuf *
-queuebuf_new_from_packetbuf_debug(const char *file, int line)
-#else /* QUEUEBUF_DEBUG */
-struct queuebuf *
-queuebuf_new_from_packetbuf(void)
-#endif /* QUEUEBUF_DEBUG */
+static struct queuebuf *
+queuebuf_new(int move)
 {
   struct queuebuf *buf;
 
@@ -315,8 +330,6 @@ queuebuf_new_from_packetbuf(void)
   if(buf != NULL) {
 #if QUEUEBUF_DEBUG
     list_add(queuebuf_list, buf);
-    buf->file = file;
-    buf->line = line;
     buf->time = clock_time();
 #endif /* QUEUEBUF_DEBUG */
     buf->ram_ptr = memb_alloc(&buframmem);
@@ -340,7 +353,20 @@ queuebuf_new_from_packetbuf(void)
     buframptr = buf->ram_ptr;
 #endif
 
+#if QUEUEBUF_ZERO_COPY
+    buframptr->data = free_blocks[--free_block_count];
+    if(move) {
+      void *block = buframptr->data;
+      buframptr->len = packetbuf_exchange(&block, 0);
+      buframptr->data = block;
+    } else {
+      buframptr->len = packetbuf_copyto(buframptr->data);
+      COUNT_COPY(buframptr->len);
+    }
+#else /* QUEUEBUF_ZERO_COPY */
     buframptr->len = packetbuf_copyto(buframptr->data);
+    COUNT_COPY(buframptr->len);
+#endif /* QUEUEBUF_ZERO_COPY */
     packetbuf_attr_copyto(buframptr->attrs, buframptr->addrs);
 
 #if WITH_SWAP
@@ -367,6 +393,43 @@ queuebuf_new_from_packetbuf(void)
   return buf;
 }
 /*---------------------------------------------------------------------------*/
+#if QUEUEBUF_DEBUG
+static struct queuebuf *
+queuebuf_set_origin(struct queuebuf *buf, const char *file, int line)
+{
+  if(buf != NULL) {
+    buf->file = file;
+    buf->line = line;
+  }
+  return buf;
+}
+/*---------------------------------------------------------------------------*/
+struct queuebuf *
+queuebuf_new_from_packetbuf_debug(const char *file, int line)
+{
+  return queuebuf_set_origin(queuebuf_new(0), file, line);
+}
+/*---------------------------------------------------------------------------*/
+struct queuebuf *
+queuebuf_move_from_packetbuf_debug(const char *file, int line)
+{
+  return queuebuf_set_origin(queuebuf_new(1), file, line);
+}
+#else /* QUEUEBUF_DEBUG */
+/*---------------------------------------------------------------------------*/
+struct queuebuf *
+queuebuf_new_from_packetbuf(void)
+{
+  return queuebuf_new(0);
+}
+/*---------------------------------------------------------------------------*/
+struct queuebuf *
+queuebuf_move_from_packetbuf(void)
+{
+  return queuebuf_new(1);
+}
+#endif /* QUEUEBUF_DEBUG */
+/*---------------------------------------------------------------------------*/
 void
 queuebuf_update_attr_from_packetbuf(struct queuebuf *buf)
 {
@@ -385,6 +448,7 @@ queuebuf_update_from_packetbuf(struct queuebuf *buf)
   struct queuebuf_data *buframptr = queuebuf_load_to_ram(buf);
   packetbuf_attr_copyto(buframptr->attrs, buframptr->addrs);
   buframptr->len = packetbuf_copyto(buframptr->data);
+  COUNT_COPY(buframptr->len);
 #if WITH_SWAP
   if(buf->location == IN_CFS) {
     queuebuf_flush_tmpdata();
@@ -403,6 +467,9 @@ queuebuf_free(struct queuebuf *buf)
       queuebuf_remove_from_file(buf->swap_id);
     }
 #else
+#if QUEUEBUF_ZERO_COPY
+    free_blocks[free_block_count++] = buf->ram_ptr->data;
+#endif /* QUEUEBUF_ZERO_COPY */
     memb_free(&buframmem, buf->ram_ptr);
 #endif
     memb_free(&bufmem, buf);
@@ -422,8 +489,26 @@ queuebuf_to_packetbuf(struct queuebuf *b)
   if(memb_inmemb(&bufmem, b)) {
     struct queuebuf_data *buframptr = queuebuf_load_to_ram(b);
     packetbuf_copyfrom(buframptr->data, buframptr->len);
+    COUNT_COPY(buframptr->len);
+    packetbuf_attr_copyfrom(buframptr->attrs, buframptr->addrs);
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+queuebuf_move_to_packetbuf(struct queuebuf *b)
+{
+#if QUEUEBUF_ZERO_COPY
+  if(memb_inmemb(&bufmem, b)) {
+    struct queuebuf_data *buframptr = b->ram_ptr;
+    void *block = buframptr->data;
+    packetbuf_exchange(&block, buframptr->len);
+    buframptr->data = block;
+    buframptr->len = 0;
     packetbuf_attr_copyfrom(buframptr->attrs, buframptr->addrs);
   }
+#else /* QUEUEBUF_ZERO_COPY */
+  queuebuf_to_packetbuf(b);
+#endif /* QUEUEBUF_ZERO_COPY */
 }
 /*---------------------------------------------------------------------------*/
 void *
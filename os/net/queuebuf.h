@@ -91,6 +91,31 @@
 #define QUEUEBUF_DEBUG 0
 #endif /* QUEUEBUF_CONF_DEBUG */
 
+/* With QUEUEBUF_CONF_ZERO_COPY, queuebuf_move_from_packetbuf() and
+   queuebuf_move_to_packetbuf() exchange storage with the packetbuf
+   instead of copying the packet. Without it, they copy. */
+#ifdef QUEUEBUF_CONF_ZERO_COPY
+#define QUEUEBUF_ZERO_COPY QUEUEBUF_CONF_ZERO_COPY
+#else /* QUEUEBUF_CONF_ZERO_COPY */
+#define QUEUEBUF_ZERO_COPY 0
+#endif /* QUEUEBUF_CONF_ZERO_COPY */
+
+#if QUEUEBUF_ZERO_COPY && WITH_SWAP
+#error "QUEUEBUF_CONF_ZERO_COPY cannot be used with queuebuf swapping"
+#endif
+
+#ifdef QUEUEBUF_CONF_STATS
+#define QUEUEBUF_STATS QUEUEBUF_CONF_STATS
+#else
+#define QUEUEBUF_STATS 0
+#endif /* QUEUEBUF_CONF_STATS */
+
+#if QUEUEBUF_STATS
+extern uint8_t queuebuf_len, queuebuf_max_len;
+/* Number of packet bytes copied between the packetbuf and queuebufs */
+extern uint32_t queuebuf_copied_bytes;
+#endif /* QUEUEBUF_STATS */
+
 struct queuebuf;
 
 void queuebuf_init(void);
@@ -98,13 +123,22 @@ void queuebuf_init(void);
 #if QUEUEBUF_DEBUG
 struct queuebuf *queuebuf_new_from_packetbuf_debug(const char *file, int line);
 #define queuebuf_new_from_packetbuf() queuebuf_new_from_packetbuf_debug(__FILE__, __LINE__)
+struct queuebuf *queuebuf_move_from_packetbuf_debug(const char *file, int line);
+#define queuebuf_move_from_packetbuf() queuebuf_move_from_packetbuf_debug(__FILE__, __LINE__)
 #else /* QUEUEBUF_DEBUG */
 struct queuebuf *queuebuf_new_from_packetbuf(void);
+/* Like queuebuf_new_from_packetbuf(), but may take over the packetbuf
+   storage. On success, the packetbuf attributes are kept but its
+   contents are undefined. */
+struct queuebuf *queuebuf_move_from_packetbuf(void);
 #endif /* QUEUEBUF_DEBUG */
 void queuebuf_update_attr_from_packetbuf(struct queuebuf *b);
 void queuebuf_update_from_packetbuf(struct queuebuf *b);
 
 void queuebuf_to_packetbuf(struct queuebuf *b);
+/* Like queuebuf_to_packetbuf(), but may hand the queuebuf storage
+   over to the packetbuf. The queuebuf may only be freed afterwards. */
+void queuebuf_move_to_packetbuf(struct queuebuf *b);
 void queuebuf_free(struct queuebuf *b);
 
 void *queuebuf_dataptr(struct queuebuf *b);
@@ -333,7 +333,9 @@ insert_srh_header(void)
     return 0;
   }
 
-  if(!uip_sr_is_addr_reachable(dag, &UIP_IP_BUF->destipaddr)) {
+  /* The nodes are already known, so check the path from them, which
+     uses the cached path length if there is one */
+  if(uip_sr_path_length(dest_node, root_node) < 0) {
     LOG_ERR("SRH no path found to destination\n");
     return 0;
   }
@@ -57,6 +57,10 @@
 
 extern long slip_sent;
 extern long slip_received;
+extern long slip_frames_sent;
+extern long slip_frames_received;
+extern long slip_writes;
+extern long slip_reads;
 
 static uint8_t mac_set;
 
@@ -94,8 +98,19 @@ border_router_set_mac(const uint8_t *data)
 void
 border_router_print_stat()
 {
+  unsigned long seconds = clock_seconds();
+
+  if(seconds == 0) {
+    seconds = 1;
+  }
   printf("bytes received over SLIP: %ld\n", slip_received);
   printf("bytes sent over SLIP: %ld\n", slip_sent);
+  printf("frames received over SLIP: %ld (%lu/s, %ld bytes/read)\n",
+         slip_frames_received, slip_frames_received / seconds,
+         slip_reads > 0 ? slip_received / slip_reads : 0);
+  printf("frames sent over SLIP: %ld (%lu/s, %ld bytes/write)\n",
+         slip_frames_sent, slip_frames_sent / seconds,
+         slip_writes > 0 ? slip_sent / slip_writes : 0);
 }
 /*---------------------------------------------------------------------------*/
 PROCESS_THREAD(border_router_process, ev, data)
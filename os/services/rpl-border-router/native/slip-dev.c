@@ -70,13 +70,30 @@ extern speed_t slip_config_b_rate;
 #define SEND_DELAY 0
 #endif
 
-int devopen(const char *dev, int flags);
+/* Size of the input and output buffers. Input is read and output
+   written in chunks of up to this size. */
+#ifdef SLIP_DEV_CONF_BUF_SIZE
+#define SLIP_DEV_BUF_SIZE SLIP_DEV_CONF_BUF_SIZE
+#else
+#define SLIP_DEV_BUF_SIZE 16384
+#endif
+
+/* Maximum number of outbound frames waiting to be written */
+#ifdef SLIP_DEV_CONF_TX_FRAMES
+#define SLIP_DEV_TX_FRAMES SLIP_DEV_CONF_TX_FRAMES
+#else
+#define SLIP_DEV_TX_FRAMES 32
+#endif
 
-static FILE *inslip;
+int devopen(const char *dev, int flags);
 
 /* for statistics */
 long slip_sent = 0;
 long slip_received = 0;
+long slip_frames_sent = 0;
+long slip_frames_received = 0;
+long slip_writes = 0;
+long slip_reads = 0;
 
 int slipfd = 0;
 
@@ -87,6 +104,12 @@ int slipfd = 0;
 #define SLIP_ESC_END 0334
 #define SLIP_ESC_ESC 0335
 
+/* Non-zero for the bytes that need escaping */
+static const uint8_t slip_special[256] = {
+  [SLIP_END] = 1,
+  [SLIP_ESC] = 1,
+};
+
 /*---------------------------------------------------------------------------*/
 static void *
 get_in_addr(struct sockaddr *sa)
@@ -168,152 +191,222 @@ slip_packet_input(unsigned char *data, int len)
   NETSTACK_MAC.input();
 }
 /*---------------------------------------------------------------------------*/
-/*
- * Read from serial, when we have a packet call slip_packet_input. No output
- * buffering, input buffered by stdio.
- */
-void
-serial_input(FILE *inslip)
+static unsigned char inbuf[2048];
+static int inbufptr;
+/* Set when the last byte read was SLIP_ESC */
+static uint8_t inbuf_esc;
+/*---------------------------------------------------------------------------*/
+static void
+input_frame(void)
 {
-  static unsigned char inbuf[2048];
-  static int inbufptr = 0;
-  int ret, i;
-  unsigned char c;
-
-#ifdef linux
-  ret = fread(&c, 1, 1, inslip);
-  if(ret == -1 || ret == 0) {
-    err(1, "serial_input: read");
-  }
-  goto after_fread;
-#endif
+  int i;
 
-read_more:
-  if(inbufptr >= sizeof(inbuf)) {
-    fprintf(stderr, "*** dropping large %d byte packet\n", inbufptr);
-    inbufptr = 0;
-  }
-  ret = fread(&c, 1, 1, inslip);
-#ifdef linux
-after_fread:
-#endif
-  if(ret == -1) {
-    err(1, "serial_input: read");
-  }
-  if(ret == 0) {
-    clearerr(inslip);
+  if(inbufptr == 0) {
     return;
   }
-  slip_received++;
-  switch(c) {
-  case SLIP_END:
-    if(inbufptr > 0) {
-      if(inbuf[0] == '!') {
-        command_context = CMD_CONTEXT_RADIO;
-        cmd_input(inbuf, inbufptr);
-      } else if(inbuf[0] == '?') {
+  slip_frames_received++;
+  if(inbuf[0] == '!') {
+    command_context = CMD_CONTEXT_RADIO;
+    cmd_input(inbuf, inbufptr);
+  } else if(inbuf[0] == '?') {
 #define DEBUG_LINE_MARKER '\r'
-      } else if(inbuf[0] == DEBUG_LINE_MARKER) {
-        fwrite(inbuf + 1, inbufptr - 1, 1, stdout);
-      } else if(is_sensible_string(inbuf, inbufptr)) {
-        if(slip_config_verbose == 1) {   /* strings already echoed below for verbose>1 */
-          fwrite(inbuf, inbufptr, 1, stdout);
-        }
-      } else {
-        if(slip_config_verbose > 2) {
-          printf("Packet from SLIP of length %d - write TUN\n", inbufptr);
-          if(slip_config_verbose > 4) {
+  } else if(inbuf[0] == DEBUG_LINE_MARKER) {
+    fwrite(inbuf + 1, inbufptr - 1, 1, stdout);
+  } else if(is_sensible_string(inbuf, inbufptr)) {
+    if(slip_config_verbose == 1) {   /* strings already echoed below for verbose>1 */
+      fwrite(inbuf, inbufptr, 1, stdout);
+    }
+  } else {
+    if(slip_config_verbose > 2) {
+      printf("Packet from SLIP of length %d - write TUN\n", inbufptr);
+      if(slip_config_verbose > 4) {
 #if WIRESHARK_IMPORT_FORMAT
-            printf("0000");
-            for(i = 0; i < inbufptr; i++) {
-              printf(" %02x", inbuf[i]);
-            }
+        printf("0000");
+        for(i = 0; i < inbufptr; i++) {
+          printf(" %02x", inbuf[i]);
+        }
 #else
-            printf("         ");
-            for(i = 0; i < inbufptr; i++) {
-              printf("%02x", inbuf[i]);
-              if((i & 3) == 3) {
-                printf(" ");
-              }
-              if((i & 15) == 15) {
-                printf("\n         ");
-              }
-            }
-#endif
-            printf("\n");
+        printf("         ");
+        for(i = 0; i < inbufptr; i++) {
+          printf("%02x", inbuf[i]);
+          if((i & 3) == 3) {
+            printf(" ");
+          }
+          if((i & 15) == 15) {
+            printf("\n         ");
           }
         }
-        slip_packet_input(inbuf, inbufptr);
+#endif
+        printf("\n");
       }
-      inbufptr = 0;
     }
-    break;
+    slip_packet_input(inbuf, inbufptr);
+  }
+  inbufptr = 0;
+}
+/*---------------------------------------------------------------------------*/
+static void
+input_byte(unsigned char c)
+{
+  if(inbufptr >= sizeof(inbuf)) {
+    fprintf(stderr, "*** dropping large %d byte packet\n", inbufptr);
+    inbufptr = 0;
+  }
+  inbuf[inbufptr++] = c;
 
-  case SLIP_ESC:
-    if(fread(&c, 1, 1, inslip) != 1) {
-      clearerr(inslip);
-      /* Put ESC back and give up! */
-      ungetc(SLIP_ESC, inslip);
-      return;
+  /* Echo lines as they are received for verbose=2,3,5+ */
+  /* Echo all printable characters for verbose==4 */
+  if(slip_config_verbose == 4) {
+    if(c == 0 || c == '\r' || c == '\n' || c == '\t' || (c >= ' ' && c <= '~')) {
+      fwrite(&c, 1, 1, stdout);
     }
-
-    switch(c) {
-    case SLIP_ESC_END:
-      c = SLIP_END;
-      break;
-    case SLIP_ESC_ESC:
-      c = SLIP_ESC;
-      break;
+  } else if(slip_config_verbose >= 2) {
+    if(c == '\n' && is_sensible_string(inbuf, inbufptr)) {
+      fwrite(inbuf, inbufptr, 1, stdout);
+      inbufptr = 0;
     }
-    /* FALLTHROUGH */
-  default:
-    inbuf[inbufptr++] = c;
-
-    /* Echo lines as they are received for verbose=2,3,5+ */
-    /* Echo all printable characters for verbose==4 */
-    if(slip_config_verbose == 4) {
-      if(c == 0 || c == '\r' || c == '\n' || c == '\t' || (c >= ' ' && c <= '~')) {
-        fwrite(&c, 1, 1, stdout);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Decode a chunk of SLIP data, which may end in the middle of a frame */
+static void
+slip_decode(const unsigned char *buf, int len)
+{
+  const unsigned char *end = buf + len;
+  const unsigned char *run;
+
+  while(buf < end) {
+    if(inbuf_esc) {
+      inbuf_esc = 0;
+      if(*buf == SLIP_ESC_END) {
+        input_byte(SLIP_END);
+      } else if(*buf == SLIP_ESC_ESC) {
+        input_byte(SLIP_ESC);
+      } else {
+        input_byte(*buf);
       }
+      buf++;
+    } else if(*buf == SLIP_END) {
+      input_frame();
+      buf++;
+    } else if(*buf == SLIP_ESC) {
+      inbuf_esc = 1;
+      buf++;
     } else if(slip_config_verbose >= 2) {
-      if(c == '\n' && is_sensible_string(inbuf, inbufptr)) {
-        fwrite(inbuf, inbufptr, 1, stdout);
-        inbufptr = 0;
+      input_byte(*buf++);
+    } else {
+      /* Copy a run of ordinary bytes at once */
+      for(run = buf; run < end && !slip_special[*run]; run++);
+      if(inbufptr + (run - buf) > sizeof(inbuf)) {
+        while(buf < run) {
+          input_byte(*buf++);
+        }
+      } else {
+        memcpy(inbuf + inbufptr, buf, run - buf);
+        inbufptr += run - buf;
+        buf = run;
       }
     }
-    break;
   }
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * Read from serial in chunks, and call slip_packet_input for each
+ * packet completed. The descriptor is non-blocking.
+ */
+void
+serial_input(int fd)
+{
+  static unsigned char rxbuf[SLIP_DEV_BUF_SIZE];
+  ssize_t n;
+  int first = 1;
 
-  goto read_more;
+  for(;;) {
+    n = read(fd, rxbuf, sizeof(rxbuf));
+    if(n == -1 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+      return;
+    }
+    if(n == -1 || (n == 0 && first)) {
+      /* Readable but nothing to read: the other end is gone */
+      err(1, "serial_input: read");
+    }
+    if(n == 0) {
+      return;
+    }
+    first = 0;
+    slip_reads++;
+    slip_received += n;
+    slip_decode(rxbuf, n);
+    if(n < sizeof(rxbuf)) {
+      return;
+    }
+  }
 }
-unsigned char slip_buf[2048];
-int slip_end, slip_begin, slip_packet_end, slip_packet_count;
+/*---------------------------------------------------------------------------*/
+/* Output queue: txbuf[tx_begin, tx_end) holds the encoded frames not
+   written yet, and tx_frame_end[] the offsets at which they end. */
+static unsigned char txbuf[SLIP_DEV_BUF_SIZE];
+static int tx_begin, tx_end;
+static int tx_frame_end[SLIP_DEV_TX_FRAMES];
+static int tx_frame_first, tx_frame_count;
 static struct timer send_delay_timer;
 /* delay between slip packets */
 static clock_time_t send_delay = SEND_DELAY;
 /*---------------------------------------------------------------------------*/
+/* Make room for len more bytes at the end of the output queue */
+static int
+tx_reserve(int len)
+{
+  int i;
+
+  if(sizeof(txbuf) - tx_end < len && tx_begin > 0) {
+    memmove(txbuf, txbuf + tx_begin, tx_end - tx_begin);
+    for(i = 0; i < tx_frame_count; i++) {
+      tx_frame_end[(tx_frame_first + i) % SLIP_DEV_TX_FRAMES] -= tx_begin;
+    }
+    tx_end -= tx_begin;
+    tx_begin = 0;
+  }
+  return sizeof(txbuf) - tx_end >= len;
+}
+/*---------------------------------------------------------------------------*/
 static void
-slip_send(int fd, unsigned char c)
+slip_queue_frame(const uint8_t *p, int len)
 {
-  if(slip_end >= sizeof(slip_buf)) {
-    err(1, "slip_send overflow");
-  }
-  slip_buf[slip_end] = c;
-  slip_end++;
-  slip_sent++;
-  if(c == SLIP_END) {
-    /* Full packet received. */
-    slip_packet_count++;
-    if(slip_packet_end == 0) {
-      slip_packet_end = slip_end;
+  unsigned char *out;
+  int i, run;
+
+  /* At worst, every byte is escaped */
+  if(tx_frame_count == SLIP_DEV_TX_FRAMES || !tx_reserve(2 * len + 1)) {
+    fprintf(stderr, "*** dropping %d byte packet, SLIP output queue full\n",
+            len);
+    return;
+  }
+
+  out = txbuf + tx_end;
+  for(i = 0; i < len; i++) {
+    /* Copy a run of ordinary bytes at once */
+    for(run = i; run < len && !slip_special[p[run]]; run++);
+    memcpy(out, p + i, run - i);
+    out += run - i;
+    i = run;
+    if(i < len) {
+      *out++ = SLIP_ESC;
+      *out++ = p[i] == SLIP_END ? SLIP_ESC_END : SLIP_ESC_ESC;
     }
   }
+  *out++ = SLIP_END;
+
+  slip_sent += out - (txbuf + tx_end);
+  tx_end = out - txbuf;
+  tx_frame_end[(tx_frame_first + tx_frame_count) % SLIP_DEV_TX_FRAMES] = tx_end;
+  tx_frame_count++;
 }
 /*---------------------------------------------------------------------------*/
 int
 slip_empty()
 {
-  return slip_packet_end == 0;
+  return tx_frame_count == 0;
 }
 /*---------------------------------------------------------------------------*/
 void
@@ -325,36 +418,30 @@ slip_flushbuf(int fd)
     return;
   }
 
-  n = write(fd, slip_buf + slip_begin, slip_packet_end - slip_begin);
+  /* Write all queued frames at once, unless there must be a delay
+     between them */
+  n = write(fd, txbuf + tx_begin,
+            (send_delay > 0 ? tx_frame_end[tx_frame_first] : tx_end) - tx_begin);
 
   if(n == -1 && errno != EAGAIN) {
     err(1, "slip_flushbuf write failed");
   } else if(n == -1) {
     PROGRESS("Q");		/* Outqueue is full! */
   } else {
-    slip_begin += n;
-    if(slip_begin == slip_packet_end) {
-      slip_packet_count--;
-      if(slip_end > slip_packet_end) {
-        memmove(slip_buf, slip_buf + slip_packet_end,
-               slip_end - slip_packet_end);
-      }
-      slip_end -= slip_packet_end;
-      slip_begin = slip_packet_end = 0;
-      if(slip_end > 0) {
-        /* Find end of next slip packet */
-        for(n = 1; n < slip_end; n++) {
-          if(slip_buf[n] == SLIP_END) {
-            slip_packet_end = n + 1;
-            break;
-          }
-        }
-        /* a delay between slip packets to avoid losing data */
-        if(send_delay > 0) {
-          timer_set(&send_delay_timer, send_delay);
-        }
+    slip_writes++;
+    tx_begin += n;
+    while(tx_frame_count > 0 && tx_frame_end[tx_frame_first] <= tx_begin) {
+      tx_frame_first = (tx_frame_first + 1) % SLIP_DEV_TX_FRAMES;
+      tx_frame_count--;
+      slip_frames_sent++;
+      /* a delay between slip packets to avoid losing data */
+      if(send_delay > 0 && tx_frame_count > 0) {
+        timer_set(&send_delay_timer, send_delay);
       }
     }
+    if(tx_frame_count == 0) {
+      tx_begin = tx_end = 0;
+    }
   }
 }
 /*---------------------------------------------------------------------------*/
@@ -392,27 +479,7 @@ write_to_serial(int outfd, const uint8_t *inbuf, int len)
     }
   }
 
-  /* It would be ``nice'' to send a SLIP_END here but it's not
-   * really necessary.
-   */
-  /* slip_send(outfd, SLIP_END); */
-
-  for(i = 0; i < len; i++) {
-    switch(p[i]) {
-    case SLIP_END:
-      slip_send(outfd, SLIP_ESC);
-      slip_send(outfd, SLIP_ESC_END);
-      break;
-    case SLIP_ESC:
-      slip_send(outfd, SLIP_ESC);
-      slip_send(outfd, SLIP_ESC_ESC);
-      break;
-    default:
-      slip_send(outfd, p[i]);
-      break;
-    }
-  }
-  slip_send(outfd, SLIP_END);
+  slip_queue_frame(p, len);
   PROGRESS("t");
 }
 /*---------------------------------------------------------------------------*/
@@ -499,7 +566,7 @@ static void
 handle_fd(fd_set *rset, fd_set *wset)
 {
   if(FD_ISSET(slipfd, rset)) {
-    serial_input(inslip);
+    serial_input(slipfd);
   }
 
   if(FD_ISSET(slipfd, wset)) {
@@ -507,11 +574,14 @@ handle_fd(fd_set *rset, fd_set *wset)
   }
 }
 /*---------------------------------------------------------------------------*/
-static const struct select_callback slip_callback = { set_fd, handle_fd };
+/* Edge-triggered: serial_input() reads until the descriptor is drained */
+static const struct select_callback slip_callback = { set_fd, handle_fd, 1 };
 /*---------------------------------------------------------------------------*/
 void
 slip_init(void)
 {
+  uint8_t end;
+
   setvbuf(stdout, NULL, _IOLBF, 0); /* Line buffered output. */
 
   if(slip_config_host != NULL) {
@@ -559,10 +629,11 @@ slip_init(void)
   }
 
   timer_set(&send_delay_timer, 0);
-  slip_send(slipfd, SLIP_END);
-  inslip = fdopen(slipfd, "r");
-  if(inslip == NULL) {
-    err(1, "slip_init: fdopen");
+  /* Start with a SLIP_END to flush any noise on the line. It is written
+     directly, as it is not a frame of its own. */
+  end = SLIP_END;
+  if(write(slipfd, &end, 1) == -1 && errno != EAGAIN) {
+    err(1, "slip_init write failed");
   }
 }
 /*---------------------------------------------------------------------------*/
@@ -918,7 +918,7 @@ PT_THREAD(cmd_llsec_setkey(struct pt *pt, shell_output_func output, char *args))
         csma_security_set_key(key, (const uint8_t *) args);
         SHELL_OUTPUT(output, "Set key for index %d\n", key);
       } else {
-        SHELL_OUTPUT(output, "Wrong length of key: '%s' (%d)\n", args, strlen(args));
+        SHELL_OUTPUT(output, "Wrong length of key: '%s' (%d)\n", args, (int)strlen(args));
       }
 #else
       SHELL_OUTPUT(output, "Set key not supported.\n");
@@ -928,6 +928,23 @@ PT_THREAD(cmd_llsec_setkey(struct pt *pt, shell_output_func output, char *args))
   }
   PT_END(pt);
 }
+#if MAC_CONF_WITH_CSMA
+/*---------------------------------------------------------------------------*/
+static
+PT_THREAD(cmd_llsec_key_cache(struct pt *pt, shell_output_func output, char *args))
+{
+  struct csma_security_key_cache_stats stats;
+
+  PT_BEGIN(pt);
+
+  csma_security_get_key_cache_stats(&stats);
+  SHELL_OUTPUT(output, "LLSEC key cache: %u entries, %lu hits, %lu misses\n",
+               stats.entries, (unsigned long)stats.hits,
+               (unsigned long)stats.misses);
+
+  PT_END(pt);
+}
+#endif /* MAC_CONF_WITH_CSMA */
 #endif /* LLSEC802154_ENABLED */
 /*---------------------------------------------------------------------------*/
 void
@@ -1014,6 +1031,9 @@ const struct shell_command_t builtin_shell_commands[] = {
 #if LLSEC802154_ENABLED
   { "llsec-set-level", cmd_llsec_setlv, "'> llsec-set-level <lv>': Set the level of link layer security (show if no lv argument)"},
   { "llsec-set-key", cmd_llsec_setkey, "'> llsec-set-key <id> <key>': Set the key of link layer security"},
+#if MAC_CONF_WITH_CSMA
+  { "llsec-key-cache", cmd_llsec_key_cache, "'> llsec-key-cache': Show the statistics of the link layer security key cache"},
+#endif /* MAC_CONF_WITH_CSMA */
 #endif /* LLSEC802154_ENABLED */
   { NULL, NULL, NULL },
 };
@@ -47,6 +47,7 @@
 #include "index.h"
 #include "relation.h"
 #include "result.h"
+#include "storage.h"
 #include "aql.h"
 
 static aql_adt_t adt;
@@ -154,7 +155,11 @@ aql_execute(db_handle_t *handle, aql_adt_t *adt)
     result = relation_select(handle, rel, adt);
     break;
   case AQL_TYPE_INSERT:
-    result = relation_insert(rel, adt->values);
+    if(adt->row_count == 1) {
+      result = relation_insert(rel, adt->values);
+    } else if(adt->value_count == adt->row_count * rel->attribute_count) {
+      result = relation_insert_batch(rel, adt->values, adt->row_count);
+    }
     break;
 #if DB_FEATURE_JOIN
   case AQL_TYPE_JOIN:
@@ -201,6 +206,10 @@ db_query(db_handle_t *handle, const char *format, ...)
     clear_handle(handle);
   }
 
+#if DB_FEATURE_STORAGE_STATS
+  storage_reset_stats();
+#endif
+
   if(AQL_ERROR(aql_parse(&adt, query_string))) {
     return DB_PARSING_ERROR;
   }
@@ -245,10 +245,14 @@ PARSER(values)
   NEXT;
   switch(TOKEN) {
   case STRING_VALUE:
-    AQL_ADD_VALUE(adt, DOMAIN_STRING, VALUE);
+    if(DB_ERROR(AQL_ADD_VALUE(adt, DOMAIN_STRING, VALUE))) {
+      RETURN(SYNTAX_ERROR);
+    }
     break;
   case INTEGER_VALUE:
-    AQL_ADD_VALUE(adt, DOMAIN_INT, VALUE);
+    if(DB_ERROR(AQL_ADD_VALUE(adt, DOMAIN_INT, VALUE))) {
+      RETURN(SYNTAX_ERROR);
+    }
     break;
   default:
     RETURN(SYNTAX_ERROR);
@@ -524,17 +528,34 @@ PARSER(select)
 
 PARSER(insert)
 {
+  unsigned row_length;
+
   AQL_SET_TYPE(adt, AQL_TYPE_INSERT);
 
-  CONSUME(LEFT_PAREN);
+  /* Parse one or more comma-separated rows of the same length. */
+  row_length = 0;
+  do {
+    CONSUME(LEFT_PAREN);
+
+    if(!PARSE(values)) {
+      RETURN(SYNTAX_ERROR);
+    }
 
-  if(!PARSE(values)) {
+    CONSUME(RIGHT_PAREN);
+
+    if(adt->row_count++ == 0) {
+      row_length = adt->value_count;
+    } else if(adt->value_count != adt->row_count * row_length) {
+      RETURN(SYNTAX_ERROR);
+    }
+
+    NEXT;
+  } while(TOKEN == COMMA);
+
+  if(TOKEN != INTO) {
     RETURN(SYNTAX_ERROR);
   }
 
-  CONSUME(RIGHT_PAREN);
-  CONSUME(INTO);
-
   if(!PARSE(relations)) {
     RETURN(SYNTAX_ERROR);
   }
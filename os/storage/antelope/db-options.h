@@ -70,6 +70,18 @@
 #define DB_FEATURE_INTEGRITY		0
 #endif /* DB_FEATURE_INTEGRITY */
 
+/* Cache pages of tuple files in RAM. Scans read a page of rows at a
+   time, and appended rows are written back when a page is full, or
+   when the relation is unloaded or read. */
+#ifndef DB_FEATURE_PAGE_CACHE
+#define DB_FEATURE_PAGE_CACHE		0
+#endif /* DB_FEATURE_PAGE_CACHE */
+
+/* Count the file system calls made by the storage layer. */
+#ifndef DB_FEATURE_STORAGE_STATS
+#define DB_FEATURE_STORAGE_STATS	0
+#endif /* DB_FEATURE_STORAGE_STATS */
+
 /*----------------------------------------------------------------------------*/
 
 /* Configuration parameters that may be trimmed to save space. */
@@ -105,6 +117,25 @@
 #endif /* DB_MAX_ELEMENT_SIZE */
 
 
+/* The size in bytes of a page in the tuple page cache. Relations
+   with rows larger than this bypass the cache. */
+#ifndef DB_PAGE_CACHE_SIZE
+#define DB_PAGE_CACHE_SIZE		128
+#endif /* DB_PAGE_CACHE_SIZE */
+
+/* The number of pages in the tuple page cache. Each relation that
+   is read or written concurrently uses one page. */
+#ifndef DB_PAGE_CACHE_PAGES
+#define DB_PAGE_CACHE_PAGES		2
+#endif /* DB_PAGE_CACHE_PAGES */
+
+/* The number of rows that relation_insert_batch() stores with a single
+   write and passes to the indexes at once. The rows are buffered on
+   the stack. */
+#ifndef DB_INSERT_BATCH_ROWS
+#define DB_INSERT_BATCH_ROWS		8
+#endif /* DB_INSERT_BATCH_ROWS */
+
 /* The maximum size of the LVM bytecode compiled from a
    single database query. */
 #ifndef DB_VM_BYTECODE_SIZE
@@ -134,6 +165,12 @@
 #define AQL_ATTRIBUTE_LIMIT    		5
 #endif /* AQL_ATTRIBUTE_LIMIT */
 
+/* The maximum number of values in a single query. A multi-row INSERT
+   query needs one value per attribute and row. */
+#ifndef AQL_VALUE_LIMIT
+#define AQL_VALUE_LIMIT    		AQL_ATTRIBUTE_LIMIT
+#endif /* AQL_VALUE_LIMIT */
+
 /*----------------------------------------------------------------------------*/
 
 /*
@@ -78,6 +78,7 @@ index_api_t index_inline = {
   null_op,
   null_op,
   insert,
+  NULL,
   delete,
   get_next
 };
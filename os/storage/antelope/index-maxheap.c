@@ -139,6 +139,7 @@ static db_result_t destroy(index_t *);
 static db_result_t load(index_t *);
 static db_result_t release(index_t *);
 static db_result_t insert(index_t *, attribute_value_t *, tuple_id_t);
+static db_result_t insert_batch(index_t *, index_entry_t *, unsigned);
 static db_result_t delete(index_t *, attribute_value_t *);
 static tuple_id_t get_next(index_iterator_t *);
 
@@ -150,6 +151,7 @@ index_api_t index_maxheap = {
   load,
   release,
   insert,
+  insert_batch,
   delete,
   get_next
 };
@@ -444,21 +446,29 @@ bucket_split(heap_t *heap, int bucket_id)
   return 1;
 }
 
-int
-insert_item(heap_t *heap, maxheap_key_t key, maxheap_value_t value)
+static int
+find_bucket(heap_t *heap, maxheap_key_t key, int *heap_iterator)
 {
-  int heap_iterator;
   int bucket_id, last_good_bucket_id;
-  struct key_value_pair pair;
 
-  for(heap_iterator = 0, last_good_bucket_id = -1;;) {
-    bucket_id = heap_find(heap, key, &heap_iterator);
+  for(*heap_iterator = 0, last_good_bucket_id = -1;;) {
+    bucket_id = heap_find(heap, key, heap_iterator);
     if(bucket_id < 0) {
       break;
     }
     last_good_bucket_id = bucket_id;
   }
-  bucket_id = last_good_bucket_id;
+  return last_good_bucket_id;
+}
+
+int
+insert_item(heap_t *heap, maxheap_key_t key, maxheap_value_t value)
+{
+  int heap_iterator;
+  int bucket_id;
+  struct key_value_pair pair;
+
+  bucket_id = find_bucket(heap, key, &heap_iterator);
 
   if(bucket_id < 0) {
     PRINTF("DB: No bucket for key %ld\n", (long)key);
@@ -659,6 +669,75 @@ insert(index_t *index, attribute_value_t *key, tuple_id_t value)
   return DB_OK;
 }
 
+static db_result_t
+insert_batch(index_t *index, index_entry_t *entries, unsigned count)
+{
+  heap_t *heap;
+  struct key_value_pair pairs[count];
+  maxheap_key_t hashed_keys[count];
+  struct key_value_pair pair;
+  maxheap_key_t hashed_key;
+  heap_node_t node;
+  unsigned long offset;
+  unsigned i, j, run;
+  int heap_iterator;
+  int bucket_id;
+
+  heap = (heap_t *)index->opaque_data;
+
+  /* Sort the pairs by their hashed keys, which select the buckets. */
+  for(i = 0; i < count; i++) {
+    pair.key = (maxheap_key_t)db_value_to_long(&entries[i].value);
+    pair.value = (maxheap_value_t)entries[i].tuple_id;
+    hashed_key = transform_key(pair.key);
+    for(j = i; j > 0 && hashed_keys[j - 1] > hashed_key; j--) {
+      pairs[j] = pairs[j - 1];
+      hashed_keys[j] = hashed_keys[j - 1];
+    }
+    pairs[j] = pair;
+    hashed_keys[j] = hashed_key;
+  }
+
+  /* Merge the sorted pairs into the buckets. The pairs that fall into
+     the range of the same bucket are appended with a single write. */
+  for(i = 0; i < count; i += run) {
+    bucket_id = find_bucket(heap, pairs[i].key, &heap_iterator);
+    if(bucket_id < 0 || heap_read(heap, bucket_id, &node) == 0) {
+      PRINTF("DB: No bucket for key %ld\n", (long)pairs[i].key);
+      return DB_INDEX_ERROR;
+    }
+
+    if(heap->next_free_slot[bucket_id] == BUCKET_SIZE) {
+      /* Let the insertion of a single item split the bucket. */
+      if(insert_item(heap, pairs[i].key, pairs[i].value) == 0) {
+        return DB_INDEX_ERROR;
+      }
+      run = 1;
+      continue;
+    }
+
+    for(run = 1;
+        i + run < count && hashed_keys[i + run] <= node.max &&
+        heap->next_free_slot[bucket_id] + run < BUCKET_SIZE;
+        run++);
+
+    offset = (unsigned long)bucket_id * sizeof(bucket_t);
+    offset += heap->next_free_slot[bucket_id] * sizeof(struct key_value_pair);
+
+    if(DB_ERROR(storage_write(heap->bucket_storage, &pairs[i], offset,
+                              run * sizeof(struct key_value_pair)))) {
+      return DB_INDEX_ERROR;
+    }
+
+    heap->next_free_slot[bucket_id] += run;
+
+    PRINTF("DB: Inserted %u keys into the heap at bucket_id %d\n",
+           run, bucket_id);
+  }
+
+  return DB_OK;
+}
+
 static db_result_t
 delete(index_t *index, attribute_value_t *value)
 {
@@ -60,6 +60,7 @@ index_api_t index_memhash = {
   load,
   release,
   insert,
+  NULL,
   delete,
   get_next
 };
@@ -230,6 +230,25 @@ index_insert(index_t *index, attribute_value_t *value,
   return index->api->insert(index, value, tuple_id);
 }
 
+db_result_t
+index_insert_batch(index_t *index, index_entry_t *entries, unsigned count)
+{
+  unsigned i;
+
+  if(index->api->insert_batch != NULL) {
+    return index->api->insert_batch(index, entries, count);
+  }
+
+  for(i = 0; i < count; i++) {
+    if(DB_ERROR(index->api->insert(index, &entries[i].value,
+                                   entries[i].tuple_id))) {
+      return DB_INDEX_ERROR;
+    }
+  }
+
+  return DB_OK;
+}
+
 db_result_t
 index_delete(index_t *index, attribute_value_t *value)
 {
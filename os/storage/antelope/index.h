@@ -79,6 +79,12 @@ struct index_iterator {
 };
 typedef struct index_iterator index_iterator_t;
 
+struct index_entry {
+  attribute_value_t value;
+  tuple_id_t tuple_id;
+};
+typedef struct index_entry index_entry_t;
+
 struct index_api {
   index_type_t type;
   uint8_t flags;
@@ -87,6 +93,7 @@ struct index_api {
   db_result_t (*load)(index_t *);
   db_result_t (*release)(index_t *);
   db_result_t (*insert)(index_t *, attribute_value_t *, tuple_id_t);
+  db_result_t (*insert_batch)(index_t *, index_entry_t *, unsigned);
   db_result_t (*delete)(index_t *, attribute_value_t *);
   tuple_id_t (*get_next)(index_iterator_t *);
 };
@@ -103,6 +110,7 @@ db_result_t index_destroy(index_t *);
 db_result_t index_load(relation_t *, attribute_t *);
 db_result_t index_release(index_t *);
 db_result_t index_insert(index_t *, attribute_value_t *, tuple_id_t);
+db_result_t index_insert_batch(index_t *, index_entry_t *, unsigned);
 db_result_t index_delete(index_t *, attribute_value_t *);
 db_result_t index_get_iterator(index_iterator_t *, index_t *,
                                attribute_value_t *, attribute_value_t *);
@@ -472,11 +472,10 @@ relation_remove(char *name, int remove_tuples)
   return result;
 }
 
-db_result_t
-relation_insert(relation_t *rel, attribute_value_t *values)
+static db_result_t
+encode_row(relation_t *rel, attribute_value_t *values, unsigned char *record)
 {
   attribute_t *attr;
-  unsigned char record[rel->row_length];
   unsigned char *ptr;
   attribute_value_t *value;
   db_result_t result;
@@ -533,20 +532,97 @@ relation_insert(relation_t *rel, attribute_value_t *values)
 #endif /* DEBUG */
 
     ptr += attr->element_size;
-    if(attr->index != NULL) {
+  }
+
+  PRINTF(")\n");
+
+  return DB_OK;
+}
+
+db_result_t
+relation_insert(relation_t *rel, attribute_value_t *values)
+{
+  attribute_t *attr;
+  unsigned char record[rel->row_length];
+  attribute_value_t *value;
+  db_result_t result;
+
+  result = encode_row(rel, values, record);
+  if(DB_ERROR(result)) {
+    return result;
+  }
+
+  for(attr = list_head(rel->attributes), value = values;
+      attr != NULL;
+      attr = attr->next, value++) {
+    if(attr->index != NULL && !(attr->flags & ATTRIBUTE_FLAG_INVALID)) {
       if(DB_ERROR(index_insert(attr->index, value, rel->next_row))) {
         return DB_INDEX_ERROR;
       }
     }
   }
 
-  PRINTF(")\n");
-
   rel->cardinality++;
   rel->next_row++;
   return storage_put_row(rel, record);
 }
 
+db_result_t
+relation_insert_batch(relation_t *rel, attribute_value_t *values,
+                      unsigned count)
+{
+  attribute_t *attr;
+  unsigned char records[DB_INSERT_BATCH_ROWS * rel->row_length];
+  index_entry_t entries[DB_INSERT_BATCH_ROWS];
+  attribute_value_t *value;
+  unsigned rows;
+  unsigned i;
+  db_result_t result;
+
+  while(count > 0) {
+    rows = count < DB_INSERT_BATCH_ROWS ? count : DB_INSERT_BATCH_ROWS;
+
+    /* Validate and encode all rows of the batch before any of them
+       is stored or indexed. */
+    for(i = 0; i < rows; i++) {
+      result = encode_row(rel, values + i * rel->attribute_count,
+                          records + i * rel->row_length);
+      if(DB_ERROR(result)) {
+        return result;
+      }
+    }
+
+    /* Give each index the keys of the whole batch at once, so that
+       it can insert them in the order that suits its structure. */
+    for(attr = list_head(rel->attributes), value = values;
+        attr != NULL;
+        attr = attr->next, value++) {
+      if(attr->index == NULL || (attr->flags & ATTRIBUTE_FLAG_INVALID)) {
+        continue;
+      }
+      for(i = 0; i < rows; i++) {
+        entries[i].value = value[i * rel->attribute_count];
+        entries[i].tuple_id = rel->next_row + i;
+      }
+      if(DB_ERROR(index_insert_batch(attr->index, entries, rows))) {
+        return DB_INDEX_ERROR;
+      }
+    }
+
+    rel->cardinality += rows;
+    rel->next_row += rows;
+    result = storage_put_rows(rel, records, rows);
+    if(DB_ERROR(result)) {
+      return result;
+    }
+
+    values += rows * rel->attribute_count;
+    count -= rows;
+  }
+
+  return DB_OK;
+}
+
 static void
 aggregate(attribute_t *attr, attribute_value_t *value)
 {
@@ -68,6 +68,294 @@ struct index_record {
 
 #define ROW_XOR 0xf6U
 
+#if DB_FEATURE_PAGE_CACHE
+/*
+ * A page holds consecutive rows of one relation, in the same encoding
+ * as in the tuple file. A clean page holds rows read ahead from the
+ * file, whereas a dirty page holds rows appended after the end of the
+ * file that have not yet been written back.
+ */
+struct page {
+  relation_t *rel;
+  tuple_id_t file_rows;
+  tuple_id_t first_row;
+  uint16_t rows;
+  uint8_t dirty;
+  unsigned char data[DB_PAGE_CACHE_SIZE];
+};
+
+static struct page pages[DB_PAGE_CACHE_PAGES];
+static uint8_t next_victim;
+#endif /* DB_FEATURE_PAGE_CACHE */
+
+#if DB_FEATURE_STORAGE_STATS
+static storage_stats_t stats;
+#define STATS_ADD(counter) stats.counter++
+#else
+#define STATS_ADD(counter)
+#endif /* DB_FEATURE_STORAGE_STATS */
+
+static int
+fs_open(const char *name, int flags)
+{
+  STATS_ADD(opens);
+  return cfs_open(name, flags);
+}
+
+static int
+fs_read(int fd, void *buf, unsigned len)
+{
+  STATS_ADD(reads);
+  return cfs_read(fd, buf, len);
+}
+
+static int
+fs_write(int fd, const void *buf, unsigned len)
+{
+  STATS_ADD(writes);
+  return cfs_write(fd, buf, len);
+}
+
+static cfs_offset_t
+fs_seek(int fd, cfs_offset_t offset, int whence)
+{
+  STATS_ADD(seeks);
+  return cfs_seek(fd, offset, whence);
+}
+
+static db_result_t
+append_rows(relation_t *rel, unsigned char *data, unsigned length)
+{
+  cfs_offset_t end;
+  int r;
+#if DB_FEATURE_INTEGRITY
+  int missing_bytes;
+  char buf[rel->row_length];
+#endif
+
+  end = fs_seek(rel->tuple_storage, 0, CFS_SEEK_END);
+  if(end == (cfs_offset_t)-1) {
+    return DB_STORAGE_ERROR;
+  }
+
+#if DB_FEATURE_INTEGRITY
+  missing_bytes = end % rel->row_length;
+  if(missing_bytes > 0) {
+    memset(buf, 0xff, sizeof(buf));
+    r = fs_write(rel->tuple_storage, buf, sizeof(buf));
+    if(r != missing_bytes) {
+      return DB_STORAGE_ERROR;
+    }
+  }
+#endif
+
+  do {
+    r = fs_write(rel->tuple_storage, data, length);
+    if(r < 0) {
+      PRINTF("DB: Failed to store %u bytes\n", length);
+      return DB_STORAGE_ERROR;
+    }
+    data += r;
+    length -= r;
+  } while(length > 0);
+
+  return DB_OK;
+}
+
+#if DB_FEATURE_PAGE_CACHE
+static struct page *
+page_find(relation_t *rel)
+{
+  int i;
+
+  for(i = 0; i < DB_PAGE_CACHE_PAGES; i++) {
+    if(pages[i].rel == rel) {
+      return &pages[i];
+    }
+  }
+  return NULL;
+}
+
+static db_result_t
+page_flush(struct page *page)
+{
+  if(!page->dirty) {
+    return DB_OK;
+  }
+
+  if(DB_ERROR(append_rows(page->rel, page->data,
+                          page->rows * page->rel->row_length))) {
+    return DB_STORAGE_ERROR;
+  }
+
+  PRINTF("DB: Wrote back %u rows to relation %s\n",
+         page->rows, page->rel->name);
+
+  page->file_rows += page->rows;
+  page->rows = 0;
+  page->dirty = 0;
+
+  return DB_OK;
+}
+
+static db_result_t
+page_flush_all(void)
+{
+  int i;
+
+  for(i = 0; i < DB_PAGE_CACHE_PAGES; i++) {
+    if(pages[i].rel != NULL && DB_ERROR(page_flush(&pages[i]))) {
+      return DB_STORAGE_ERROR;
+    }
+  }
+  return DB_OK;
+}
+
+static void
+page_release(relation_t *rel, int flush)
+{
+  struct page *page;
+
+  page = page_find(rel);
+  if(page != NULL) {
+    if(flush && DB_ERROR(page_flush(page))) {
+      PRINTF("DB: Failed to write back the rows of relation %s\n", rel->name);
+    }
+    page->rel = NULL;
+  }
+}
+
+static struct page *
+page_get(relation_t *rel)
+{
+  struct page *page;
+  cfs_offset_t end;
+  int i;
+
+  if(rel->row_length == 0 || rel->row_length > DB_PAGE_CACHE_SIZE) {
+    return NULL;
+  }
+
+  page = page_find(rel);
+  if(page != NULL) {
+    return page;
+  }
+
+  for(i = 0; i < DB_PAGE_CACHE_PAGES; i++) {
+    if(pages[i].rel == NULL) {
+      page = &pages[i];
+      break;
+    }
+  }
+
+  if(page == NULL) {
+    /* Evict the pages in turn. If the write-back fails, the relation
+       falls back to uncached access. */
+    page = &pages[next_victim];
+    next_victim = (next_victim + 1) % DB_PAGE_CACHE_PAGES;
+    if(DB_ERROR(page_flush(page))) {
+      return NULL;
+    }
+    page->rel = NULL;
+  }
+
+  end = fs_seek(rel->tuple_storage, 0, CFS_SEEK_END);
+  if(end == (cfs_offset_t)-1) {
+    return NULL;
+  }
+
+  page->rel = rel;
+  page->file_rows = (tuple_id_t)(end / rel->row_length);
+  page->first_row = 0;
+  page->rows = 0;
+  page->dirty = 0;
+
+  return page;
+}
+
+static db_result_t
+page_get_row(struct page *page, tuple_id_t tuple_id, storage_row_t row)
+{
+  relation_t *rel;
+  tuple_id_t count;
+  int r;
+
+  rel = page->rel;
+
+  if(DB_ERROR(page_flush(page))) {
+    return DB_STORAGE_ERROR;
+  }
+
+  if(tuple_id >= page->file_rows) {
+    return DB_FINISHED;
+  }
+
+  if(tuple_id < page->first_row ||
+     tuple_id >= page->first_row + page->rows) {
+    /* Read ahead from the requested row, since relations are mostly
+       scanned in tuple order. */
+    count = page->file_rows - tuple_id;
+    if(count > DB_PAGE_CACHE_SIZE / rel->row_length) {
+      count = DB_PAGE_CACHE_SIZE / rel->row_length;
+    }
+
+    page->rows = 0;
+
+    if(fs_seek(rel->tuple_storage, (cfs_offset_t)tuple_id * rel->row_length,
+               CFS_SEEK_SET) == (cfs_offset_t)-1) {
+      return DB_STORAGE_ERROR;
+    }
+
+    r = fs_read(rel->tuple_storage, page->data, count * rel->row_length);
+    if(r < 0) {
+      PRINTF("DB: Reading failed on fd %d\n", rel->tuple_storage);
+      return DB_STORAGE_ERROR;
+    } else if(r == 0) {
+      return DB_FINISHED;
+    } else if(r < rel->row_length) {
+      PRINTF("DB: Incomplete record: %d < %d\n", r, rel->row_length);
+      return DB_STORAGE_ERROR;
+    }
+
+    page->first_row = tuple_id;
+    page->rows = r / rel->row_length;
+  }
+
+  memcpy(row, page->data + (tuple_id - page->first_row) * rel->row_length,
+         rel->row_length);
+  row[rel->row_length - 1] ^= ROW_XOR;
+
+  return DB_OK;
+}
+
+static db_result_t
+page_put_row(struct page *page, storage_row_t row)
+{
+  relation_t *rel;
+  unsigned char *ptr;
+
+  rel = page->rel;
+
+  if(!page->dirty) {
+    /* Any rows read ahead are replaced by the appended rows. */
+    page->first_row = page->file_rows;
+    page->rows = 0;
+    page->dirty = 1;
+  }
+
+  ptr = page->data + page->rows * rel->row_length;
+  memcpy(ptr, row, rel->row_length);
+  ptr[rel->row_length - 1] ^= ROW_XOR;
+  page->rows++;
+
+  if(page->rows == DB_PAGE_CACHE_SIZE / rel->row_length) {
+    return page_flush(page);
+  }
+
+  return DB_OK;
+}
+#endif /* DB_FEATURE_PAGE_CACHE */
+
 static void
 merge_strings(char *dest, char *prefix, char *suffix)
 {
@@ -94,7 +382,7 @@ storage_generate_file(char *prefix, unsigned long size)
   }
   return filename;
 #else
-  fd = cfs_open(filename, CFS_WRITE);
+  fd = fs_open(filename, CFS_WRITE);
   cfs_close(fd);
   return fd < 0 ? NULL : filename;
 #endif /* DB_FEATURE_COFFEE */
@@ -104,8 +392,8 @@ db_result_t
 storage_load(relation_t *rel)
 {
   PRINTF("DB: Opening the tuple file %s\n", rel->tuple_filename);
-  rel->tuple_storage = cfs_open(rel->tuple_filename,
-                                CFS_READ | CFS_WRITE | CFS_APPEND);
+  rel->tuple_storage = fs_open(rel->tuple_filename,
+                               CFS_READ | CFS_WRITE | CFS_APPEND);
   if(rel->tuple_storage < 0) {
     PRINTF("DB: Failed to open the tuple file\n");
     return DB_STORAGE_ERROR;
@@ -120,6 +408,10 @@ storage_unload(relation_t *rel)
   if(RELATION_HAS_TUPLES(rel)) {
     PRINTF("DB: Unload tuple file %s\n", rel->tuple_filename);
 
+#if DB_FEATURE_PAGE_CACHE
+    page_release(rel, 1);
+#endif
+
     cfs_close(rel->tuple_storage);
     rel->tuple_storage = -1;
   }
@@ -134,12 +426,12 @@ storage_get_relation(relation_t *rel, char *name)
   struct attribute_record record;
   db_result_t result;
 
-  fd = cfs_open(name, CFS_READ);
+  fd = fs_open(name, CFS_READ);
   if(fd < 0) {
     return DB_STORAGE_ERROR;
   }
 
-  r = cfs_read(fd, rel->name, sizeof(rel->name));
+  r = fs_read(fd, rel->name, sizeof(rel->name));
   if(r != sizeof(rel->name)) {
     cfs_close(fd);
     PRINTF("DB: Failed to read name, got %d of %d bytes\n",
@@ -147,7 +439,7 @@ storage_get_relation(relation_t *rel, char *name)
     return DB_STORAGE_ERROR;
   }
 
-  r = cfs_read(fd, rel->tuple_filename, sizeof(rel->tuple_filename));
+  r = fs_read(fd, rel->tuple_filename, sizeof(rel->tuple_filename));
   if(r != sizeof(rel->name)) {
     cfs_close(fd);
     PRINTF("DB: Failed to read tuple filename\n");
@@ -159,7 +451,7 @@ storage_get_relation(relation_t *rel, char *name)
   /* Read attribute records. */
   result = DB_OK;
   for(i = 0;; i++) {
-    r = cfs_read(fd, &record, sizeof(record));
+    r = fs_read(fd, &record, sizeof(record));
     if(r == 0) {
       break;
     }
@@ -199,12 +491,12 @@ storage_put_relation(relation_t *rel)
   cfs_coffee_reserve(rel->name, DB_COFFEE_CATALOG_SIZE);
 #endif
 
-  fd = cfs_open(rel->name, CFS_WRITE | CFS_READ);
+  fd = fs_open(rel->name, CFS_WRITE | CFS_READ);
   if(fd < 0) {
     return DB_STORAGE_ERROR;
   }
 
-  r = cfs_write(fd, rel->name, sizeof(rel->name));
+  r = fs_write(fd, rel->name, sizeof(rel->name));
   if(r != sizeof(rel->name)) {
     cfs_close(fd);
     cfs_remove(rel->name);
@@ -231,7 +523,7 @@ storage_put_relation(relation_t *rel)
   last_byte = (unsigned char *)&rel->tuple_filename[sizeof(rel->tuple_filename) - 1];
   *last_byte ^= ROW_XOR;
 
-  r = cfs_write(fd, rel->tuple_filename, sizeof(rel->tuple_filename));
+  r = fs_write(fd, rel->tuple_filename, sizeof(rel->tuple_filename));
 
   *last_byte ^= ROW_XOR;
 
@@ -256,7 +548,7 @@ storage_put_attribute(relation_t *rel, attribute_t *attr)
 
   PRINTF("DB: put_attribute(%s, %s)\n", rel->name, attr->name);
 
-  fd = cfs_open(rel->name, CFS_WRITE | CFS_APPEND);
+  fd = fs_open(rel->name, CFS_WRITE | CFS_APPEND);
   if(fd < 0) {
     return DB_STORAGE_ERROR;
   }
@@ -265,7 +557,7 @@ storage_put_attribute(relation_t *rel, attribute_t *attr)
   memcpy(record.name, attr->name, sizeof(record.name));
   record.domain = attr->domain;
   record.element_size = attr->element_size;
-  r = cfs_write(fd, &record, sizeof(record));
+  r = fs_write(fd, &record, sizeof(record));
   if(r != sizeof(record)) {
     cfs_close(fd);
     cfs_remove(rel->name);
@@ -279,6 +571,10 @@ storage_put_attribute(relation_t *rel, attribute_t *attr)
 db_result_t
 storage_drop_relation(relation_t *rel, int remove_tuples)
 {
+#if DB_FEATURE_PAGE_CACHE
+  /* Appended rows are discarded along with the tuple file. */
+  page_release(rel, !remove_tuples);
+#endif
   if(remove_tuples && RELATION_HAS_TUPLES(rel)) {
     cfs_remove(rel->tuple_filename);
   }
@@ -295,23 +591,31 @@ storage_rename_relation(char *old_name, char *new_name)
   int r;
   char buf[64];
 
+#if DB_FEATURE_PAGE_CACHE
+  /* The renamed relation may share its tuple file with a relation
+     that is still loaded, so write back all appended rows. */
+  if(DB_ERROR(page_flush_all())) {
+    return DB_STORAGE_ERROR;
+  }
+#endif /* DB_FEATURE_PAGE_CACHE */
+
   result = DB_STORAGE_ERROR;
   old_fd = new_fd = -1;
 
-  old_fd = cfs_open(old_name, CFS_READ);
-  new_fd = cfs_open(new_name, CFS_WRITE);
+  old_fd = fs_open(old_name, CFS_READ);
+  new_fd = fs_open(new_name, CFS_WRITE);
   if(old_fd < 0 || new_fd < 0) {
     goto error;
   }
 
   for(;;) {
-    r = cfs_read(old_fd, buf, sizeof(buf));
+    r = fs_read(old_fd, buf, sizeof(buf));
     if(r < 0) {
       goto error;
     } else if(r == 0) {
       break;
     }
-    if(cfs_write(new_fd, buf, r) != r) {
+    if(fs_write(new_fd, buf, r) != r) {
       goto error;
     }
   };
@@ -341,13 +645,13 @@ storage_get_index(index_t *index, relation_t *rel, attribute_t *attr)
 
   merge_strings(filename, rel->name, INDEX_NAME_SUFFIX);
 
-  fd = cfs_open(filename, CFS_READ);
+  fd = fs_open(filename, CFS_READ);
   if(fd < 0) {
     return DB_STORAGE_ERROR;
   }
 
   for(result = DB_STORAGE_ERROR;;) {
-    r = cfs_read(fd, &record, sizeof(record));
+    r = fs_read(fd, &record, sizeof(record));
     if(r < sizeof(record)) {
       break;
     }
@@ -377,7 +681,7 @@ storage_put_index(index_t *index)
 
   merge_strings(filename, index->rel->name, INDEX_NAME_SUFFIX);
 
-  fd = cfs_open(filename, CFS_WRITE | CFS_APPEND);
+  fd = fs_open(filename, CFS_WRITE | CFS_APPEND);
   if(fd < 0) {
     return DB_STORAGE_ERROR;
   }
@@ -387,7 +691,7 @@ storage_put_index(index_t *index)
   record.type = index->type;
 
   result = DB_OK;
-  r = cfs_write(fd, &record, sizeof(record));
+  r = fs_write(fd, &record, sizeof(record));
   if(r < sizeof(record)) {
     result = DB_STORAGE_ERROR;
   } else {
@@ -405,6 +709,14 @@ storage_get_row(relation_t *rel, tuple_id_t *tuple_id, storage_row_t row)
 {
   int r;
   tuple_id_t nrows;
+#if DB_FEATURE_PAGE_CACHE
+  struct page *page;
+
+  page = page_get(rel);
+  if(page != NULL) {
+    return page_get_row(page, *tuple_id, row);
+  }
+#endif /* DB_FEATURE_PAGE_CACHE */
 
   if(DB_ERROR(storage_get_row_amount(rel, &nrows))) {
     return DB_STORAGE_ERROR;
@@ -414,12 +726,12 @@ storage_get_row(relation_t *rel, tuple_id_t *tuple_id, storage_row_t row)
     return DB_FINISHED;
   }
 
-  if(cfs_seek(rel->tuple_storage, *tuple_id * rel->row_length, CFS_SEEK_SET) ==
+  if(fs_seek(rel->tuple_storage, *tuple_id * rel->row_length, CFS_SEEK_SET) ==
               (cfs_offset_t)-1) {
     return DB_STORAGE_ERROR;
   }
 
-  r = cfs_read(rel->tuple_storage, row, rel->row_length);
+  r = fs_read(rel->tuple_storage, row, rel->row_length);
   if(r < 0) {
     PRINTF("DB: Reading failed on fd %d\n", rel->tuple_storage);
     return DB_STORAGE_ERROR;
@@ -440,64 +752,88 @@ storage_get_row(relation_t *rel, tuple_id_t *tuple_id, storage_row_t row)
 db_result_t
 storage_put_row(relation_t *rel, storage_row_t row)
 {
-  cfs_offset_t end;
-  unsigned remaining;
-  int r;
   unsigned char *last_byte;
-#if DB_FEATURE_INTEGRITY
-  int missing_bytes;
-  char buf[rel->row_length];
-#endif
-
-  end = cfs_seek(rel->tuple_storage, 0, CFS_SEEK_END);
-  if(end == (cfs_offset_t)-1) {
-    return DB_STORAGE_ERROR;
-  }
+  db_result_t result;
+#if DB_FEATURE_PAGE_CACHE
+  struct page *page;
 
-#if DB_FEATURE_INTEGRITY
-  missing_bytes = end % rel->row_length;
-  if(missing_bytes > 0) {
-    memset(buf, 0xff, sizeof(buf));
-    r = cfs_write(rel->tuple_storage, buf, sizeof(buf));
-    if(r != missing_bytes) {
-      return DB_STORAGE_ERROR;
-    }
+  page = page_get(rel);
+  if(page != NULL) {
+    return page_put_row(page, row);
   }
-#endif
+#endif /* DB_FEATURE_PAGE_CACHE */
 
   /* Ensure that last written byte is separated from 0, to make file
      lengths correct in Coffee. */
   last_byte = row + rel->row_length - 1;
   *last_byte ^= ROW_XOR;
 
-  remaining = rel->row_length;
-  do {
-    r = cfs_write(rel->tuple_storage, row, remaining);
-    if(r < 0) {
-      PRINTF("DB: Failed to store %u bytes\n", remaining);
-      *last_byte ^= ROW_XOR;
-      return DB_STORAGE_ERROR;
-    }
-    row += r;
-    remaining -= r;
-  } while(remaining > 0);
-
-  PRINTF("DB: Stored a of %d bytes\n", rel->row_length);
+  result = append_rows(rel, row, rel->row_length);
+  if(result == DB_OK) {
+    PRINTF("DB: Stored a of %d bytes\n", rel->row_length);
+  }
 
   *last_byte ^= ROW_XOR;
 
-  return DB_OK;
+  return result;
+}
+
+db_result_t
+storage_put_rows(relation_t *rel, storage_row_t rows, unsigned count)
+{
+  unsigned i;
+  db_result_t result;
+#if DB_FEATURE_PAGE_CACHE
+  struct page *page;
+
+  /* Keep the rows in order after any rows buffered in the cache. */
+  page = page_find(rel);
+  if(page != NULL && DB_ERROR(page_flush(page))) {
+    return DB_STORAGE_ERROR;
+  }
+#endif /* DB_FEATURE_PAGE_CACHE */
+
+  for(i = 1; i <= count; i++) {
+    rows[i * rel->row_length - 1] ^= ROW_XOR;
+  }
+
+  result = append_rows(rel, rows, count * rel->row_length);
+
+  for(i = 1; i <= count; i++) {
+    rows[i * rel->row_length - 1] ^= ROW_XOR;
+  }
+
+#if DB_FEATURE_PAGE_CACHE
+  if(page != NULL && result == DB_OK) {
+    page->file_rows += count;
+  }
+#endif /* DB_FEATURE_PAGE_CACHE */
+
+  PRINTF("DB: Stored %u rows of %d bytes\n", count, rel->row_length);
+
+  return result;
 }
 
 db_result_t
 storage_get_row_amount(relation_t *rel, tuple_id_t *amount)
 {
   cfs_offset_t offset;
+#if DB_FEATURE_PAGE_CACHE
+  struct page *page;
+#endif
 
   if(rel->row_length == 0) {
     *amount = 0;
   } else {
-    offset = cfs_seek(rel->tuple_storage, 0, CFS_SEEK_END);
+#if DB_FEATURE_PAGE_CACHE
+    page = page_find(rel);
+    if(page != NULL) {
+      *amount = page->file_rows + (page->dirty ? page->rows : 0);
+      return DB_OK;
+    }
+#endif /* DB_FEATURE_PAGE_CACHE */
+
+    offset = fs_seek(rel->tuple_storage, 0, CFS_SEEK_END);
     if(offset == (cfs_offset_t)-1) {
       return DB_STORAGE_ERROR;
     }
@@ -508,12 +844,40 @@ storage_get_row_amount(relation_t *rel, tuple_id_t *amount)
   return DB_OK;
 }
 
+db_result_t
+storage_flush(relation_t *rel)
+{
+#if DB_FEATURE_PAGE_CACHE
+  struct page *page;
+
+  page = page_find(rel);
+  if(page != NULL) {
+    return page_flush(page);
+  }
+#endif /* DB_FEATURE_PAGE_CACHE */
+  return DB_OK;
+}
+
+#if DB_FEATURE_STORAGE_STATS
+void
+storage_get_stats(storage_stats_t *stats_out)
+{
+  memcpy(stats_out, &stats, sizeof(stats));
+}
+
+void
+storage_reset_stats(void)
+{
+  memset(&stats, 0, sizeof(stats));
+}
+#endif /* DB_FEATURE_STORAGE_STATS */
+
 db_storage_id_t
 storage_open(const char *filename)
 {
   int fd;
 
-  fd = cfs_open(filename, CFS_WRITE | CFS_READ);
+  fd = fs_open(filename, CFS_WRITE | CFS_READ);
 #if DB_FEATURE_COFFEE
   if(fd >= 0) {
     cfs_coffee_set_io_semantics(fd, CFS_COFFEE_IO_FLASH_AWARE);
@@ -537,17 +901,17 @@ storage_read(db_storage_id_t fd,
 
   /* Extend the file if necessary, so that previously unwritten bytes
      will be read in as zeroes. */
-  if(cfs_seek(fd, offset + length, CFS_SEEK_SET) == (cfs_offset_t)-1) {
+  if(fs_seek(fd, offset + length, CFS_SEEK_SET) == (cfs_offset_t)-1) {
     return DB_STORAGE_ERROR;
   }
 
-  if(cfs_seek(fd, offset, CFS_SEEK_SET) == (cfs_offset_t)-1) {
+  if(fs_seek(fd, offset, CFS_SEEK_SET) == (cfs_offset_t)-1) {
     return DB_STORAGE_ERROR;
   }
 
   ptr = buffer;
   while(length > 0) {
-    r = cfs_read(fd, ptr, length);
+    r = fs_read(fd, ptr, length);
     if(r <= 0) {
       return DB_STORAGE_ERROR;
     }
@@ -565,13 +929,13 @@ storage_write(db_storage_id_t fd,
   char *ptr;
   int r;
 
-  if(cfs_seek(fd, offset, CFS_SEEK_SET) == (cfs_offset_t)-1) {
+  if(fs_seek(fd, offset, CFS_SEEK_SET) == (cfs_offset_t)-1) {
     return DB_STORAGE_ERROR;
   }
 
   ptr = buffer;
   while(length > 0) {
-    r = cfs_write(fd, ptr, length);
+    r = fs_write(fd, ptr, length);
     if(r <= 0) {
       return DB_STORAGE_ERROR;
     }
@@ -50,6 +50,20 @@
 
 typedef unsigned char * storage_row_t;
 
+#if DB_FEATURE_STORAGE_STATS
+/* File system calls made by the storage layer since the last reset.
+   The counters are reset at the start of each AQL query. */
+typedef struct storage_stats {
+  unsigned long opens;
+  unsigned long reads;
+  unsigned long writes;
+  unsigned long seeks;
+} storage_stats_t;
+
+void storage_get_stats(storage_stats_t *);
+void storage_reset_stats(void);
+#endif /* DB_FEATURE_STORAGE_STATS */
+
 char *storage_generate_file(char *, unsigned long);
 
 db_result_t storage_load(relation_t *);
@@ -66,7 +80,9 @@ db_result_t storage_put_index(index_t *);
 
 db_result_t storage_get_row(relation_t *, tuple_id_t *, storage_row_t);
 db_result_t storage_put_row(relation_t *, storage_row_t);
+db_result_t storage_put_rows(relation_t *, storage_row_t, unsigned);
 db_result_t storage_get_row_amount(relation_t *, tuple_id_t *);
+db_result_t storage_flush(relation_t *);
 
 db_storage_id_t storage_open(const char *);
 void storage_close(db_storage_id_t);
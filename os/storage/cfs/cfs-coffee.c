@@ -84,6 +84,17 @@
 #define COFFEE_EXTENDED_WEAR_LEVELLING  1
 #endif
 
+/*
+ * Number of entries in an in-RAM index from file name hashes to the start
+ * pages of active files. The index is built by the first scan for a file
+ * name and then kept up to date, so that opening a file reads a single
+ * header and opening a missing file reads none. If there are more files
+ * than entries, Coffee falls back to scanning the storage.
+ */
+#ifndef COFFEE_NAME_INDEX_SIZE
+#define COFFEE_NAME_INDEX_SIZE  0
+#endif
+
 #if COFFEE_START & (COFFEE_SECTOR_SIZE - 1)
 #error COFFEE_START must point to the first byte in a sector.
 #endif
@@ -206,6 +217,27 @@ static struct file_desc coffee_fd_set[COFFEE_FD_SET_SIZE];
 static coffee_page_t next_free;
 static char gc_wait;
 
+#if COFFEE_NAME_INDEX_SIZE
+struct name_index_entry {
+  uint16_t hash;
+  coffee_page_t page;
+};
+
+/* Index states. The index is rebuilt after files have been removed
+   from a storage holding too many files for it. */
+#define NAME_INDEX_UNBUILT 0
+#define NAME_INDEX_VALID   1
+#define NAME_INDEX_FULL    2
+
+static struct name_index_entry name_index[COFFEE_NAME_INDEX_SIZE];
+static uint16_t name_index_count;
+static char name_index_state;
+#endif /* COFFEE_NAME_INDEX_SIZE */
+
+#if COFFEE_STATS
+struct cfs_coffee_stats cfs_coffee_stats;
+#endif /* COFFEE_STATS */
+
 /*---------------------------------------------------------------------------*/
 static void
 write_header(struct file_header *hdr, coffee_page_t page)
@@ -218,6 +250,9 @@ static void
 read_header(struct file_header *hdr, coffee_page_t page)
 {
   COFFEE_READ(hdr, sizeof(*hdr), page * COFFEE_PAGE_SIZE);
+#if COFFEE_STATS
+  cfs_coffee_stats.header_reads++;
+#endif /* COFFEE_STATS */
   if(DEBUG && HDR_ACTIVE(*hdr) && !HDR_VALID(*hdr)) {
     PRINTF("Coffee: Invalid header at page %u!\n", (unsigned)page);
   }
@@ -452,6 +487,111 @@ load_file(coffee_page_t start, struct file_header *hdr)
   return file;
 }
 /*---------------------------------------------------------------------------*/
+#if COFFEE_NAME_INDEX_SIZE
+static uint16_t
+name_hash(const char *name)
+{
+  uint32_t hash = 2166136261UL;
+
+  while(*name != '\0') {
+    hash ^= (unsigned char)*name++;
+    hash *= 16777619UL;
+  }
+  return (uint16_t)(hash ^ (hash >> 16));
+}
+/*---------------------------------------------------------------------------*/
+static void
+name_index_add(const char *name, coffee_page_t page)
+{
+  if(name_index_state != NAME_INDEX_VALID) {
+    return;
+  }
+  if(name_index_count == COFFEE_NAME_INDEX_SIZE) {
+    PRINTF("Coffee: Name index full, scanning for files\n");
+    name_index_state = NAME_INDEX_FULL;
+    return;
+  }
+  name_index[name_index_count].hash = name_hash(name);
+  name_index[name_index_count].page = page;
+  name_index_count++;
+}
+/*---------------------------------------------------------------------------*/
+static void
+name_index_remove(coffee_page_t page)
+{
+  uint16_t i;
+
+  if(name_index_state == NAME_INDEX_FULL) {
+    name_index_state = NAME_INDEX_UNBUILT;
+    return;
+  }
+  for(i = 0; i < name_index_count; i++) {
+    if(name_index[i].page == page) {
+      name_index[i] = name_index[--name_index_count];
+      return;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static int
+name_index_build(void)
+{
+  struct file_header hdr;
+  coffee_page_t page;
+
+  name_index_count = 0;
+  name_index_state = NAME_INDEX_VALID;
+  for(page = 0;
+      page < COFFEE_PAGE_COUNT && name_index_state == NAME_INDEX_VALID;
+      page = next_file(page, &hdr)) {
+    read_header(&hdr, page);
+    if(HDR_ACTIVE(hdr) && !HDR_LOG(hdr)) {
+      name_index_add(hdr.name, page);
+    }
+  }
+#if COFFEE_STATS
+  cfs_coffee_stats.scans++;
+#endif /* COFFEE_STATS */
+  return name_index_state == NAME_INDEX_VALID;
+}
+/*---------------------------------------------------------------------------*/
+static struct file *
+find_indexed_file(const char *name)
+{
+  struct file_header hdr, found_hdr;
+  coffee_page_t found;
+  uint16_t hash;
+  int i;
+
+  /* Several active files can share a name while a log is being merged.
+     Pick the first one in storage, as a scan would. */
+  hash = name_hash(name);
+  found = INVALID_PAGE;
+  for(i = 0; i < name_index_count; i++) {
+    if(name_index[i].hash != hash ||
+       (found != INVALID_PAGE && name_index[i].page > found)) {
+      continue;
+    }
+    read_header(&hdr, name_index[i].page);
+    if(HDR_ACTIVE(hdr) && !HDR_LOG(hdr) && strcmp(name, hdr.name) == 0) {
+      found = name_index[i].page;
+      found_hdr = hdr;
+    }
+  }
+
+  if(found == INVALID_PAGE) {
+    return NULL;
+  }
+
+  for(i = 0; i < COFFEE_MAX_OPEN_FILES; i++) {
+    if(!FILE_FREE(&coffee_files[i]) && coffee_files[i].page == found) {
+      return &coffee_files[i];
+    }
+  }
+  return load_file(found, &found_hdr);
+}
+#endif /* COFFEE_NAME_INDEX_SIZE */
+/*---------------------------------------------------------------------------*/
 static struct file *
 find_file(const char *name)
 {
@@ -459,6 +599,13 @@ find_file(const char *name)
   struct file_header hdr;
   coffee_page_t page;
 
+#if COFFEE_NAME_INDEX_SIZE
+  if(name_index_state == NAME_INDEX_VALID ||
+     (name_index_state == NAME_INDEX_UNBUILT && name_index_build())) {
+    return find_indexed_file(name);
+  }
+#endif /* COFFEE_NAME_INDEX_SIZE */
+
   /* First check if the file metadata is cached. */
   for(i = 0; i < COFFEE_MAX_OPEN_FILES; i++) {
     if(FILE_FREE(&coffee_files[i])) {
@@ -472,6 +619,9 @@ find_file(const char *name)
   }
 
   /* Scan the flash memory sequentially otherwise. */
+#if COFFEE_STATS
+  cfs_coffee_stats.scans++;
+#endif /* COFFEE_STATS */
   for(page = 0; page < COFFEE_PAGE_COUNT; page = next_file(page, &hdr)) {
     read_header(&hdr, page);
     if(HDR_ACTIVE(hdr) && !HDR_LOG(hdr) && strcmp(name, hdr.name) == 0) {
@@ -572,6 +722,9 @@ remove_by_page(coffee_page_t page, int remove_log,
 
   hdr.flags |= HDR_FLAG_OBSOLETE;
   write_header(&hdr, page);
+#if COFFEE_NAME_INDEX_SIZE
+  name_index_remove(page);
+#endif /* COFFEE_NAME_INDEX_SIZE */
 
   gc_wait = 0;
 
@@ -636,6 +789,11 @@ reserve(const char *name, coffee_page_t pages,
   hdr.max_pages = pages;
   hdr.flags = HDR_FLAG_ALLOCATED | flags;
   write_header(&hdr, page);
+#if COFFEE_NAME_INDEX_SIZE
+  if(!(flags & HDR_FLAG_LOG)) {
+    name_index_add(hdr.name, page);
+  }
+#endif /* COFFEE_NAME_INDEX_SIZE */
 
   PRINTF("Coffee: Reserved %u pages starting from %u for file %s\n",
          (unsigned)pages, (unsigned)page, name);
@@ -1340,6 +1498,11 @@ cfs_coffee_format(void)
   memset(&coffee_fd_set, 0, sizeof(coffee_fd_set));
   next_free = 0;
   gc_wait = 1;
+#if COFFEE_NAME_INDEX_SIZE
+  /* The storage is empty, so the index is complete. */
+  name_index_count = 0;
+  name_index_state = NAME_INDEX_VALID;
+#endif /* COFFEE_NAME_INDEX_SIZE */
 
   PRINTF(" done!\n");
 
@@ -140,6 +140,23 @@ int cfs_coffee_set_io_semantics(int fd, unsigned flags);
  */
 int cfs_coffee_format(void);
 
+#ifndef COFFEE_STATS
+#define COFFEE_STATS 0
+#endif
+
+#if COFFEE_STATS
+/**
+ * \brief Counters of storage accesses made by Coffee, kept when
+ *        COFFEE_STATS is set.
+ */
+struct cfs_coffee_stats {
+  unsigned long header_reads; /**< File headers read from the storage. */
+  unsigned long scans;        /**< Scans of the storage for file names. */
+};
+
+extern struct cfs_coffee_stats cfs_coffee_stats;
+#endif /* COFFEE_STATS */
+
 /** @} */
 /** @} */
 
@@ -52,8 +52,121 @@
 static struct etimer *timerlist;
 static clock_time_t next_expiration;
 
+#if ETIMER_HEAP_SIZE
+/* Binary min-heap of pending timers, ordered by expiration time. */
+static struct etimer *heap[ETIMER_HEAP_SIZE];
+static uint16_t heap_count;
+#endif /* ETIMER_HEAP_SIZE */
+
 PROCESS(etimer_process, "Event timer");
 /*---------------------------------------------------------------------------*/
+#if ETIMER_HEAP_SIZE
+/* Returns true if a expires before b. The comparison is made on the
+   difference between the expiration times so that it remains valid
+   when the clock wraps, as long as the two timers expire within half
+   the clock range of each other. */
+static int
+expires_before(struct etimer *a, struct etimer *b)
+{
+  clock_time_t diff;
+
+  diff = (a->timer.start + a->timer.interval) -
+    (b->timer.start + b->timer.interval);
+  return diff > ((clock_time_t)~(clock_time_t)0 >> 1);
+}
+/*---------------------------------------------------------------------------*/
+static int
+heap_contains(struct etimer *et)
+{
+  return et->heap_index < heap_count && heap[et->heap_index] == et;
+}
+/*---------------------------------------------------------------------------*/
+static void
+heap_place(struct etimer *et, uint16_t i)
+{
+  heap[i] = et;
+  et->heap_index = i;
+}
+/*---------------------------------------------------------------------------*/
+static void
+heap_sift_up(uint16_t i)
+{
+  struct etimer *et = heap[i];
+  uint16_t parent;
+
+  while(i > 0) {
+    parent = (i - 1) / 2;
+    if(!expires_before(et, heap[parent])) {
+      break;
+    }
+    heap_place(heap[parent], i);
+    i = parent;
+  }
+  heap_place(et, i);
+}
+/*---------------------------------------------------------------------------*/
+static void
+heap_sift_down(uint16_t i)
+{
+  struct etimer *et = heap[i];
+  uint16_t child;
+
+  while((child = 2 * i + 1) < heap_count) {
+    if(child + 1 < heap_count && expires_before(heap[child + 1], heap[child])) {
+      child++;
+    }
+    if(!expires_before(heap[child], et)) {
+      break;
+    }
+    heap_place(heap[child], i);
+    i = child;
+  }
+  heap_place(et, i);
+}
+/*---------------------------------------------------------------------------*/
+/* Restores the heap order after the expiration time of heap[i] has
+   changed. */
+static void
+heap_update(uint16_t i)
+{
+  struct etimer *et = heap[i];
+
+  heap_sift_up(i);
+  heap_sift_down(et->heap_index);
+}
+/*---------------------------------------------------------------------------*/
+static void
+heap_remove(uint16_t i)
+{
+  heap_count--;
+  if(i < heap_count) {
+    heap_place(heap[heap_count], i);
+    heap_update(i);
+  }
+  heap[heap_count] = NULL;
+}
+/*---------------------------------------------------------------------------*/
+static void
+heap_remove_process(struct process *p)
+{
+  uint16_t i, j;
+
+  /* Drop all timers owned by the process and rebuild the heap. */
+  for(i = 0, j = 0; i < heap_count; i++) {
+    if(heap[i]->p != p) {
+      heap_place(heap[i], j++);
+    }
+  }
+  for(i = j; i < heap_count; i++) {
+    heap[i] = NULL;
+  }
+  heap_count = j;
+  for(i = heap_count / 2; i > 0; i--) {
+    heap_sift_down(i - 1);
+  }
+}
+#endif /* ETIMER_HEAP_SIZE */
+/*---------------------------------------------------------------------------*/
 static void
 update_time(void)
 {
@@ -61,14 +174,20 @@ update_time(void)
   clock_time_t now;
   struct etimer *t;
 
-  if(timerlist == NULL) {
+  t = timerlist;
+#if ETIMER_HEAP_SIZE
+  if(heap_count > 0) {
+    t = heap[0];
+  }
+#endif /* ETIMER_HEAP_SIZE */
+
+  if(t == NULL) {
     next_expiration = 0;
   } else {
     now = clock_time();
-    t = timerlist;
     /* Must calculate distance to next time into account due to wraps */
     tdist = t->timer.start + t->timer.interval - now;
-    for(t = t->next; t != NULL; t = t->next) {
+    for(t = timerlist; t != NULL; t = t->next) {
       if(t->timer.start + t->timer.interval - now < tdist) {
         tdist = t->timer.start + t->timer.interval - now;
       }
@@ -91,6 +210,10 @@ PROCESS_THREAD(etimer_process, ev, data)
     if(ev == PROCESS_EVENT_EXITED) {
       struct process *p = data;
 
+#if ETIMER_HEAP_SIZE
+      heap_remove_process(p);
+#endif /* ETIMER_HEAP_SIZE */
+
       while(timerlist != NULL && timerlist->p == p) {
         timerlist = timerlist->next;
       }
@@ -110,6 +233,22 @@ PROCESS_THREAD(etimer_process, ev, data)
       continue;
     }
 
+#if ETIMER_HEAP_SIZE
+    /* Only the timer at the top of the heap needs to be checked: if
+       it has not expired, no other timer in the heap has either. */
+    while(heap_count > 0 && timer_expired(&heap[0]->timer)) {
+      t = heap[0];
+      if(process_post(t->p, PROCESS_EVENT_TIMER, t) == PROCESS_ERR_OK) {
+        t->p = PROCESS_NONE;
+        heap_remove(0);
+        update_time();
+      } else {
+        etimer_request_poll();
+        break;
+      }
+    }
+#endif /* ETIMER_HEAP_SIZE */
+
 again:
 
     u = NULL;
@@ -154,6 +293,16 @@ add_timer(struct etimer *timer)
 
   etimer_request_poll();
 
+#if ETIMER_HEAP_SIZE
+  if(heap_contains(timer)) {
+    /* Timer already in the heap, restore the heap order. */
+    timer->p = PROCESS_CURRENT();
+    heap_update(timer->heap_index);
+    update_time();
+    return;
+  }
+#endif /* ETIMER_HEAP_SIZE */
+
   if(timer->p != PROCESS_NONE) {
     for(t = timerlist; t != NULL; t = t->next) {
       if(t == timer) {
@@ -167,6 +316,14 @@ add_timer(struct etimer *timer)
 
   /* Timer not on list. */
   timer->p = PROCESS_CURRENT();
+#if ETIMER_HEAP_SIZE
+  if(heap_count < ETIMER_HEAP_SIZE) {
+    heap_place(timer, heap_count++);
+    heap_sift_up(timer->heap_index);
+    update_time();
+    return;
+  }
+#endif /* ETIMER_HEAP_SIZE */
   timer->next = timerlist;
   timerlist = timer;
 
@@ -206,6 +363,11 @@ void
 etimer_adjust(struct etimer *et, int timediff)
 {
   et->timer.start += timediff;
+#if ETIMER_HEAP_SIZE
+  if(heap_contains(et)) {
+    heap_update(et->heap_index);
+  }
+#endif /* ETIMER_HEAP_SIZE */
   update_time();
 }
 /*---------------------------------------------------------------------------*/
@@ -230,6 +392,11 @@ etimer_start_time(struct etimer *et)
 int
 etimer_pending(void)
 {
+#if ETIMER_HEAP_SIZE
+  if(heap_count > 0) {
+    return 1;
+  }
+#endif /* ETIMER_HEAP_SIZE */
   return timerlist != NULL;
 }
 /*---------------------------------------------------------------------------*/
@@ -244,8 +411,14 @@ etimer_stop(struct etimer *et)
 {
   struct etimer *t;
 
-  /* First check if et is the first event timer on the list. */
+#if ETIMER_HEAP_SIZE
+  if(heap_contains(et)) {
+    heap_remove(et->heap_index);
+    update_time();
+  } else
+#endif /* ETIMER_HEAP_SIZE */
   if(et == timerlist) {
+    /* The event timer is the first event timer on the list. */
     timerlist = timerlist->next;
     update_time();
   } else {
@@ -65,6 +65,22 @@
 
 #include "contiki.h"
 
+/**
+ * \brief Number of event timers kept in the sorted timer heap.
+ *
+ * By default, pending event timers are kept in an unsorted list that
+ * is scanned whenever a timer is added, stopped, or expires. When
+ * ETIMER_CONF_HEAP_SIZE is non-zero, up to that many timers are
+ * instead kept in a binary min-heap ordered by expiration time, which
+ * makes insertion, removal and expiry O(log n). Timers that do not
+ * fit in the heap fall back to the unsorted list.
+ */
+#ifdef ETIMER_CONF_HEAP_SIZE
+#define ETIMER_HEAP_SIZE ETIMER_CONF_HEAP_SIZE
+#else
+#define ETIMER_HEAP_SIZE 0
+#endif
+
 /**
  * A timer.
  *
@@ -77,6 +93,9 @@ struct etimer {
   struct timer timer;
   struct etimer *next;
   struct process *p;
+#if ETIMER_HEAP_SIZE
+  uint16_t heap_index;
+#endif
 };
 
 /**
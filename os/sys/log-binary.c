@@ -0,0 +1,686 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Deferred binary logging.
+ *
+ *         Records are laid out as a length byte, a byte with the kind
+ *         of record and the log level, and then, for logs, the module
+ *         and format pointers followed by the arguments in host
+ *         representation. %s strings are copied with a length byte.
+ *         Records are encoded in place in the ring buffer. Logs may
+ *         be recorded from interrupt context, so interrupts are
+ *         disabled while a record is encoded; the producer publishes
+ *         its position after a whole record, and the single consumer,
+ *         log_binary_process, after taking one.
+ */
+
+/** \addtogroup log
+ * @{ */
+
+#include "contiki.h"
+#include "sys/log.h"
+#include "sys/critical.h"
+#include "sys/memory-barrier.h"
+#include <stdarg.h>
+#include <string.h>
+
+#if LOG_WITH_BINARY
+
+#if (LOG_BINARY_BUF_SIZE & (LOG_BINARY_BUF_SIZE - 1)) != 0 || LOG_BINARY_BUF_SIZE > 32768
+#error LOG_BINARY_BUF_SIZE must be a power of two, at most 32768
+#endif
+
+#if LOG_BINARY_RECORD_SIZE > 255 || LOG_BINARY_STRING_LEN >= 255
+#error LOG_BINARY_RECORD_SIZE must be at most 255, LOG_BINARY_STRING_LEN less
+#endif
+
+/* Kinds of records besides the raw data ones of log-binary.h */
+#define KIND_PREFIX    6 /* Starts a line: module and format */
+#define KIND_FORMAT    7 /* Continues a line: format only */
+
+#define REC_HDR_LEN    2
+#define REC_INFO(kind, level) (((kind) << 4) | ((level) & 0x0f))
+
+/* A NULL string, as opposed to a string length */
+#define STR_NULL       0xff
+
+/* What a conversion specification takes from the arguments */
+enum arg_class {
+  ARG_NONE,
+  ARG_INT,
+  ARG_LONG,
+  ARG_LLONG,
+  ARG_SIZE,
+  ARG_INTMAX,
+  ARG_PTRDIFF,
+  ARG_DOUBLE,
+  ARG_LDOUBLE,
+  ARG_STR,
+  ARG_PTR,
+  ARG_SKIP,
+};
+
+struct conversion {
+  enum arg_class class;
+  uint8_t stars;
+  /* -1 if none, -2 if given as an argument */
+  int precision;
+};
+
+/* A record being encoded in the ring, from the put pointer on */
+struct record {
+  uint16_t start;
+  uint8_t len;
+  uint8_t overflow;
+};
+
+PROCESS(log_binary_process, "Log");
+
+static uint8_t ring[LOG_BINARY_BUF_SIZE];
+static volatile uint16_t put_ptr;
+static volatile uint16_t get_ptr;
+static uint32_t dropped;
+static uint32_t dropped_reported;
+
+uint8_t log_binary_draining;
+
+static const char *const level_str[] = { "PRI", "ERR", "WARN", "INFO", "DBG" };
+static const char *const level_color[] = {
+  LOG_COLOR_PRI, LOG_COLOR_ERR, LOG_COLOR_WARN, LOG_COLOR_INFO, LOG_COLOR_DBG
+};
+/*---------------------------------------------------------------------------*/
+/* Parses the conversion specification following a '%' at p, returns the
+   character following it */
+static const char *
+parse_conversion(const char *p, struct conversion *c)
+{
+  c->class = ARG_INT;
+  c->stars = 0;
+  c->precision = -1;
+
+  while(*p == '-' || *p == '+' || *p == ' ' || *p == '#' || *p == '0') {
+    p++;
+  }
+  if(*p == '*') {
+    c->stars++;
+    p++;
+  }
+  while(*p >= '0' && *p <= '9') {
+    p++;
+  }
+  if(*p == '.') {
+    p++;
+    if(*p == '*') {
+      c->stars++;
+      c->precision = -2;
+      p++;
+    } else {
+      c->precision = 0;
+      while(*p >= '0' && *p <= '9') {
+        c->precision = c->precision * 10 + *p++ - '0';
+      }
+    }
+  }
+
+  switch(*p) {
+  case 'h':
+    p += p[1] == 'h' ? 2 : 1;
+    break;
+  case 'l':
+    if(p[1] == 'l') {
+      c->class = ARG_LLONG;
+      p += 2;
+    } else {
+      c->class = ARG_LONG;
+      p++;
+    }
+    break;
+  case 'L':
+    c->class = ARG_LDOUBLE;
+    p++;
+    break;
+  case 'z':
+    c->class = ARG_SIZE;
+    p++;
+    break;
+  case 'j':
+    c->class = ARG_INTMAX;
+    p++;
+    break;
+  case 't':
+    c->class = ARG_PTRDIFF;
+    p++;
+    break;
+  }
+
+  switch(*p) {
+  case 'd': case 'i': case 'o': case 'u': case 'x': case 'X':
+    break;
+  case 'c':
+    c->class = ARG_INT;
+    break;
+  case 'a': case 'A': case 'e': case 'E': case 'f': case 'F': case 'g': case 'G':
+    c->class = c->class == ARG_LDOUBLE ? ARG_LDOUBLE : ARG_DOUBLE;
+    break;
+  case 's':
+    c->class = ARG_STR;
+    break;
+  case 'p':
+    c->class = ARG_PTR;
+    break;
+  case 'n':
+    c->class = ARG_SKIP;
+    break;
+  case '\0':
+    c->class = ARG_NONE;
+    c->stars = 0;
+    return p;
+  default:
+    /* %% and conversions that take nothing */
+    c->class = ARG_NONE;
+    c->stars = 0;
+    break;
+  }
+  return p + 1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+ring_write(uint16_t pos, const void *data, size_t len)
+{
+  uint16_t offset;
+  uint16_t first;
+
+  offset = pos & (LOG_BINARY_BUF_SIZE - 1);
+  first = MIN(len, LOG_BINARY_BUF_SIZE - offset);
+  memcpy(&ring[offset], data, first);
+  memcpy(ring, (const uint8_t *)data + first, len - first);
+}
+/*---------------------------------------------------------------------------*/
+static void
+append(struct record *r, const void *data, size_t len)
+{
+  if(r->overflow || r->len + len > LOG_BINARY_RECORD_SIZE ||
+     (uint16_t)(r->start - get_ptr) + r->len + len > LOG_BINARY_BUF_SIZE) {
+    r->overflow = 1;
+    return;
+  }
+  ring_write(r->start + r->len, data, len);
+  r->len += len;
+}
+/*---------------------------------------------------------------------------*/
+/* Starts a record at the put pointer. Called with interrupts disabled. */
+static void
+begin(struct record *r, uint8_t info)
+{
+  uint8_t hdr[REC_HDR_LEN] = { 0, info };
+
+  r->start = put_ptr;
+  r->len = 0;
+  r->overflow = 0;
+  append(r, hdr, sizeof(hdr));
+}
+/*---------------------------------------------------------------------------*/
+/* Publishes a record. Called with interrupts disabled. */
+static void
+commit(struct record *r)
+{
+  if(r->overflow) {
+    dropped++;
+    return;
+  }
+
+  ring[r->start & (LOG_BINARY_BUF_SIZE - 1)] = r->len;
+  memory_barrier();
+  put_ptr = r->start + r->len;
+
+  /* Unlike process_post(), process_poll() may be called from interrupts */
+  process_poll(&log_binary_process);
+}
+/*---------------------------------------------------------------------------*/
+/* Removes the oldest record from the ring, returns its length or 0 */
+static uint8_t
+take(uint8_t *data)
+{
+  uint16_t get;
+  uint16_t offset;
+  uint16_t first;
+  uint8_t len;
+
+  get = get_ptr;
+  if(put_ptr == get) {
+    return 0;
+  }
+  memory_barrier();
+
+  offset = get & (LOG_BINARY_BUF_SIZE - 1);
+  len = ring[offset];
+  first = MIN(len, LOG_BINARY_BUF_SIZE - offset);
+  memcpy(data, &ring[offset], first);
+  memcpy(&data[first], ring, len - first);
+  memory_barrier();
+  get_ptr = get + len;
+  return len;
+}
+/*---------------------------------------------------------------------------*/
+void
+log_binary_record(int level, const char *module, const char *format, ...)
+{
+  int_master_status_t status;
+  struct record r;
+  struct conversion c;
+  const char *p;
+  va_list ap;
+  int star = -1;
+  int i;
+
+  status = critical_enter();
+  begin(&r, REC_INFO(module != NULL ? KIND_PREFIX : KIND_FORMAT, level));
+  if(module != NULL) {
+    append(&r, &module, sizeof(module));
+  }
+  append(&r, &format, sizeof(format));
+
+  va_start(ap, format);
+  for(p = format; *p != '\0';) {
+    if(*p++ != '%') {
+      continue;
+    }
+    p = parse_conversion(p, &c);
+    for(i = 0; i < c.stars; i++) {
+      star = va_arg(ap, int);
+      append(&r, &star, sizeof(star));
+    }
+
+    switch(c.class) {
+    case ARG_INT: {
+      int v = va_arg(ap, int);
+      append(&r, &v, sizeof(v));
+      break;
+    }
+    case ARG_LONG: {
+      long v = va_arg(ap, long);
+      append(&r, &v, sizeof(v));
+      break;
+    }
+    case ARG_LLONG: {
+      long long v = va_arg(ap, long long);
+      append(&r, &v, sizeof(v));
+      break;
+    }
+    case ARG_SIZE: {
+      size_t v = va_arg(ap, size_t);
+      append(&r, &v, sizeof(v));
+      break;
+    }
+    case ARG_INTMAX: {
+      intmax_t v = va_arg(ap, intmax_t);
+      append(&r, &v, sizeof(v));
+      break;
+    }
+    case ARG_PTRDIFF: {
+      ptrdiff_t v = va_arg(ap, ptrdiff_t);
+      append(&r, &v, sizeof(v));
+      break;
+    }
+    case ARG_DOUBLE: {
+      double v = va_arg(ap, double);
+      append(&r, &v, sizeof(v));
+      break;
+    }
+    case ARG_LDOUBLE: {
+      long double v = va_arg(ap, long double);
+      append(&r, &v, sizeof(v));
+      break;
+    }
+    case ARG_PTR: {
+      void *v = va_arg(ap, void *);
+      append(&r, &v, sizeof(v));
+      break;
+    }
+    case ARG_STR: {
+      /* The string may not outlive the call, so it is copied, but not
+         beyond the precision, as it may not be terminated then */
+      const char *s = va_arg(ap, const char *);
+      int max = LOG_BINARY_STRING_LEN;
+      uint8_t len;
+
+      if(c.precision == -2) {
+        c.precision = star;
+      }
+      if(c.precision >= 0 && c.precision < max) {
+        max = c.precision;
+      }
+      if(s == NULL) {
+        len = STR_NULL;
+        append(&r, &len, 1);
+      } else {
+        for(len = 0; len < max && s[len] != '\0'; len++);
+        append(&r, &len, 1);
+        append(&r, s, len);
+      }
+      break;
+    }
+    case ARG_SKIP:
+      (void)va_arg(ap, void *);
+      break;
+    case ARG_NONE:
+      break;
+    }
+  }
+  va_end(ap);
+
+  commit(&r);
+  critical_exit(status);
+}
+/*---------------------------------------------------------------------------*/
+void
+log_binary_record_data(uint8_t kind, const void *data, size_t length)
+{
+  int_master_status_t status;
+  struct record r;
+  size_t len;
+
+  /* Byte arrays are split over as many records as needed */
+  do {
+    len = MIN(length, LOG_BINARY_RECORD_SIZE - REC_HDR_LEN);
+    status = critical_enter();
+    begin(&r, REC_INFO(kind, 0));
+    append(&r, data, len);
+    commit(&r);
+    critical_exit(status);
+    data = (const uint8_t *)data + len;
+    length -= len;
+  } while(length > 0);
+}
+/*---------------------------------------------------------------------------*/
+static int
+get(const uint8_t *data, uint8_t len, uint8_t *pos, void *v, size_t size)
+{
+  if(*pos + size > len) {
+    return 0;
+  }
+  memcpy(v, &data[*pos], size);
+  *pos += size;
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Prints a conversion specification with the arguments of a record,
+   the width and precision given as arguments being spelled out */
+static int
+print_conversion(const char *start, const char *end, const struct conversion *c,
+                 const uint8_t *data, uint8_t len, uint8_t *pos)
+{
+  char spec[24];
+  size_t n;
+  int star;
+
+  for(n = 0; start < end && n < sizeof(spec) - 12; start++) {
+    if(*start == '*') {
+      if(!get(data, len, pos, &star, sizeof(star))) {
+        return 0;
+      }
+      n += snprintf(&spec[n], sizeof(spec) - n, "%d", star);
+    } else {
+      spec[n++] = *start;
+    }
+  }
+  spec[n] = '\0';
+
+#define PRINT_ARG(type) do { \
+    type v; \
+    if(!get(data, len, pos, &v, sizeof(v))) { \
+      return 0; \
+    } \
+    LOG_OUTPUT_TEXT(spec, v); \
+  } while(0)
+
+  switch(c->class) {
+  case ARG_INT:
+    PRINT_ARG(int);
+    break;
+  case ARG_LONG:
+    PRINT_ARG(long);
+    break;
+  case ARG_LLONG:
+    PRINT_ARG(long long);
+    break;
+  case ARG_SIZE:
+    PRINT_ARG(size_t);
+    break;
+  case ARG_INTMAX:
+    PRINT_ARG(intmax_t);
+    break;
+  case ARG_PTRDIFF:
+    PRINT_ARG(ptrdiff_t);
+    break;
+  case ARG_DOUBLE:
+    PRINT_ARG(double);
+    break;
+  case ARG_LDOUBLE:
+    PRINT_ARG(long double);
+    break;
+  case ARG_PTR:
+    PRINT_ARG(void *);
+    break;
+  case ARG_STR: {
+    char s[LOG_BINARY_STRING_LEN + 1];
+    uint8_t slen;
+
+    if(!get(data, len, pos, &slen, 1)) {
+      return 0;
+    }
+    if(slen == STR_NULL) {
+      LOG_OUTPUT_TEXT("(null)");
+      break;
+    }
+    if(slen > LOG_BINARY_STRING_LEN || !get(data, len, pos, s, slen)) {
+      return 0;
+    }
+    s[slen] = '\0';
+    LOG_OUTPUT_TEXT(spec, s);
+    break;
+  }
+  case ARG_SKIP:
+    break;
+  case ARG_NONE:
+    if(!strcmp(spec, "%%")) {
+      LOG_OUTPUT_TEXT("%%");
+    } else {
+      LOG_OUTPUT_TEXT("%s", spec);
+    }
+    break;
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+print_data(uint8_t kind, const uint8_t *data, uint8_t len)
+{
+  linkaddr_t lladdr;
+#if NETSTACK_CONF_WITH_IPV6
+  uip_ipaddr_t ipaddr;
+#endif /* NETSTACK_CONF_WITH_IPV6 */
+
+  switch(kind) {
+  case LOG_BINARY_LLADDR:
+  case LOG_BINARY_LLADDR_COMPACT:
+    if(len == sizeof(lladdr)) {
+      memcpy(&lladdr, data, sizeof(lladdr));
+    }
+    if(kind == LOG_BINARY_LLADDR) {
+      log_lladdr(len == sizeof(lladdr) ? &lladdr : NULL);
+    } else {
+      log_lladdr_compact(len == sizeof(lladdr) ? &lladdr : NULL);
+    }
+    break;
+#if NETSTACK_CONF_WITH_IPV6
+  case LOG_BINARY_6ADDR:
+  case LOG_BINARY_6ADDR_COMPACT:
+    if(len == sizeof(ipaddr)) {
+      memcpy(&ipaddr, data, sizeof(ipaddr));
+    }
+    if(kind == LOG_BINARY_6ADDR) {
+      log_6addr(len == sizeof(ipaddr) ? &ipaddr : NULL);
+    } else {
+      log_6addr_compact(len == sizeof(ipaddr) ? &ipaddr : NULL);
+    }
+    break;
+#endif /* NETSTACK_CONF_WITH_IPV6 */
+  case LOG_BINARY_BYTES:
+    log_bytes(data, len);
+    break;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+print_record(const uint8_t *data, uint8_t len)
+{
+  const char *module;
+  const char *format;
+  const char *p;
+  const char *start;
+  struct conversion c;
+  uint8_t kind;
+  uint8_t level;
+  uint8_t pos;
+
+  kind = data[1] >> 4;
+  level = MIN(data[1] & 0x0f, LOG_LEVEL_DBG);
+  pos = REC_HDR_LEN;
+
+  if(kind != KIND_PREFIX && kind != KIND_FORMAT) {
+    print_data(kind, &data[pos], len - pos);
+    return;
+  }
+
+  if(kind == KIND_PREFIX) {
+    if(!get(data, len, &pos, &module, sizeof(module))) {
+      return;
+    }
+    if(LOG_WITH_COLOR) {
+      LOG_OUTPUT_TEXT("%s", level_color[level]);
+    }
+    if(LOG_WITH_MODULE_PREFIX) {
+      LOG_OUTPUT_PREFIX(level, level_str[level], module);
+    }
+    if(LOG_WITH_COLOR) {
+      LOG_OUTPUT_TEXT(LOG_COLOR_RESET);
+    }
+  }
+
+  if(!get(data, len, &pos, &format, sizeof(format))) {
+    return;
+  }
+  for(p = format; *p != '\0';) {
+    start = p;
+    while(*p != '\0' && *p != '%') {
+      p++;
+    }
+    if(p > start) {
+      LOG_OUTPUT_TEXT("%.*s", (int)(p - start), start);
+    }
+    if(*p == '\0') {
+      break;
+    }
+    start = p;
+    p = parse_conversion(p + 1, &c);
+    if(!print_conversion(start, p, &c, data, len, &pos)) {
+      break;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Prints up to max records, returns the number of records printed */
+static int
+drain(int max)
+{
+  uint8_t data[LOG_BINARY_RECORD_SIZE];
+  uint8_t len;
+  int count;
+
+  if(log_binary_draining) {
+    return 0;
+  }
+  log_binary_draining = 1;
+
+  if(dropped != dropped_reported) {
+    LOG_OUTPUT_TEXT("[WARN: Log       ] %lu logs dropped\n",
+                    (unsigned long)(dropped - dropped_reported));
+    dropped_reported = dropped;
+  }
+  for(count = 0; count < max && (len = take(data)) > 0; count++) {
+    print_record(data, len);
+  }
+
+  log_binary_draining = 0;
+  return count;
+}
+/*---------------------------------------------------------------------------*/
+void
+log_binary_flush(void)
+{
+  while(drain(LOG_BINARY_BUF_SIZE) > 0);
+}
+/*---------------------------------------------------------------------------*/
+uint32_t
+log_binary_dropped(void)
+{
+  return dropped;
+}
+/*---------------------------------------------------------------------------*/
+void
+log_binary_init(void)
+{
+  /* Let the poll handlers of other processes run first */
+  process_set_priority(&log_binary_process, PROCESS_PRIORITY_LEVELS - 1);
+  process_start(&log_binary_process, NULL);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(log_binary_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  while(1) {
+    /* Logs recorded before the process started are drained right away */
+    if(put_ptr != get_ptr) {
+      process_poll(&log_binary_process);
+    }
+    PROCESS_YIELD();
+    /* A batch at a time, to let other processes run in between */
+    drain(LOG_BINARY_DRAIN_BATCH);
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+#endif /* LOG_WITH_BINARY */
+
+/** @} */
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Deferred binary logging.
+ *
+ *         With LOG_CONF_WITH_BINARY, the LOG_* macros copy the module,
+ *         the level, the address of the format string and the raw
+ *         arguments to a ring buffer. Formatting happens later, in
+ *         log_binary_process, so that logging costs little more than a
+ *         copy where it happens. Addresses and byte arrays are recorded
+ *         as they are, not as text. Logs may also be recorded from
+ *         interrupt handlers.
+ */
+
+/** \addtogroup log
+ * @{ */
+
+#ifndef LOG_BINARY_H_
+#define LOG_BINARY_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Size of the ring buffer in bytes. Must be a power of two. */
+#ifdef LOG_BINARY_CONF_BUF_SIZE
+#define LOG_BINARY_BUF_SIZE LOG_BINARY_CONF_BUF_SIZE
+#else /* LOG_BINARY_CONF_BUF_SIZE */
+#define LOG_BINARY_BUF_SIZE 1024
+#endif /* LOG_BINARY_CONF_BUF_SIZE */
+
+/* Maximum size of a record, at most 255. Logs that need more are dropped. */
+#ifdef LOG_BINARY_CONF_RECORD_SIZE
+#define LOG_BINARY_RECORD_SIZE LOG_BINARY_CONF_RECORD_SIZE
+#else /* LOG_BINARY_CONF_RECORD_SIZE */
+#define LOG_BINARY_RECORD_SIZE 128
+#endif /* LOG_BINARY_CONF_RECORD_SIZE */
+
+/* Strings passed with %s are copied, and truncated to this length */
+#ifdef LOG_BINARY_CONF_STRING_LEN
+#define LOG_BINARY_STRING_LEN LOG_BINARY_CONF_STRING_LEN
+#else /* LOG_BINARY_CONF_STRING_LEN */
+#define LOG_BINARY_STRING_LEN 48
+#endif /* LOG_BINARY_CONF_STRING_LEN */
+
+/* The number of records the process formats before it lets others run */
+#ifdef LOG_BINARY_CONF_DRAIN_BATCH
+#define LOG_BINARY_DRAIN_BATCH LOG_BINARY_CONF_DRAIN_BATCH
+#else /* LOG_BINARY_CONF_DRAIN_BATCH */
+#define LOG_BINARY_DRAIN_BATCH 8
+#endif /* LOG_BINARY_CONF_DRAIN_BATCH */
+
+/* Kinds of raw data recorded by the address and byte array helpers */
+#define LOG_BINARY_LLADDR          1
+#define LOG_BINARY_LLADDR_COMPACT  2
+#define LOG_BINARY_6ADDR           3
+#define LOG_BINARY_6ADDR_COMPACT   4
+#define LOG_BINARY_BYTES           5
+
+/** Non-zero while records are being formatted, when LOG_OUTPUT prints */
+extern uint8_t log_binary_draining;
+
+/**
+ * Records a log.
+ * \param level The log level
+ * \param module The module, a string literal, or NULL for the
+ * continuation of a line, which gets no prefix
+ * \param format A printf format, which must be a string literal
+*/
+void log_binary_record(int level, const char *module, const char *format, ...);
+
+/**
+ * Records raw data, to be formatted by one of the log.c helpers.
+ * \param kind One of LOG_BINARY_LLADDR, ..., LOG_BINARY_BYTES
+ * \param data The data. NULL is recorded for addresses.
+ * \param length The length of the data
+*/
+void log_binary_record_data(uint8_t kind, const void *data, size_t length);
+
+/**
+ * Formats all pending records now, for example before a reboot.
+*/
+void log_binary_flush(void);
+
+/**
+ * Returns the number of logs dropped as the buffer was full.
+*/
+uint32_t log_binary_dropped(void);
+
+/**
+ * Starts the process that formats the records.
+*/
+void log_binary_init(void);
+
+#endif /* LOG_BINARY_H_ */
+
+/** @} */
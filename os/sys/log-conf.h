@@ -77,11 +77,36 @@
 
 /* Custom output function -- default is printf */
 #ifdef LOG_CONF_OUTPUT
-#define LOG_OUTPUT(...) LOG_CONF_OUTPUT(__VA_ARGS__)
+#define LOG_OUTPUT_TEXT(...) LOG_CONF_OUTPUT(__VA_ARGS__)
 #else /* LOG_CONF_OUTPUT */
-#define LOG_OUTPUT(...) printf(__VA_ARGS__)
+#define LOG_OUTPUT_TEXT(...) printf(__VA_ARGS__)
 #endif /* LOG_CONF_OUTPUT */
 
+/*
+ * Deferred binary logging. Instead of being formatted where they are
+ * logged, logs are recorded in a ring buffer as the module, level,
+ * format string and raw arguments, and formatted with LOG_OUTPUT_TEXT
+ * later on by a process. Text written with printf directly is not
+ * deferred and may show up ahead of pending logs. Disabled by default.
+ */
+#ifdef LOG_CONF_WITH_BINARY
+#define LOG_WITH_BINARY LOG_CONF_WITH_BINARY
+#else /* LOG_CONF_WITH_BINARY */
+#define LOG_WITH_BINARY 0
+#endif /* LOG_CONF_WITH_BINARY */
+
+#if LOG_WITH_BINARY
+#define LOG_OUTPUT(...) do { \
+                          if(log_binary_draining) { \
+                            LOG_OUTPUT_TEXT(__VA_ARGS__); \
+                          } else { \
+                            log_binary_record(0, NULL, __VA_ARGS__); \
+                          } \
+                        } while(0)
+#else /* LOG_WITH_BINARY */
+#define LOG_OUTPUT(...) LOG_OUTPUT_TEXT(__VA_ARGS__)
+#endif /* LOG_WITH_BINARY */
+
 /* Color the prefix based on the log level. Disabled by default */
 #ifdef LOG_CONF_WITH_COLOR
 #define LOG_WITH_COLOR LOG_CONF_WITH_COLOR
@@ -82,6 +82,18 @@ struct log_module all_modules[] = {
   {NULL, NULL, 0},
 };
 
+#if LOG_WITH_BINARY
+/* Record the raw data instead of printing it, unless formatting a record */
+#define DEFER(kind, data, length) do { \
+    if(!log_binary_draining) { \
+      log_binary_record_data(kind, data, (data) != NULL ? (length) : 0); \
+      return; \
+    } \
+  } while(0)
+#else /* LOG_WITH_BINARY */
+#define DEFER(kind, data, length)
+#endif /* LOG_WITH_BINARY */
+
 #if NETSTACK_CONF_WITH_IPV6
 
 /*---------------------------------------------------------------------------*/
@@ -89,6 +101,7 @@ void
 log_6addr(const uip_ipaddr_t *ipaddr)
 {
   char buf[UIPLIB_IPV6_MAX_STR_LEN];
+  DEFER(LOG_BINARY_6ADDR, ipaddr, sizeof(uip_ipaddr_t));
   uiplib_ipaddr_snprint(buf, sizeof(buf), ipaddr);
   LOG_OUTPUT("%s", buf);
 }
@@ -119,6 +132,7 @@ void
 log_6addr_compact(const uip_ipaddr_t *ipaddr)
 {
   char buf[8];
+  DEFER(LOG_BINARY_6ADDR_COMPACT, ipaddr, sizeof(uip_ipaddr_t));
   log_6addr_compact_snprint(buf, sizeof(buf), ipaddr);
   LOG_OUTPUT("%s", buf);
 }
@@ -127,6 +141,7 @@ log_6addr_compact(const uip_ipaddr_t *ipaddr)
 void
 log_lladdr(const linkaddr_t *lladdr)
 {
+  DEFER(LOG_BINARY_LLADDR, lladdr, sizeof(linkaddr_t));
   if(lladdr == NULL) {
     LOG_OUTPUT("(NULL LL addr)");
     return;
@@ -144,6 +159,7 @@ log_lladdr(const linkaddr_t *lladdr)
 void
 log_lladdr_compact(const linkaddr_t *lladdr)
 {
+  DEFER(LOG_BINARY_LLADDR_COMPACT, lladdr, sizeof(linkaddr_t));
   if(lladdr == NULL || linkaddr_cmp(lladdr, &linkaddr_null)) {
     LOG_OUTPUT("LL-NULL");
   } else {
@@ -164,6 +180,7 @@ log_bytes(const void *data, size_t length)
 {
   const uint8_t *u8data = (const uint8_t *)data;
   size_t i;
+  DEFER(LOG_BINARY_BYTES, data, length);
   for(i = 0; i != length; ++i) {
     LOG_OUTPUT("%02x", u8data[i]);
   }
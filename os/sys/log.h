@@ -54,6 +54,7 @@
 #include <stdio.h>
 #include "net/linkaddr.h"
 #include "sys/log-conf.h"
+#include "sys/log-binary.h"
 #if NETSTACK_CONF_WITH_IPV6
 #include "net/ipv6/uip.h"
 #endif /* NETSTACK_CONF_WITH_IPV6 */
@@ -136,6 +137,21 @@ extern struct log_module all_modules[];
 
 /* Main log function */
 
+#if LOG_WITH_BINARY
+/* Prefix, color and location are added when the log is formatted */
+#define LOG(newline, level, levelstr, levelcolor, ...) do {  \
+                            if(level <= (LOG_LEVEL)) { \
+                              if((newline) && LOG_WITH_LOC) { \
+                                log_binary_record(level, LOG_MODULE, \
+                                                  "[%s: %d] ", __FILE__, __LINE__); \
+                                log_binary_record(level, NULL, __VA_ARGS__); \
+                              } else { \
+                                log_binary_record(level, (newline) ? LOG_MODULE : NULL, \
+                                                  __VA_ARGS__); \
+                              } \
+                            } \
+                          } while (0)
+#else /* LOG_WITH_BINARY */
 #define LOG(newline, level, levelstr, levelcolor, ...) do {  \
                             if(level <= (LOG_LEVEL)) { \
                               if(newline) { \
@@ -155,6 +171,7 @@ extern struct log_module all_modules[];
                               LOG_OUTPUT(__VA_ARGS__); \
                             } \
                           } while (0)
+#endif /* LOG_WITH_BINARY */
 
 /* For Cooja annotations */
 #define LOG_ANNOTATE(...) do {  \
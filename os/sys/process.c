@@ -44,9 +44,11 @@
  */
 
 #include <stdio.h>
+#include <string.h>
 
 #include "contiki.h"
 #include "sys/process.h"
+#include "sys/critical.h"
 
 /*
  * Pointer to the currently running process structure.
@@ -70,10 +72,23 @@ static struct event_data events[PROCESS_CONF_NUMEVENTS];
 
 #if PROCESS_CONF_STATS
 process_num_events_t process_maxevents;
+struct process_stats process_stats;
 #endif
 
 static volatile unsigned char poll_requested;
 
+#if PROCESS_POLL_QUEUE
+/*
+ * Queues of polled processes, one per priority level. Processes are
+ * appended by process_poll(), which may be called from interrupts.
+ */
+static struct process *poll_head[PROCESS_PRIORITY_LEVELS];
+static struct process *poll_tail[PROCESS_PRIORITY_LEVELS];
+#if PROCESS_CONF_STATS
+static unsigned short npolls;
+#endif /* PROCESS_CONF_STATS */
+#endif /* PROCESS_POLL_QUEUE */
+
 #define PROCESS_STATE_NONE        0
 #define PROCESS_STATE_RUNNING     1
 #define PROCESS_STATE_CALLED      2
@@ -187,7 +202,16 @@ call_process(struct process *p, process_event_t ev, process_data_t data)
     PRINTF("process: calling process '%s' with event %d\n", PROCESS_NAME_STRING(p), ev);
     process_current = p;
     p->state = PROCESS_STATE_CALLED;
+#if PROCESS_STATS_RUNTIME
+    {
+      rtimer_clock_t start = RTIMER_NOW();
+      ret = p->thread(&p->pt, ev, data);
+      p->runtime += (rtimer_clock_t)(RTIMER_NOW() - start);
+      p->calls++;
+    }
+#else /* PROCESS_STATS_RUNTIME */
     ret = p->thread(&p->pt, ev, data);
+#endif /* PROCESS_STATS_RUNTIME */
     if(ret == PT_EXITED ||
        ret == PT_ENDED ||
        ev == PROCESS_EVENT_EXIT) {
@@ -212,6 +236,7 @@ process_init(void)
   nevents = fevent = 0;
 #if PROCESS_CONF_STATS
   process_maxevents = 0;
+  memset(&process_stats, 0, sizeof(process_stats));
 #endif /* PROCESS_CONF_STATS */
 
   process_current = process_list = NULL;
@@ -221,6 +246,50 @@ process_init(void)
  * Call each process' poll handler.
  */
 /*---------------------------------------------------------------------------*/
+#if PROCESS_POLL_QUEUE
+static void
+do_poll(void)
+{
+  struct process *queue[PROCESS_PRIORITY_LEVELS];
+  struct process *p;
+  int_master_status_t status;
+  int i;
+
+  /* Take the current poll queues. Processes that are polled while
+     the poll handlers run are queued for the next round. */
+  status = critical_enter();
+  poll_requested = 0;
+  for(i = 0; i < PROCESS_PRIORITY_LEVELS; i++) {
+    queue[i] = poll_head[i];
+    poll_head[i] = poll_tail[i] = NULL;
+  }
+#if PROCESS_CONF_STATS
+  npolls = 0;
+#endif /* PROCESS_CONF_STATS */
+  critical_exit(status);
+
+  for(i = 0; i < PROCESS_PRIORITY_LEVELS; i++) {
+    while(queue[i] != NULL) {
+      p = queue[i];
+      queue[i] = p->next_poll;
+
+      status = critical_enter();
+      p->next_poll = NULL;
+      p->needspoll = 0;
+      critical_exit(status);
+
+      /* The process may have exited after it was polled. */
+      if(p->state != PROCESS_STATE_NONE) {
+        p->state = PROCESS_STATE_RUNNING;
+#if PROCESS_CONF_STATS
+        process_stats.polls++;
+#endif /* PROCESS_CONF_STATS */
+        call_process(p, PROCESS_EVENT_POLL, NULL);
+      }
+    }
+  }
+}
+#else /* PROCESS_POLL_QUEUE */
 static void
 do_poll(void)
 {
@@ -232,10 +301,14 @@ do_poll(void)
     if(p->needspoll) {
       p->state = PROCESS_STATE_RUNNING;
       p->needspoll = 0;
+#if PROCESS_CONF_STATS
+      process_stats.polls++;
+#endif /* PROCESS_CONF_STATS */
       call_process(p, PROCESS_EVENT_POLL, NULL);
     }
   }
 }
+#endif /* PROCESS_POLL_QUEUE */
 /*---------------------------------------------------------------------------*/
 /*
  * Process the next event in the event queue and deliver it to
@@ -271,6 +344,10 @@ do_event(void)
     fevent = (fevent + 1) % PROCESS_CONF_NUMEVENTS;
     --nevents;
 
+#if PROCESS_CONF_STATS
+    process_stats.events++;
+#endif /* PROCESS_CONF_STATS */
+
     /* If this is a broadcast event, we deliver it to all events, in
        order of their priority. */
     if(receiver == PROCESS_BROADCAST) {
@@ -370,15 +447,59 @@ process_post_synch(struct process *p, process_event_t ev, process_data_t data)
 void
 process_poll(struct process *p)
 {
+#if PROCESS_POLL_QUEUE
+  int_master_status_t status;
+#endif /* PROCESS_POLL_QUEUE */
+
   if(p != NULL) {
     if(p->state == PROCESS_STATE_RUNNING ||
        p->state == PROCESS_STATE_CALLED) {
+#if PROCESS_POLL_QUEUE
+      status = critical_enter();
+      if(!p->needspoll) {
+        /* Append the process to the queue of its priority level. */
+        p->next_poll = NULL;
+        if(poll_tail[p->priority] == NULL) {
+          poll_head[p->priority] = p;
+        } else {
+          poll_tail[p->priority]->next_poll = p;
+        }
+        poll_tail[p->priority] = p;
+#if PROCESS_CONF_STATS
+        if(++npolls > process_stats.max_polls) {
+          process_stats.max_polls = npolls;
+        }
+#endif /* PROCESS_CONF_STATS */
+      }
+      p->needspoll = 1;
+      poll_requested = 1;
+      critical_exit(status);
+#else /* PROCESS_POLL_QUEUE */
       p->needspoll = 1;
       poll_requested = 1;
+#endif /* PROCESS_POLL_QUEUE */
     }
   }
 }
 /*---------------------------------------------------------------------------*/
+#if PROCESS_POLL_QUEUE
+void
+process_set_priority(struct process *p, unsigned char priority)
+{
+  int_master_status_t status;
+
+  if(priority >= PROCESS_PRIORITY_LEVELS) {
+    priority = PROCESS_PRIORITY_LEVELS - 1;
+  }
+
+  /* A queued process keeps its place until its poll handler has been
+     called; the new priority applies from the next poll. */
+  status = critical_enter();
+  p->priority = priority;
+  critical_exit(status);
+}
+#endif /* PROCESS_POLL_QUEUE */
+/*---------------------------------------------------------------------------*/
 int
 process_is_running(struct process *p)
 {
@@ -88,6 +88,45 @@ typedef unsigned char process_num_events_t;
 #define PROCESS_CONF_NUMEVENTS 32
 #endif /* PROCESS_CONF_NUMEVENTS */
 
+/**
+ * \brief Keep polled processes in a ready-queue.
+ *
+ * By default, the scheduler walks the whole process list to find the
+ * processes that have been polled. When PROCESS_CONF_POLL_QUEUE is
+ * enabled, process_poll() instead appends the process to a queue of
+ * polled processes in constant time, and only the queued processes
+ * are visited when poll handlers are run.
+ */
+#ifdef PROCESS_CONF_POLL_QUEUE
+#define PROCESS_POLL_QUEUE PROCESS_CONF_POLL_QUEUE
+#else
+#define PROCESS_POLL_QUEUE 0
+#endif /* PROCESS_CONF_POLL_QUEUE */
+
+/**
+ * \brief Number of poll priority levels used with the poll queue.
+ *
+ * Polled processes with a lower priority value have their poll
+ * handlers called first. All processes start at priority 0.
+ */
+#ifdef PROCESS_CONF_PRIORITY_LEVELS
+#define PROCESS_PRIORITY_LEVELS PROCESS_CONF_PRIORITY_LEVELS
+#else
+#define PROCESS_PRIORITY_LEVELS 1
+#endif /* PROCESS_CONF_PRIORITY_LEVELS */
+
+/**
+ * \brief Measure the number of calls and the time spent in each process.
+ *
+ * The time is measured in rtimer ticks and is stored in the calls and
+ * runtime fields of struct process.
+ */
+#ifdef PROCESS_CONF_STATS_RUNTIME
+#define PROCESS_STATS_RUNTIME PROCESS_CONF_STATS_RUNTIME
+#else
+#define PROCESS_STATS_RUNTIME 0
+#endif /* PROCESS_CONF_STATS_RUNTIME */
+
 #define PROCESS_EVENT_NONE            0x80
 #define PROCESS_EVENT_INIT            0x81
 #define PROCESS_EVENT_POLL            0x82
@@ -323,8 +362,33 @@ struct process {
   PT_THREAD((* thread)(struct pt *, process_event_t, process_data_t));
   struct pt pt;
   unsigned char state, needspoll;
+#if PROCESS_POLL_QUEUE
+  struct process *next_poll;
+  unsigned char priority;
+#endif /* PROCESS_POLL_QUEUE */
+#if PROCESS_STATS_RUNTIME
+  unsigned long calls;
+  unsigned long runtime;
+#endif /* PROCESS_STATS_RUNTIME */
 };
 
+#if PROCESS_CONF_STATS
+/**
+ * Scheduler statistics, maintained when PROCESS_CONF_STATS is enabled.
+ */
+struct process_stats {
+  /** Number of events delivered to processes. */
+  unsigned long events;
+  /** Number of poll handlers called. */
+  unsigned long polls;
+  /** Largest number of processes waiting in the poll queue. */
+  unsigned short max_polls;
+};
+
+extern struct process_stats process_stats;
+extern process_num_events_t process_maxevents;
+#endif /* PROCESS_CONF_STATS */
+
 /**
  * \name Functions called from application programs
  * @{
@@ -469,6 +533,24 @@ process_event_t process_alloc_event(void);
  */
 void process_poll(struct process *p);
 
+/**
+ * Set the poll priority of a process.
+ *
+ * When several processes have been polled, the poll handlers of the
+ * processes with the lowest priority value are called first. This
+ * has no effect unless PROCESS_CONF_POLL_QUEUE is enabled.
+ *
+ * \param p A pointer to the process' process structure.
+ *
+ * \param priority The priority, from 0 (highest) to
+ * PROCESS_PRIORITY_LEVELS - 1 (lowest).
+ */
+#if PROCESS_POLL_QUEUE
+void process_set_priority(struct process *p, unsigned char priority);
+#else
+#define process_set_priority(p, priority)
+#endif /* PROCESS_POLL_QUEUE */
+
 /** @} */
 
 /**
@@ -34,4 +34,8 @@
 
 #define UNIT_TEST_PRINT_FUNCTION print_test_report
 
+#ifndef MEMB_CONF_FREE_STACK
+#define MEMB_CONF_FREE_STACK 1
+#endif
+
 #endif /* PROJECT_CONF_H_ */
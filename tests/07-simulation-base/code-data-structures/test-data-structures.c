@@ -36,8 +36,10 @@
 #include "lib/circular-list.h"
 #include "lib/dbl-list.h"
 #include "lib/dbl-circ-list.h"
+#include "lib/memb.h"
 #include "lib/random.h"
 #include "services/unit-test/unit-test.h"
+#include "sys/rtimer.h"
 
 #include <string.h>
 #include <stdbool.h>
@@ -1024,6 +1026,100 @@ UNIT_TEST(test_cdll)
   UNIT_TEST_END();
 }
 /*---------------------------------------------------------------------------*/
+#define MEMB_BLOCK_COUNT 100
+MEMB(test_memb, demo_struct_t, MEMB_BLOCK_COUNT);
+
+UNIT_TEST_REGISTER(test_memb_blocks, "Memory blocks");
+UNIT_TEST(test_memb_blocks)
+{
+  demo_struct_t *blocks[MEMB_BLOCK_COUNT];
+  demo_struct_t *block;
+
+  UNIT_TEST_BEGIN();
+
+  memb_init(&test_memb);
+  UNIT_TEST_ASSERT(memb_numfree(&test_memb) == MEMB_BLOCK_COUNT);
+
+  /* Allocate all blocks, which must be distinct. */
+  for(int i = 0; i < MEMB_BLOCK_COUNT; i++) {
+    blocks[i] = memb_alloc(&test_memb);
+    UNIT_TEST_ASSERT(blocks[i] != NULL);
+    UNIT_TEST_ASSERT(memb_inmemb(&test_memb, blocks[i]));
+    for(int j = 0; j < i; j++) {
+      UNIT_TEST_ASSERT(blocks[i] != blocks[j]);
+    }
+  }
+  UNIT_TEST_ASSERT(memb_alloc(&test_memb) == NULL);
+  UNIT_TEST_ASSERT(memb_numfree(&test_memb) == 0);
+
+  /* A freed block is the next one to be allocated. */
+  UNIT_TEST_ASSERT(memb_free(&test_memb, blocks[MEMB_BLOCK_COUNT / 2]) == 0);
+  UNIT_TEST_ASSERT(memb_numfree(&test_memb) == 1);
+  block = memb_alloc(&test_memb);
+  UNIT_TEST_ASSERT(block == blocks[MEMB_BLOCK_COUNT / 2]);
+
+  /* Invalid and repeated deallocations are rejected. */
+  UNIT_TEST_ASSERT(memb_free(&test_memb, (char *)block + 1) == -1);
+  UNIT_TEST_ASSERT(memb_free(&test_memb, &elements[0]) == -1);
+  UNIT_TEST_ASSERT(memb_free(&test_memb, block) == 0);
+  UNIT_TEST_ASSERT(memb_free(&test_memb, block) == -1);
+  UNIT_TEST_ASSERT(memb_numfree(&test_memb) == 1);
+
+  for(int i = 0; i < MEMB_BLOCK_COUNT; i++) {
+    if(i != MEMB_BLOCK_COUNT / 2) {
+      UNIT_TEST_ASSERT(memb_free(&test_memb, blocks[i]) == 0);
+    }
+  }
+  UNIT_TEST_ASSERT(memb_numfree(&test_memb) == MEMB_BLOCK_COUNT);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+#ifdef CONTIKI_TARGET_NATIVE
+#define MEMB_BENCH_ROUNDS 1000000
+#else
+#define MEMB_BENCH_ROUNDS 1000
+#endif
+
+UNIT_TEST_REGISTER(test_memb_bench, "Memory block benchmark");
+UNIT_TEST(test_memb_bench)
+{
+  demo_struct_t *blocks[MEMB_BLOCK_COUNT];
+  rtimer_clock_t start;
+
+  UNIT_TEST_BEGIN();
+
+  memb_init(&test_memb);
+  for(int i = 0; i < MEMB_BLOCK_COUNT; i++) {
+    blocks[i] = memb_alloc(&test_memb);
+  }
+
+  /*
+   * Reallocate blocks at the end of a nearly full set, which is the
+   * worst case for an allocator that searches for free blocks.
+   */
+  start = RTIMER_NOW();
+  for(unsigned long i = 0; i < MEMB_BENCH_ROUNDS; i++) {
+    int index = MEMB_BLOCK_COUNT - 1 - (i & 7);
+    if(memb_free(&test_memb, blocks[index]) != 0) {
+      break;
+    }
+    blocks[index] = memb_alloc(&test_memb);
+  }
+  printf("memb: %lu deallocations and allocations of %u blocks in %lu ticks "
+         "(%lu ticks per second)\n",
+         (unsigned long)MEMB_BENCH_ROUNDS, MEMB_BLOCK_COUNT,
+         (unsigned long)RTIMER_CLOCK_DIFF(RTIMER_NOW(), start),
+         (unsigned long)RTIMER_SECOND);
+
+  UNIT_TEST_ASSERT(memb_numfree(&test_memb) == 0);
+  for(int i = 0; i < MEMB_BLOCK_COUNT; i++) {
+    UNIT_TEST_ASSERT(memb_free(&test_memb, blocks[i]) == 0);
+  }
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
 PROCESS_THREAD(data_structure_test_process, ev, data)
 {
   PROCESS_BEGIN();
@@ -1039,6 +1135,8 @@ PROCESS_THREAD(data_structure_test_process, ev, data)
   UNIT_TEST_RUN(test_csll);
   UNIT_TEST_RUN(test_dll);
   UNIT_TEST_RUN(test_cdll);
+  UNIT_TEST_RUN(test_memb_blocks);
+  UNIT_TEST_RUN(test_memb_bench);
 
   printf("=check-me= DONE\n");
 
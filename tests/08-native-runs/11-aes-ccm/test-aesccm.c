@@ -33,12 +33,24 @@
 #include "unit-test.h"
 #include "lib/ccm-star.h"
 #include "lib/hexconv.h"
+#include "dev/native-aes-128.h"
 #include <string.h>
 #include <stdio.h>
 #include <stdbool.h>
+#include <sys/time.h>
 
 #define MICLEN 8
 
+/* 127-byte frames: header, secured payload, MIC and 2-byte FCS */
+#define FRAME_HDR_LEN 21
+#define FRAME_PAYLOAD_LEN (127 - FRAME_HDR_LEN - MICLEN - 2)
+#define BENCH_BLOCKS 2000000
+#define BENCH_FRAMES 200000
+#define BATCH_FRAMES 16
+
+#define STRINGIFY_(x) #x
+#define STRINGIFY(x) STRINGIFY_(x)
+
 PROCESS(test_process, "test");
 AUTOSTART_PROCESSES(&test_process);
 
@@ -166,6 +178,213 @@ UNIT_TEST(aesccm_decrypt)
   UNIT_TEST_END();
 }
 /*---------------------------------------------------------------------------*/
+static uint64_t
+now_ns(void)
+{
+  struct timeval tv;
+
+  gettimeofday(&tv, NULL);
+  return (uint64_t)tv.tv_sec * 1000000000 + (uint64_t)tv.tv_usec * 1000;
+}
+/*---------------------------------------------------------------------------*/
+static const struct {
+  const char *name;
+  const struct aes_128_driver *driver;
+} drivers[] = {
+  { "aes_128_driver", &aes_128_driver },
+  { "aes_128_ttable_driver", &aes_128_ttable_driver },
+  { "native_aes_128_driver", &native_aes_128_driver },
+};
+#define NUM_DRIVERS (sizeof(drivers) / sizeof(drivers[0]))
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(aes_drivers, "AES-128 drivers");
+UNIT_TEST(aes_drivers)
+{
+  /* FIPS-197, appendix C.1 */
+  static const char *fips_key = "000102030405060708090a0b0c0d0e0f";
+  static const char *fips_plaintext = "00112233445566778899aabbccddeeff";
+  static const char *fips_ciphertext = "69c4e0d86a7b0430d8cdb78070b4c55a";
+  uint8_t key_bytes[16];
+  uint8_t block[16];
+  uint8_t expected[16];
+  uint8_t reference[16];
+  uint8_t schedule[AES_128_SCHEDULE_SIZE];
+  int i, j;
+
+  UNIT_TEST_BEGIN();
+
+  hexconv_unhexlify(fips_key, strlen(fips_key), key_bytes, sizeof(key_bytes));
+  hexconv_unhexlify(fips_ciphertext, strlen(fips_ciphertext),
+                    expected, sizeof(expected));
+  for(i = 0; i < NUM_DRIVERS; i++) {
+    hexconv_unhexlify(fips_plaintext, strlen(fips_plaintext),
+                      block, sizeof(block));
+    drivers[i].driver->set_key(key_bytes);
+    drivers[i].driver->encrypt(block);
+    printf("TEST: %s FIPS-197 --- %s\n", drivers[i].name,
+           memcmp(block, expected, sizeof(block)) ? "FAIL" : "OK");
+    UNIT_TEST_ASSERT(!memcmp(block, expected, sizeof(block)));
+  }
+
+  /* Chained encryptions under changing keys agree with the byte-oriented
+     driver */
+  for(i = 1; i < NUM_DRIVERS; i++) {
+    for(j = 0; j < 16; j++) {
+      key_bytes[j] = j * 17 + 3;
+      block[j] = reference[j] = j;
+    }
+    for(j = 0; j < 1000; j++) {
+      aes_128_driver.set_key(key_bytes);
+      aes_128_driver.encrypt(reference);
+      drivers[i].driver->set_key(key_bytes);
+      drivers[i].driver->encrypt(block);
+      key_bytes[j & 15] ^= reference[(j * 7) & 15];
+    }
+    UNIT_TEST_ASSERT(!memcmp(block, reference, sizeof(block)));
+  }
+
+  /* A saved key schedule brings the key back after another one was set */
+  hexconv_unhexlify(fips_key, strlen(fips_key), key_bytes, sizeof(key_bytes));
+  for(i = 0; i < NUM_DRIVERS; i++) {
+    drivers[i].driver->set_key(key_bytes);
+    drivers[i].driver->save_key(schedule);
+    drivers[i].driver->set_key(reference);
+    drivers[i].driver->load_key(schedule);
+    hexconv_unhexlify(fips_plaintext, strlen(fips_plaintext),
+                      block, sizeof(block));
+    drivers[i].driver->encrypt(block);
+    UNIT_TEST_ASSERT(!memcmp(block, expected, sizeof(block)));
+  }
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(aesccm_batch, "AES-CCM batches");
+UNIT_TEST(aesccm_batch)
+{
+  static uint8_t key_bytes[16];
+  static uint8_t nonces[BATCH_FRAMES][CCM_STAR_NONCE_LENGTH];
+  static uint8_t frames[BATCH_FRAMES][127];
+  static uint8_t expected[BATCH_FRAMES][127];
+  static struct ccm_star_frame batch[BATCH_FRAMES];
+  uint8_t mic[MICLEN];
+  int i, j, a_len, m_len;
+
+  UNIT_TEST_BEGIN();
+
+  hexconv_unhexlify(key, strlen(key), key_bytes, sizeof(key_bytes));
+  for(i = 0; i < BATCH_FRAMES; i++) {
+    hexconv_unhexlify(nonce, strlen(nonce), nonces[i], sizeof(nonces[i]));
+    nonces[i][12] = i;
+    for(j = 0; j < sizeof(frames[i]); j++) {
+      frames[i][j] = expected[i][j] = i * 31 + j;
+    }
+    /* Lengths around block boundaries, including no encryption */
+    a_len = 5 + i;
+    m_len = (i * 13) % (sizeof(frames[i]) - a_len - MICLEN);
+    batch[i].nonce = nonces[i];
+    batch[i].a = frames[i];
+    batch[i].a_len = a_len;
+    batch[i].m = frames[i] + a_len;
+    batch[i].m_len = m_len;
+    batch[i].result = frames[i] + a_len + m_len;
+    batch[i].mic_len = MICLEN;
+
+    /* Reference: one frame at a time */
+    CCM_STAR.set_key(key_bytes);
+    CCM_STAR.aead(nonces[i], expected[i] + a_len, m_len,
+                  expected[i], a_len, expected[i] + a_len + m_len, MICLEN, 1);
+  }
+
+  ccm_star_aead_batch(key_bytes, batch, BATCH_FRAMES, 1);
+  for(i = 0; i < BATCH_FRAMES; i++) {
+    UNIT_TEST_ASSERT(!memcmp(frames[i], expected[i], sizeof(frames[i])));
+  }
+
+  /* Decrypting in a batch restores the frames and their MICs */
+  for(i = 0; i < BATCH_FRAMES; i++) {
+    memcpy(mic, batch[i].result, MICLEN);
+    memset(batch[i].result, 0, MICLEN);
+    ccm_star_aead_batch(key_bytes, &batch[i], 1, 0);
+    UNIT_TEST_ASSERT(!memcmp(mic, batch[i].result, MICLEN));
+    for(j = 0; j < batch[i].a_len + batch[i].m_len; j++) {
+      UNIT_TEST_ASSERT(frames[i][j] == (uint8_t)(i * 31 + j));
+    }
+  }
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(aes_benchmark, "AES-128 and CCM* throughput");
+UNIT_TEST(aes_benchmark)
+{
+  static uint8_t key_bytes[16];
+  static uint8_t nonce_bytes[13];
+  static uint8_t frame[127];
+  static struct ccm_star_frame batch[BATCH_FRAMES];
+  uint8_t block[16];
+  uint64_t start, elapsed;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  hexconv_unhexlify(key, strlen(key), key_bytes, sizeof(key_bytes));
+  hexconv_unhexlify(nonce, strlen(nonce), nonce_bytes, sizeof(nonce_bytes));
+  memset(block, 0, sizeof(block));
+
+  for(i = 0; i < NUM_DRIVERS; i++) {
+    int j;
+
+    drivers[i].driver->set_key(key_bytes);
+    start = now_ns();
+    for(j = 0; j < BENCH_BLOCKS; j++) {
+      drivers[i].driver->encrypt(block);
+    }
+    elapsed = now_ns() - start;
+    printf("BENCH: %-22s %8.1f ns/block %10.0f blocks/s\n", drivers[i].name,
+           (double)elapsed / BENCH_BLOCKS,
+           BENCH_BLOCKS * 1e9 / elapsed);
+  }
+
+  /* Secure and authenticate 127-byte frames with CCM* over AES_128 */
+  for(i = 0; i < sizeof(frame); i++) {
+    frame[i] = i;
+  }
+  CCM_STAR.set_key(key_bytes);
+  start = now_ns();
+  for(i = 0; i < BENCH_FRAMES; i++) {
+    CCM_STAR.aead(nonce_bytes,
+                  frame + FRAME_HDR_LEN, FRAME_PAYLOAD_LEN,
+                  frame, FRAME_HDR_LEN,
+                  frame + FRAME_HDR_LEN + FRAME_PAYLOAD_LEN, MICLEN, 1);
+  }
+  elapsed = now_ns() - start;
+  printf("BENCH: CCM* with %s: %.0f frames/s (%.2f us/frame)\n",
+         STRINGIFY(AES_128), BENCH_FRAMES * 1e9 / elapsed,
+         (double)elapsed / BENCH_FRAMES / 1000);
+
+  /* The same frames in batches, as a forwarder draining a queue would */
+  for(i = 0; i < BATCH_FRAMES; i++) {
+    batch[i].nonce = nonce_bytes;
+    batch[i].a = frame;
+    batch[i].a_len = FRAME_HDR_LEN;
+    batch[i].m = frame + FRAME_HDR_LEN;
+    batch[i].m_len = FRAME_PAYLOAD_LEN;
+    batch[i].result = frame + FRAME_HDR_LEN + FRAME_PAYLOAD_LEN;
+    batch[i].mic_len = MICLEN;
+  }
+  start = now_ns();
+  for(i = 0; i < BENCH_FRAMES; i += BATCH_FRAMES) {
+    ccm_star_aead_batch(key_bytes, batch, BATCH_FRAMES, 1);
+  }
+  elapsed = now_ns() - start;
+  printf("BENCH: CCM* batches of %d: %.0f frames/s (%.2f us/frame)\n",
+         BATCH_FRAMES, BENCH_FRAMES * 1e9 / elapsed,
+         (double)elapsed / BENCH_FRAMES / 1000);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
 PROCESS_THREAD(test_process, ev, data)
 {
   PROCESS_BEGIN();
@@ -175,6 +394,18 @@ PROCESS_THREAD(test_process, ev, data)
 
   UNIT_TEST_RUN(aesccm_encrypt);
   UNIT_TEST_RUN(aesccm_decrypt);
+  UNIT_TEST_RUN(aesccm_batch);
+  UNIT_TEST_RUN(aes_drivers);
+  UNIT_TEST_RUN(aes_benchmark);
+
+  if(!UNIT_TEST_PASSED(aesccm_encrypt) ||
+     !UNIT_TEST_PASSED(aesccm_decrypt) ||
+     !UNIT_TEST_PASSED(aesccm_batch) ||
+     !UNIT_TEST_PASSED(aes_drivers) ||
+     !UNIT_TEST_PASSED(aes_benchmark)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
 
   printf("=check-me= DONE\n");
   printf("---\n");
@@ -34,10 +34,12 @@
  *      Nicolas Tsiftes <nicolas.tsiftes@ri.se>
  */
 
+#include <inttypes.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 #include "contiki.h"
 #include "lib/heapmem.h"
@@ -67,6 +69,20 @@
 #define TEST_MAX_SIZE       200
 #endif
 /*****************************************************************************/
+/* Configuration for the Fragmentation benchmark. */
+
+/* Number of objects kept allocated under light and heavy load. The
+   latter fills most of the arena. */
+#define TEST_BENCH_LIGHT_OBJECTS 1500
+#define TEST_BENCH_HEAVY_OBJECTS 6000
+
+/* Number of deallocations followed by an allocation. */
+#ifdef TEST_CONF_BENCH_ROUNDS
+#define TEST_BENCH_ROUNDS TEST_CONF_BENCH_ROUNDS
+#else
+#define TEST_BENCH_ROUNDS 500000
+#endif
+/*****************************************************************************/
 PROCESS(test_heapmem_process, "Heapmem test process");
 AUTOSTART_PROCESSES(&test_heapmem_process);
 /*****************************************************************************/
@@ -252,6 +268,93 @@ UNIT_TEST(stats_check)
   UNIT_TEST_END();
 }
 /*****************************************************************************/
+static uint64_t
+now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*****************************************************************************/
+static size_t
+bench_size(void)
+{
+  /* Mostly small objects of a few common sizes, as allocated by
+     protocol implementations, mixed with some larger buffers. */
+  static const size_t small_sizes[] = { 12, 24, 40, 64, 100 };
+
+  if(rand() % 16 == 0) {
+    return 200 + rand() % 1000;
+  }
+  return small_sizes[rand() % (sizeof(small_sizes) / sizeof(small_sizes[0]))];
+}
+/*****************************************************************************/
+static bool
+bench_run(const char *name, unsigned objects)
+{
+  static char *ptrs[TEST_BENCH_HEAVY_OBJECTS];
+  unsigned failed_allocations = 0;
+  unsigned failed_deallocations = 0;
+  heapmem_stats_t stats;
+
+  for(unsigned i = 0; i < objects; i++) {
+    ptrs[i] = heapmem_alloc(bench_size());
+  }
+
+  /* Replace random objects with new ones of random sizes. */
+  uint64_t start = now_ns();
+  for(unsigned i = 0; i < TEST_BENCH_ROUNDS; i++) {
+    unsigned index = rand() % objects;
+    if(ptrs[index] != NULL && heapmem_free(ptrs[index]) == false) {
+      failed_deallocations++;
+    }
+    ptrs[index] = heapmem_alloc(bench_size());
+    if(ptrs[index] == NULL) {
+      failed_allocations++;
+    }
+  }
+  uint64_t elapsed = now_ns() - start;
+
+  heapmem_stats(&stats);
+
+  printf("%s load, %u objects: %" PRIu64 " ns per round, "
+         "%u failed allocations\n",
+         name, objects, elapsed / TEST_BENCH_ROUNDS, failed_allocations);
+  printf("* allocated %zu\n* footprint %zu\n* available %zu\n"
+         "* largest free %zu\n* free chunks %zu (%zu in size classes)\n",
+         stats.allocated, stats.footprint, stats.available,
+         stats.largest_free, stats.free_chunks, stats.classed_chunks);
+
+  for(unsigned i = 0; i < objects; i++) {
+    if(ptrs[i] != NULL && heapmem_free(ptrs[i]) == false) {
+      failed_deallocations++;
+    }
+  }
+
+  if(failed_deallocations > 0 ||
+     stats.largest_free > stats.available ||
+     stats.classed_chunks > stats.free_chunks) {
+    return false;
+  }
+
+  /* Free chunks may remain at the end of the heap until it is trimmed. */
+  heapmem_trim();
+  heapmem_stats(&stats);
+
+  return stats.footprint == 0 && stats.free_chunks == 0;
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(fragmentation, "Fragmentation benchmark");
+UNIT_TEST(fragmentation)
+{
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(bench_run("Light", TEST_BENCH_LIGHT_OBJECTS));
+  UNIT_TEST_ASSERT(bench_run("Heavy", TEST_BENCH_HEAVY_OBJECTS));
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
 PROCESS_THREAD(test_heapmem_process, ev, data)
 {
   PROCESS_BEGIN();
@@ -267,11 +370,13 @@ PROCESS_THREAD(test_heapmem_process, ev, data)
   UNIT_TEST_RUN(max_alloc);
   UNIT_TEST_RUN(invalid_freeing);
   UNIT_TEST_RUN(reallocations);
+  UNIT_TEST_RUN(fragmentation);
   UNIT_TEST_RUN(stats_check);
 
   if(!UNIT_TEST_PASSED(do_many_allocations) ||
      !UNIT_TEST_PASSED(max_alloc) ||
      !UNIT_TEST_PASSED(invalid_freeing) ||
+     !UNIT_TEST_PASSED(fragmentation) ||
      !UNIT_TEST_PASSED(stats_check)) {
     printf("=check-me= FAILED\n");
     printf("---\n");
@@ -53,6 +53,9 @@ AUTOSTART_PROCESSES(&testcoffee_process);
 #else
 #define FILE_SIZE	4096
 #endif /* FILE_CONF_SIZE */
+
+/* Number of files created by the name index test. */
+#define INDEX_FILES	40
 /*---------------------------------------------------------------------------*/
 static int wfd, rfd, afd;
 /*---------------------------------------------------------------------------*/
@@ -252,6 +255,115 @@ UNIT_TEST(coffee_gc)
   UNIT_TEST_END();
 }
 /*---------------------------------------------------------------------------*/
+static int
+open_index_file(unsigned i, int flags)
+{
+  char name[8];
+
+  snprintf(name, sizeof(name), "I%u", i);
+  return cfs_open(name, flags);
+}
+/*---------------------------------------------------------------------------*/
+/* Checks that the files with numbers in [first, last) hold their number. */
+static int
+check_index_files(unsigned first, unsigned last)
+{
+  unsigned i;
+  unsigned char n;
+  int fd, r;
+
+  for(i = first; i < last; i++) {
+    fd = open_index_file(i, CFS_READ);
+    if(fd < 0) {
+      return 0;
+    }
+    r = cfs_read(fd, &n, 1);
+    cfs_close(fd);
+    if(r != 1 || n != i) {
+      return 0;
+    }
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(coffee_name_index, "Coffee file lookups");
+UNIT_TEST(coffee_name_index)
+{
+  UNIT_TEST_BEGIN();
+
+  char name[8];
+  unsigned i;
+  unsigned char n;
+  int fd;
+#if COFFEE_STATS
+  unsigned long reads;
+#endif /* COFFEE_STATS */
+
+  UNIT_TEST_ASSERT(cfs_coffee_format() == 0);
+
+  /* Create more files than the name index holds, if there is one. */
+  for(i = 0; i < INDEX_FILES; i++) {
+    snprintf(name, sizeof(name), "I%u", i);
+    UNIT_TEST_ASSERT(cfs_coffee_reserve(name, 32) == 0);
+    fd = cfs_open(name, CFS_WRITE);
+    UNIT_TEST_ASSERT(fd >= 0);
+    n = i;
+    UNIT_TEST_ASSERT(cfs_write(fd, &n, 1) == 1);
+    cfs_close(fd);
+  }
+  UNIT_TEST_ASSERT(check_index_files(0, INDEX_FILES));
+
+  /* Remove half of the files; the rest must still be found. */
+  for(i = 0; i < INDEX_FILES; i += 2) {
+    snprintf(name, sizeof(name), "I%u", i);
+    UNIT_TEST_ASSERT(cfs_remove(name) == 0);
+  }
+  for(i = 0; i < INDEX_FILES; i++) {
+    fd = open_index_file(i, CFS_READ);
+    UNIT_TEST_ASSERT((fd >= 0) == (i & 1));
+    cfs_close(fd);
+  }
+
+  /* Recreate a removed file and remove the last one. */
+  fd = open_index_file(0, CFS_WRITE);
+  UNIT_TEST_ASSERT(fd >= 0);
+  n = 0;
+  UNIT_TEST_ASSERT(cfs_write(fd, &n, 1) == 1);
+  cfs_close(fd);
+  UNIT_TEST_ASSERT(check_index_files(0, 1));
+  snprintf(name, sizeof(name), "I%u", INDEX_FILES - 1);
+  UNIT_TEST_ASSERT(cfs_remove(name) == 0);
+  UNIT_TEST_ASSERT(open_index_file(INDEX_FILES - 1, CFS_READ) < 0);
+
+#if COFFEE_STATS
+  /* Measure the header reads when opening existing and missing files. */
+  reads = cfs_coffee_stats.header_reads;
+  for(i = 1; i < INDEX_FILES - 1; i += 2) {
+    fd = open_index_file(i, CFS_READ);
+    UNIT_TEST_ASSERT(fd >= 0);
+    cfs_close(fd);
+  }
+  reads = cfs_coffee_stats.header_reads - reads;
+  printf("Name index size %u\n", (unsigned)COFFEE_NAME_INDEX_SIZE);
+  printf("Header reads per open: %lu (existing file)", reads / (INDEX_FILES / 2 - 1));
+#if COFFEE_NAME_INDEX_SIZE
+  UNIT_TEST_ASSERT(reads <= 2 * (INDEX_FILES / 2 - 1));
+#endif /* COFFEE_NAME_INDEX_SIZE */
+
+  reads = cfs_coffee_stats.header_reads;
+  for(i = 2; i < INDEX_FILES; i += 2) {
+    UNIT_TEST_ASSERT(open_index_file(i, CFS_READ) < 0);
+  }
+  reads = cfs_coffee_stats.header_reads - reads;
+  printf(", %lu (missing file)\n", reads / (INDEX_FILES / 2 - 1));
+#if COFFEE_NAME_INDEX_SIZE
+  UNIT_TEST_ASSERT(reads <= INDEX_FILES / 2 - 1);
+#endif /* COFFEE_NAME_INDEX_SIZE */
+#endif /* COFFEE_STATS */
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
 PROCESS_THREAD(testcoffee_process, ev, data)
 {
   PROCESS_BEGIN();
@@ -263,6 +375,7 @@ PROCESS_THREAD(testcoffee_process, ev, data)
   UNIT_TEST_RUN(coffee_append);
   UNIT_TEST_RUN(coffee_modify);
   UNIT_TEST_RUN(coffee_gc);
+  UNIT_TEST_RUN(coffee_name_index);
 
   cfs_close(wfd);
   cfs_close(rfd);
@@ -274,7 +387,8 @@ PROCESS_THREAD(testcoffee_process, ev, data)
   if(!UNIT_TEST_PASSED(coffee_basic_io) ||
      !UNIT_TEST_PASSED(coffee_append) ||
      !UNIT_TEST_PASSED(coffee_modify) ||
-     !UNIT_TEST_PASSED(coffee_gc)) {
+     !UNIT_TEST_PASSED(coffee_gc) ||
+     !UNIT_TEST_PASSED(coffee_name_index)) {
     printf("=check-me= FAILED\n");
     printf("---\n");
   }
@@ -0,0 +1,3 @@
+#!/bin/bash -e
+
+./run-one.sh 14-nbr-table
@@ -0,0 +1,250 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Unit tests and lookup benchmark for the neighbor table.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "contiki.h"
+#include "net/nbr-table.h"
+#include "unit-test/unit-test.h"
+/*****************************************************************************/
+/* Number of lookups per neighbor in the benchmark. */
+#ifdef TEST_CONF_LOOKUPS
+#define TEST_LOOKUPS TEST_CONF_LOOKUPS
+#else
+#define TEST_LOOKUPS 200
+#endif
+/*****************************************************************************/
+PROCESS(test_nbr_table_process, "Neighbor table test process");
+AUTOSTART_PROCESSES(&test_nbr_table_process);
+
+struct test_nbr {
+  unsigned id;
+};
+NBR_TABLE(struct test_nbr, test_table);
+
+static unsigned removed_count;
+/*****************************************************************************/
+static void
+removed_callback(nbr_table_item_t *item)
+{
+  removed_count++;
+}
+/*****************************************************************************/
+static void
+make_lladdr(linkaddr_t *lladdr, unsigned id)
+{
+  memset(lladdr, 0, sizeof(*lladdr));
+  lladdr->u8[0] = 0x02;
+  lladdr->u8[LINKADDR_SIZE - 2] = id >> 8;
+  lladdr->u8[LINKADDR_SIZE - 1] = id & 0xff;
+}
+/*****************************************************************************/
+static uint64_t
+now_ns(void)
+{
+  struct timeval tv;
+
+  gettimeofday(&tv, NULL);
+  return (uint64_t)tv.tv_sec * 1000000000 + (uint64_t)tv.tv_usec * 1000;
+}
+/*****************************************************************************/
+/* Reference lookup: the linear walk over the neighbor keys. */
+static nbr_table_key_t *
+linear_lookup(const linkaddr_t *lladdr)
+{
+  nbr_table_key_t *key;
+
+  for(key = nbr_table_key_head(); key != NULL; key = nbr_table_key_next(key)) {
+    if(linkaddr_cmp(lladdr, &key->lladdr)) {
+      return key;
+    }
+  }
+  return NULL;
+}
+/*****************************************************************************/
+static int
+fill_table(unsigned count)
+{
+  struct test_nbr *nbr;
+  linkaddr_t lladdr;
+  unsigned i;
+
+  nbr_table_clear();
+  for(i = 0; i < count; i++) {
+    make_lladdr(&lladdr, i);
+    nbr = nbr_table_add_lladdr(test_table, &lladdr,
+                               NBR_TABLE_REASON_UNDEFINED, NULL);
+    if(nbr == NULL) {
+      return 0;
+    }
+    nbr->id = i;
+  }
+  return 1;
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(add_lookup_evict, "Add, lookup and evict neighbors");
+UNIT_TEST(add_lookup_evict)
+{
+  UNIT_TEST_BEGIN();
+
+  struct test_nbr *nbr;
+  linkaddr_t lladdr;
+  unsigned i;
+
+  UNIT_TEST_ASSERT(fill_table(NBR_TABLE_MAX_NEIGHBORS));
+  UNIT_TEST_ASSERT(nbr_table_count_entries() == NBR_TABLE_MAX_NEIGHBORS);
+
+  for(i = 0; i < NBR_TABLE_MAX_NEIGHBORS; i++) {
+    make_lladdr(&lladdr, i);
+    nbr = nbr_table_get_from_lladdr(test_table, &lladdr);
+    UNIT_TEST_ASSERT(nbr != NULL);
+    UNIT_TEST_ASSERT(nbr->id == i);
+  }
+
+  /* Unknown addresses are not found. */
+  make_lladdr(&lladdr, NBR_TABLE_MAX_NEIGHBORS);
+  UNIT_TEST_ASSERT(nbr_table_get_from_lladdr(test_table, &lladdr) == NULL);
+
+  /* Lock the even neighbors, and add as many new neighbors as there
+     are odd ones. Every new neighbor evicts an unlocked one. */
+  for(i = 0; i < NBR_TABLE_MAX_NEIGHBORS; i += 2) {
+    make_lladdr(&lladdr, i);
+    nbr_table_lock(test_table, nbr_table_get_from_lladdr(test_table, &lladdr));
+  }
+  removed_count = 0;
+  for(i = 0; i < NBR_TABLE_MAX_NEIGHBORS / 2; i++) {
+    make_lladdr(&lladdr, NBR_TABLE_MAX_NEIGHBORS + i);
+    nbr = nbr_table_add_lladdr(test_table, &lladdr,
+                               NBR_TABLE_REASON_UNDEFINED, NULL);
+    UNIT_TEST_ASSERT(nbr != NULL);
+    nbr->id = NBR_TABLE_MAX_NEIGHBORS + i;
+  }
+  UNIT_TEST_ASSERT(removed_count == NBR_TABLE_MAX_NEIGHBORS / 2);
+
+  for(i = 0; i < NBR_TABLE_MAX_NEIGHBORS + NBR_TABLE_MAX_NEIGHBORS / 2; i++) {
+    make_lladdr(&lladdr, i);
+    nbr = nbr_table_get_from_lladdr(test_table, &lladdr);
+    if(i < NBR_TABLE_MAX_NEIGHBORS && (i & 1)) {
+      UNIT_TEST_ASSERT(nbr == NULL);
+      UNIT_TEST_ASSERT(linear_lookup(&lladdr) == NULL);
+    } else {
+      UNIT_TEST_ASSERT(nbr != NULL);
+      UNIT_TEST_ASSERT(nbr->id == i);
+      UNIT_TEST_ASSERT(nbr_table_get_lladdr(test_table, nbr) ==
+                       &linear_lookup(&lladdr)->lladdr);
+    }
+  }
+
+  nbr_table_clear();
+  UNIT_TEST_ASSERT(nbr_table_count_entries() == 0);
+  for(i = 0; i < NBR_TABLE_MAX_NEIGHBORS; i++) {
+    make_lladdr(&lladdr, i);
+    UNIT_TEST_ASSERT(nbr_table_get_from_lladdr(test_table, &lladdr) == NULL);
+  }
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(lookup_benchmark, "Lookup cost versus table size");
+UNIT_TEST(lookup_benchmark)
+{
+  UNIT_TEST_BEGIN();
+
+  static const unsigned sizes[] = { 16, 128, 512 };
+  linkaddr_t lladdr;
+  uint64_t start, table_ns, linear_ns;
+  unsigned i, j, k, lookups;
+
+  printf("Hash index %s\n", NBR_TABLE_WITH_HASH ? "enabled" : "disabled");
+
+  for(k = 0; k < sizeof(sizes) / sizeof(sizes[0]); k++) {
+    if(sizes[k] > NBR_TABLE_MAX_NEIGHBORS) {
+      continue;
+    }
+    UNIT_TEST_ASSERT(fill_table(sizes[k]));
+    lookups = TEST_LOOKUPS * sizes[k];
+
+    start = now_ns();
+    for(j = 0; j < TEST_LOOKUPS; j++) {
+      for(i = 0; i < sizes[k]; i++) {
+        make_lladdr(&lladdr, i);
+        UNIT_TEST_ASSERT(nbr_table_get_from_lladdr(test_table, &lladdr) != NULL);
+      }
+    }
+    table_ns = now_ns() - start;
+
+    start = now_ns();
+    for(j = 0; j < TEST_LOOKUPS; j++) {
+      for(i = 0; i < sizes[k]; i++) {
+        make_lladdr(&lladdr, i);
+        UNIT_TEST_ASSERT(linear_lookup(&lladdr) != NULL);
+      }
+    }
+    linear_ns = now_ns() - start;
+
+    printf("%3u neighbors: nbr_table %5lu ns/lookup, linear walk %5lu ns/lookup\n",
+           sizes[k], (unsigned long)(table_ns / lookups),
+           (unsigned long)(linear_ns / lookups));
+  }
+
+  nbr_table_clear();
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_nbr_table_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  nbr_table_register(test_table, removed_callback);
+
+  UNIT_TEST_RUN(add_lookup_evict);
+  UNIT_TEST_RUN(lookup_benchmark);
+
+  if(!UNIT_TEST_PASSED(add_lookup_evict) ||
+     !UNIT_TEST_PASSED(lookup_benchmark)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
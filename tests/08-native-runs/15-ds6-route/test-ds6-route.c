@@ -0,0 +1,296 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Unit tests and lookup benchmark for the IPv6 routing table.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "contiki.h"
+#include "net/ipv6/uip-ds6.h"
+#include "net/ipv6/uip-ds6-nbr.h"
+#include "net/ipv6/uip-ds6-route.h"
+#include "unit-test/unit-test.h"
+/*****************************************************************************/
+/* Number of packets forwarded to each destination in the benchmark. */
+#ifdef TEST_CONF_PACKETS
+#define TEST_PACKETS TEST_CONF_PACKETS
+#else
+#define TEST_PACKETS 100
+#endif
+
+/* Number of next hops that the routes are spread over. */
+#define TEST_NEXTHOPS 4
+/*****************************************************************************/
+PROCESS(test_ds6_route_process, "IPv6 route test process");
+AUTOSTART_PROCESSES(&test_ds6_route_process);
+
+static uip_ipaddr_t nexthops[TEST_NEXTHOPS];
+/*****************************************************************************/
+static void
+make_destination(uip_ipaddr_t *ipaddr, unsigned id)
+{
+  uip_ip6addr(ipaddr, 0xfd00, 0, 0, 0, 0x0212, 0x7400, id >> 16, id & 0xffff);
+}
+/*****************************************************************************/
+static uint64_t
+now_ns(void)
+{
+  struct timeval tv;
+
+  gettimeofday(&tv, NULL);
+  return (uint64_t)tv.tv_sec * 1000000000 + (uint64_t)tv.tv_usec * 1000;
+}
+/*****************************************************************************/
+static int
+add_nexthops(void)
+{
+  uip_lladdr_t lladdr;
+  unsigned i;
+
+  for(i = 0; i < TEST_NEXTHOPS; i++) {
+    memset(&lladdr, 0, sizeof(lladdr));
+    lladdr.addr[0] = 0x02;
+    lladdr.addr[sizeof(lladdr) - 1] = i + 1;
+    uip_ip6addr(&nexthops[i], 0xfe80, 0, 0, 0, 0, 0, 0, i + 1);
+    if(uip_ds6_nbr_add(&nexthops[i], &lladdr, 1, NBR_REACHABLE,
+                       NBR_TABLE_REASON_UNDEFINED, NULL) == NULL) {
+      return 0;
+    }
+  }
+  return 1;
+}
+/*****************************************************************************/
+static void
+remove_routes(void)
+{
+  uip_ds6_route_t *r;
+
+  while((r = uip_ds6_route_head()) != NULL) {
+    uip_ds6_route_rm(r);
+  }
+}
+/*****************************************************************************/
+static int
+add_routes(unsigned count)
+{
+  uip_ipaddr_t ipaddr;
+  unsigned i;
+
+  remove_routes();
+  for(i = 0; i < count; i++) {
+    make_destination(&ipaddr, i);
+    if(uip_ds6_route_add(&ipaddr, 128, &nexthops[i % TEST_NEXTHOPS]) == NULL) {
+      return 0;
+    }
+  }
+  return uip_ds6_route_num_routes() == count;
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(route_lookup, "Host and prefix route lookups");
+UNIT_TEST(route_lookup)
+{
+  UNIT_TEST_BEGIN();
+
+  uip_ds6_route_t *r;
+  uip_ipaddr_t ipaddr;
+  unsigned i;
+
+  UNIT_TEST_ASSERT(add_routes(UIP_DS6_ROUTE_NB));
+
+  for(i = 0; i < UIP_DS6_ROUTE_NB; i++) {
+    make_destination(&ipaddr, i);
+    r = uip_ds6_route_lookup(&ipaddr);
+    UNIT_TEST_ASSERT(r != NULL);
+    UNIT_TEST_ASSERT(uip_ipaddr_cmp(&r->ipaddr, &ipaddr));
+    UNIT_TEST_ASSERT(uip_ipaddr_cmp(uip_ds6_route_nexthop(r),
+                                    &nexthops[i % TEST_NEXTHOPS]));
+  }
+
+  /* Without a prefix route, unknown destinations have no route. */
+  make_destination(&ipaddr, UIP_DS6_ROUTE_NB);
+  UNIT_TEST_ASSERT(uip_ds6_route_lookup(&ipaddr) == NULL);
+
+  /* Remove every other route, and cover the removed destinations with
+     prefix routes of different lengths. */
+  for(i = 0; i < UIP_DS6_ROUTE_NB; i += 2) {
+    make_destination(&ipaddr, i);
+    uip_ds6_route_rm(uip_ds6_route_lookup(&ipaddr));
+  }
+  UNIT_TEST_ASSERT(uip_ds6_route_num_routes() == UIP_DS6_ROUTE_NB / 2);
+
+  make_destination(&ipaddr, 0);
+  UNIT_TEST_ASSERT(uip_ds6_route_add(&ipaddr, 96, &nexthops[1]) != NULL);
+  uip_ip6addr(&ipaddr, 0xfd00, 0, 0, 0, 0, 0, 0, 0);
+  UNIT_TEST_ASSERT(uip_ds6_route_add(&ipaddr, 64, &nexthops[0]) != NULL);
+
+  for(i = 0; i < UIP_DS6_ROUTE_NB; i++) {
+    make_destination(&ipaddr, i);
+    r = uip_ds6_route_lookup(&ipaddr);
+    UNIT_TEST_ASSERT(r != NULL);
+    if(i & 1) {
+      UNIT_TEST_ASSERT(r->length == 128);
+      UNIT_TEST_ASSERT(uip_ipaddr_cmp(&r->ipaddr, &ipaddr));
+    } else {
+      UNIT_TEST_ASSERT(r->length == 96);
+    }
+  }
+  uip_ip6addr(&ipaddr, 0xfd00, 0, 0, 0, 0, 0, 0, 1);
+  r = uip_ds6_route_lookup(&ipaddr);
+  UNIT_TEST_ASSERT(r != NULL && r->length == 64);
+  uip_ip6addr(&ipaddr, 0xfd01, 0, 0, 0, 0, 0, 0, 1);
+  UNIT_TEST_ASSERT(uip_ds6_route_lookup(&ipaddr) == NULL);
+
+  /* Removing a next hop removes all routes through it. */
+  uip_ds6_route_rm_by_nexthop(&nexthops[1]);
+  for(r = uip_ds6_route_head(); r != NULL; r = uip_ds6_route_next(r)) {
+    UNIT_TEST_ASSERT(!uip_ipaddr_cmp(uip_ds6_route_nexthop(r), &nexthops[1]));
+  }
+  for(i = 1; i < UIP_DS6_ROUTE_NB; i += 2) {
+    make_destination(&ipaddr, i);
+    r = uip_ds6_route_lookup(&ipaddr);
+    UNIT_TEST_ASSERT(r != NULL);
+    UNIT_TEST_ASSERT(r->length == (i % TEST_NEXTHOPS == 1 ? 64 : 128));
+  }
+
+  remove_routes();
+  UNIT_TEST_ASSERT(uip_ds6_route_num_routes() == 0);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(route_eviction, "Least recently used route eviction");
+UNIT_TEST(route_eviction)
+{
+  UNIT_TEST_BEGIN();
+
+  uip_ipaddr_t ipaddr;
+
+  UNIT_TEST_ASSERT(add_routes(UIP_DS6_ROUTE_NB));
+
+  /* Use the first route added, so that the second one is the least
+     recently used when a route is added to the full table. */
+  make_destination(&ipaddr, 0);
+  UNIT_TEST_ASSERT(uip_ds6_route_lookup(&ipaddr) != NULL);
+
+  make_destination(&ipaddr, UIP_DS6_ROUTE_NB);
+  UNIT_TEST_ASSERT(uip_ds6_route_add(&ipaddr, 128, &nexthops[0]) != NULL);
+  UNIT_TEST_ASSERT(uip_ds6_route_num_routes() == UIP_DS6_ROUTE_NB);
+
+  make_destination(&ipaddr, 0);
+  UNIT_TEST_ASSERT(uip_ds6_route_lookup(&ipaddr) != NULL);
+  make_destination(&ipaddr, 1);
+  UNIT_TEST_ASSERT(uip_ds6_route_lookup(&ipaddr) == NULL);
+  make_destination(&ipaddr, 2);
+  UNIT_TEST_ASSERT(uip_ds6_route_lookup(&ipaddr) != NULL);
+
+  /* The route just added is now the most recently used one. */
+  make_destination(&ipaddr, UIP_DS6_ROUTE_NB + 1);
+  UNIT_TEST_ASSERT(uip_ds6_route_add(&ipaddr, 128, &nexthops[1]) != NULL);
+  make_destination(&ipaddr, UIP_DS6_ROUTE_NB);
+  UNIT_TEST_ASSERT(uip_ds6_route_lookup(&ipaddr) != NULL);
+  make_destination(&ipaddr, 3);
+  UNIT_TEST_ASSERT(uip_ds6_route_lookup(&ipaddr) == NULL);
+
+  remove_routes();
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(forward_benchmark, "Forwarding lookups versus routes");
+UNIT_TEST(forward_benchmark)
+{
+  UNIT_TEST_BEGIN();
+
+  static const unsigned sizes[] = { 16, 256, 1024 };
+  uip_ipaddr_t ipaddr;
+  uint64_t start, elapsed;
+  unsigned i, j, k;
+
+  printf("Route hash index %s\n",
+         UIP_DS6_ROUTE_WITH_HASH ? "enabled" : "disabled");
+
+  for(k = 0; k < sizeof(sizes) / sizeof(sizes[0]); k++) {
+    if(sizes[k] > UIP_DS6_ROUTE_NB) {
+      continue;
+    }
+    UNIT_TEST_ASSERT(add_routes(sizes[k]));
+
+    /* Look up the next hop of one packet to each destination in turn,
+       as a forwarder of interleaved flows would. */
+    start = now_ns();
+    for(j = 0; j < TEST_PACKETS; j++) {
+      for(i = 0; i < sizes[k]; i++) {
+        make_destination(&ipaddr, i);
+        UNIT_TEST_ASSERT(uip_ds6_route_lookup(&ipaddr) != NULL);
+      }
+    }
+    elapsed = now_ns() - start;
+
+    printf("%4u destinations: %6lu ns/packet\n", sizes[k],
+           (unsigned long)(elapsed / (TEST_PACKETS * sizes[k])));
+  }
+
+  remove_routes();
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_ds6_route_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  if(!add_nexthops()) {
+    printf("Failed to add next hop neighbors\n");
+    printf("=check-me= FAILED\n");
+  } else {
+    UNIT_TEST_RUN(route_lookup);
+    UNIT_TEST_RUN(route_eviction);
+    UNIT_TEST_RUN(forward_benchmark);
+
+    if(!UNIT_TEST_PASSED(route_lookup) ||
+       !UNIT_TEST_PASSED(route_eviction) ||
+       !UNIT_TEST_PASSED(forward_benchmark)) {
+      printf("=check-me= FAILED\n");
+      printf("---\n");
+    }
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
@@ -0,0 +1,346 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Unit tests and benchmark for the TSCH next active link lookup.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "contiki.h"
+#include "net/mac/tsch/tsch.h"
+#include "unit-test/unit-test.h"
+/*****************************************************************************/
+/* Number of lookups per schedule size in the benchmark. */
+#ifdef TEST_CONF_LOOKUPS
+#define TEST_LOOKUPS TEST_CONF_LOOKUPS
+#else
+#define TEST_LOOKUPS 100000
+#endif
+
+/* Orchestra-like slotframe lengths. */
+#define TEST_EB_PERIOD     397
+#define TEST_COMMON_PERIOD 31
+/*****************************************************************************/
+PROCESS(test_tsch_schedule_process, "TSCH schedule test process");
+AUTOSTART_PROCESSES(&test_tsch_schedule_process);
+/*****************************************************************************/
+/* Stand-ins for the parts of TSCH that the schedule depends on. */
+const linkaddr_t tsch_broadcast_address = { { 0xff, 0xff } };
+struct tsch_link *current_link;
+static int locked;
+
+int
+tsch_is_locked(void)
+{
+  return locked;
+}
+
+int
+tsch_get_lock(void)
+{
+  if(locked) {
+    return 0;
+  }
+  locked = 1;
+  return 1;
+}
+
+void
+tsch_release_lock(void)
+{
+  locked = 0;
+}
+
+struct tsch_neighbor *
+tsch_queue_add_nbr(const linkaddr_t *addr)
+{
+  return NULL;
+}
+
+struct tsch_neighbor *
+tsch_queue_get_nbr(const linkaddr_t *addr)
+{
+  return NULL;
+}
+/*****************************************************************************/
+static uint64_t
+now_ns(void)
+{
+  struct timeval tv;
+
+  gettimeofday(&tv, NULL);
+  return (uint64_t)tv.tv_sec * 1000000000 + (uint64_t)tv.tv_usec * 1000;
+}
+/*****************************************************************************/
+/*
+ * Builds a schedule shaped like the Orchestra sender-based one: an EB
+ * slotframe, a shared slotframe and a unicast slotframe with one Rx
+ * link and one Tx link per neighbor. Timeslots of the unicast slotframe
+ * are spread with a stride so that links are not added in order.
+ */
+static int
+build_schedule(unsigned neighbors)
+{
+  struct tsch_slotframe *sf;
+  linkaddr_t addr;
+  uint16_t period = 2 * neighbors + 3;
+  unsigned i;
+
+  if(!tsch_schedule_remove_all_slotframes()) {
+    return 0;
+  }
+
+  sf = tsch_schedule_add_slotframe(0, TEST_EB_PERIOD);
+  if(sf == NULL ||
+     tsch_schedule_add_link(sf, LINK_OPTION_TX, LINK_TYPE_ADVERTISING_ONLY,
+                            &tsch_broadcast_address, 0, 0, 0) == NULL) {
+    return 0;
+  }
+
+  sf = tsch_schedule_add_slotframe(1, TEST_COMMON_PERIOD);
+  if(sf == NULL ||
+     tsch_schedule_add_link(sf, LINK_OPTION_RX | LINK_OPTION_TX |
+                            LINK_OPTION_SHARED, LINK_TYPE_ADVERTISING,
+                            &tsch_broadcast_address, 0, 1, 0) == NULL) {
+    return 0;
+  }
+
+  sf = tsch_schedule_add_slotframe(2, period);
+  if(sf == NULL ||
+     tsch_schedule_add_link(sf, LINK_OPTION_RX, LINK_TYPE_NORMAL,
+                            &tsch_broadcast_address, 1, 2, 0) == NULL) {
+    return 0;
+  }
+  for(i = 0; i < neighbors; i++) {
+    memset(&addr, 0, sizeof(addr));
+    addr.u8[0] = 0x02;
+    addr.u8[LINKADDR_SIZE - 1] = i + 1;
+    if(tsch_schedule_add_link(sf, LINK_OPTION_TX | LINK_OPTION_SHARED,
+                              LINK_TYPE_NORMAL, &addr,
+                              (7 * i) % period, 2, 0) == NULL) {
+      return 0;
+    }
+  }
+  return 1;
+}
+/*****************************************************************************/
+/* Time to the next occurrence of a link after a given ASN, in timeslots. */
+static uint16_t
+time_to_link(struct tsch_slotframe *sf, struct tsch_link *l,
+             struct tsch_asn_t *asn)
+{
+  uint16_t timeslot = TSCH_ASN_MOD(*asn, sf->size);
+
+  return l->timeslot > timeslot ?
+         l->timeslot - timeslot : sf->size.val + l->timeslot - timeslot;
+}
+/*****************************************************************************/
+/* Checks a lookup result against a walk over the whole schedule. */
+static int
+check_next_link(struct tsch_asn_t *asn)
+{
+  struct tsch_slotframe *sf;
+  struct tsch_link *l, *best, *backup;
+  uint16_t offset, time_to;
+  uint16_t expected = 0xffff;
+  int tx_expected = 0;
+
+  for(sf = tsch_schedule_slotframe_head(); sf != NULL;
+      sf = tsch_schedule_slotframe_next(sf)) {
+    for(l = list_head(sf->links_list); l != NULL; l = list_item_next(l)) {
+      time_to = time_to_link(sf, l, asn);
+      if(time_to < expected) {
+        expected = time_to;
+        tx_expected = 0;
+      }
+      if(time_to == expected && (l->link_options & LINK_OPTION_TX)) {
+        tx_expected = 1;
+      }
+    }
+  }
+
+  best = tsch_schedule_get_next_active_link(asn, &offset, &backup);
+  if(best == NULL || offset != expected) {
+    return 0;
+  }
+  sf = tsch_schedule_get_slotframe_by_handle(best->slotframe_handle);
+  if(sf == NULL || time_to_link(sf, best, asn) != offset) {
+    return 0;
+  }
+  if(tx_expected != !!(best->link_options & LINK_OPTION_TX)) {
+    return 0;
+  }
+  if(backup != NULL) {
+    sf = tsch_schedule_get_slotframe_by_handle(backup->slotframe_handle);
+    if(!(backup->link_options & LINK_OPTION_RX) ||
+       sf == NULL || time_to_link(sf, backup, asn) != offset) {
+      return 0;
+    }
+  }
+  return 1;
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(next_link, "Next active link lookups");
+UNIT_TEST(next_link)
+{
+  UNIT_TEST_BEGIN();
+
+  struct tsch_asn_t asn;
+  struct tsch_slotframe *sf;
+  struct tsch_link *l, *backup;
+  struct tsch_link *added[8];
+  uint16_t offset;
+  unsigned i;
+
+  /* An empty schedule has no active link. */
+  UNIT_TEST_ASSERT(tsch_schedule_remove_all_slotframes());
+  TSCH_ASN_INIT(asn, 0, 0);
+  UNIT_TEST_ASSERT(tsch_schedule_get_next_active_link(&asn, &offset,
+                                                      NULL) == NULL);
+
+  UNIT_TEST_ASSERT(build_schedule(16));
+  for(i = 0; i < 4 * TEST_EB_PERIOD; i++) {
+    TSCH_ASN_INIT(asn, 0, i);
+    UNIT_TEST_ASSERT(check_next_link(&asn));
+  }
+
+  /* The EB and shared Tx links overlap at ASN 0: the lowest slotframe
+     handle wins and the shared link, which has Rx, is kept as backup. */
+  TSCH_ASN_INIT(asn, 0, TEST_EB_PERIOD * TEST_COMMON_PERIOD - 1);
+  l = tsch_schedule_get_next_active_link(&asn, &offset, &backup);
+  UNIT_TEST_ASSERT(l != NULL && offset == 1 && l->slotframe_handle == 0);
+  UNIT_TEST_ASSERT(backup != NULL && backup->slotframe_handle == 1);
+
+  /* Links added to and removed from the first slotframe move the links
+     of the other slotframes in the cache. */
+  sf = tsch_schedule_get_slotframe_by_handle(0);
+  for(i = 0; i < 8; i++) {
+    added[i] = tsch_schedule_add_link(sf, LINK_OPTION_RX, LINK_TYPE_NORMAL,
+                                      &tsch_broadcast_address,
+                                      (101 * (i + 1)) % TEST_EB_PERIOD, 3, 0);
+    UNIT_TEST_ASSERT(added[i] != NULL);
+  }
+  for(i = 0; i < 4 * TEST_EB_PERIOD; i += 3) {
+    TSCH_ASN_INIT(asn, 0, i);
+    UNIT_TEST_ASSERT(check_next_link(&asn));
+  }
+  for(i = 0; i < 8; i += 2) {
+    UNIT_TEST_ASSERT(tsch_schedule_remove_link(sf, added[i]));
+  }
+  UNIT_TEST_ASSERT(tsch_schedule_remove_link(sf, list_head(sf->links_list)));
+  for(i = 0; i < 4 * TEST_EB_PERIOD; i += 3) {
+    TSCH_ASN_INIT(asn, 0, i);
+    UNIT_TEST_ASSERT(check_next_link(&asn));
+  }
+
+  /* Remove the unicast links one by one, checking the schedule as it
+     shrinks. */
+  while((l = list_head(tsch_schedule_get_slotframe_by_handle(2)->links_list))
+        != NULL) {
+    UNIT_TEST_ASSERT(tsch_schedule_remove_link(
+                       tsch_schedule_get_slotframe_by_handle(2), l));
+    for(i = 0; i < 2 * TEST_COMMON_PERIOD; i++) {
+      TSCH_ASN_INIT(asn, 0, i * 5);
+      UNIT_TEST_ASSERT(check_next_link(&asn));
+    }
+  }
+
+  UNIT_TEST_ASSERT(tsch_schedule_remove_all_slotframes());
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(lookup_benchmark, "Next active link lookups versus links");
+UNIT_TEST(lookup_benchmark)
+{
+  UNIT_TEST_BEGIN();
+
+  static const unsigned sizes[] = { 8, 64, 200 };
+  struct tsch_asn_t asn;
+  struct tsch_link *backup;
+  uint16_t offset;
+  uint64_t start, elapsed;
+  unsigned i, k;
+
+  printf("Link cache %s\n",
+         TSCH_SCHEDULE_WITH_LINK_CACHE ? "enabled" : "disabled");
+
+  for(k = 0; k < sizeof(sizes) / sizeof(sizes[0]); k++) {
+    if(sizes[k] + 3 > TSCH_SCHEDULE_MAX_LINKS) {
+      continue;
+    }
+    UNIT_TEST_ASSERT(build_schedule(sizes[k]));
+
+    /* Step through the schedule as the slot operation does, from one
+       active link to the next. */
+    TSCH_ASN_INIT(asn, 0, 0);
+    start = now_ns();
+    for(i = 0; i < TEST_LOOKUPS; i++) {
+      UNIT_TEST_ASSERT(tsch_schedule_get_next_active_link(&asn, &offset,
+                                                          &backup) != NULL);
+      TSCH_ASN_INC(asn, offset);
+    }
+    elapsed = now_ns() - start;
+
+    printf("%4u links: %6lu ns/lookup\n", sizes[k] + 3,
+           (unsigned long)(elapsed / TEST_LOOKUPS));
+  }
+
+  UNIT_TEST_ASSERT(tsch_schedule_remove_all_slotframes());
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_tsch_schedule_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  tsch_schedule_init();
+
+  UNIT_TEST_RUN(next_link);
+  UNIT_TEST_RUN(lookup_benchmark);
+
+  if(!UNIT_TEST_PASSED(next_link) ||
+     !UNIT_TEST_PASSED(lookup_benchmark)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
@@ -0,0 +1,314 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Unit tests and request rate benchmark for CoAP resource dispatch.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "contiki.h"
+#include "coap-engine.h"
+#include "unit-test/unit-test.h"
+/*****************************************************************************/
+/* Number of generated resources, shaped like LwM2M/IPSO object paths. */
+#ifdef TEST_CONF_RESOURCES
+#define TEST_RESOURCES TEST_CONF_RESOURCES
+#else
+#define TEST_RESOURCES 512
+#endif
+
+/* Number of requests to each resource in the benchmark. */
+#ifdef TEST_CONF_REQUESTS
+#define TEST_REQUESTS TEST_CONF_REQUESTS
+#else
+#define TEST_REQUESTS 20
+#endif
+
+/* Number of resources activated after the others, which do not fit in a
+   resource trie of the configured size. */
+#define TEST_EXTRA_RESOURCES 300
+
+#define TEST_URL_LEN     24
+#define TEST_REQUEST_LEN 32
+/*****************************************************************************/
+PROCESS(test_coap_dispatch_process, "CoAP dispatch test process");
+AUTOSTART_PROCESSES(&test_coap_dispatch_process);
+
+static coap_resource_t resources[TEST_RESOURCES];
+static char urls[TEST_RESOURCES][TEST_URL_LEN];
+static unsigned active_resources;
+static unsigned handled;
+
+static const char *requests[] = {
+  "", "sensors", "sensors/", "sensors/temp", "sensors/temp/",
+  "sensors/temp/1", "sensors/light", "sensorsx", "sensor", "dup",
+  "dup/x", "a//b", "a/b", "/", "//", "/sensors", "3300/0/5700",
+  "3300/0/5700/1", "3300/0", "3300/0/57", "3363/0/5707", "3364/0/5700",
+  "9999"
+};
+/*****************************************************************************/
+static uint64_t
+now_ns(void)
+{
+  struct timeval tv;
+
+  gettimeofday(&tv, NULL);
+  return (uint64_t)tv.tv_sec * 1000000000 + (uint64_t)tv.tv_usec * 1000;
+}
+/*****************************************************************************/
+static void
+res_get_handler(coap_message_t *request, coap_message_t *response,
+                uint8_t *buffer, uint16_t preferred_size, int32_t *offset)
+{
+  handled++;
+}
+/*****************************************************************************/
+static void
+activate(coap_resource_t *resource, coap_resource_flags_t flags,
+         const char *url)
+{
+  resource->flags = METHOD_GET | flags;
+  resource->get_handler = res_get_handler;
+  coap_activate_resource(resource, url);
+}
+/*****************************************************************************/
+/* Activates the generated resources up to a given count. */
+static void
+activate_resources(unsigned count)
+{
+  for(; active_resources < count; active_resources++) {
+    snprintf(urls[active_resources], TEST_URL_LEN, "%u/0/%u",
+             3300 + active_resources / 8, 5700 + active_resources % 8);
+    activate(&resources[active_resources], 0, urls[active_resources]);
+  }
+}
+/*****************************************************************************/
+/* The resource that a walk over all active resources selects. */
+static coap_resource_t *
+reference_lookup(const char *url)
+{
+  coap_resource_t *r;
+  int url_len = strlen(url);
+  int len;
+
+  for(r = coap_get_first_resource(); r != NULL; r = coap_get_next_resource(r)) {
+    len = strlen(r->url);
+    if((url_len == len
+        || (url_len > len && (r->flags & HAS_SUB_RESOURCES) && url[len] == '/'))
+       && strncmp(r->url, url, len) == 0) {
+      return r;
+    }
+  }
+  return NULL;
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(lookup, "Resource lookups by URL");
+UNIT_TEST(lookup)
+{
+  UNIT_TEST_BEGIN();
+
+  static coap_resource_t sensors, sensors_sub, temp, temp_sub, dup, slash;
+  static coap_resource_t root_sub;
+  char url[TEST_URL_LEN + 2];
+  unsigned i;
+
+  activate(&sensors, 0, "sensors");
+  activate(&temp, 0, "sensors/temp");
+  activate(&sensors_sub, HAS_SUB_RESOURCES, "sensors");
+  activate(&temp_sub, HAS_SUB_RESOURCES, "sensors/temp");
+  activate(&dup, 0, "dup");
+  activate(&slash, HAS_SUB_RESOURCES, "a//b");
+  activate_resources(TEST_RESOURCES);
+
+  for(i = 0; i < sizeof(requests) / sizeof(requests[0]); i++) {
+    UNIT_TEST_ASSERT(coap_get_resource_by_url(requests[i],
+                                              strlen(requests[i])) ==
+                     reference_lookup(requests[i]));
+  }
+  for(i = 0; i < TEST_RESOURCES; i++) {
+    UNIT_TEST_ASSERT(coap_get_resource_by_url(urls[i], strlen(urls[i])) ==
+                     &resources[i]);
+  }
+
+  /* The prefix of a request path must not be matched. */
+  UNIT_TEST_ASSERT(coap_get_resource_by_url("sensors/temp", 7) == &sensors);
+
+  /* A resource activated again moves to the end with its new URL. */
+  activate(&sensors, HAS_SUB_RESOURCES, "dup");
+  for(i = 0; i < sizeof(requests) / sizeof(requests[0]); i++) {
+    UNIT_TEST_ASSERT(coap_get_resource_by_url(requests[i],
+                                              strlen(requests[i])) ==
+                     reference_lookup(requests[i]));
+  }
+  UNIT_TEST_ASSERT(coap_get_resource_by_url("sensors", 7) == &sensors_sub);
+  UNIT_TEST_ASSERT(coap_get_resource_by_url("dup", 3) == &dup);
+  UNIT_TEST_ASSERT(coap_get_resource_by_url("dup/x", 5) == &sensors);
+  for(i = 0; i < TEST_RESOURCES; i++) {
+    snprintf(url, sizeof(url), "%s/x", urls[i]);
+    UNIT_TEST_ASSERT(coap_get_resource_by_url(url, strlen(url)) == NULL);
+  }
+
+  /* The empty URL with sub-resources is only a prefix of paths that start
+     with a slash. */
+  activate(&root_sub, HAS_SUB_RESOURCES, "");
+  for(i = 0; i < sizeof(requests) / sizeof(requests[0]); i++) {
+    UNIT_TEST_ASSERT(coap_get_resource_by_url(requests[i],
+                                              strlen(requests[i])) ==
+                     reference_lookup(requests[i]));
+  }
+  UNIT_TEST_ASSERT(coap_get_resource_by_url("9999", 4) == NULL);
+  UNIT_TEST_ASSERT(coap_get_resource_by_url("/9999", 5) == &root_sub);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(trie_full, "Resource lookups beyond the trie size");
+UNIT_TEST(trie_full)
+{
+  UNIT_TEST_BEGIN();
+
+  static coap_resource_t extra[TEST_EXTRA_RESOURCES];
+  static char extra_urls[TEST_EXTRA_RESOURCES][TEST_URL_LEN];
+  unsigned i;
+
+  /* Each resource needs two trie nodes of its own. */
+  for(i = 0; i < TEST_EXTRA_RESOURCES; i++) {
+    snprintf(extra_urls[i], TEST_URL_LEN, "x%u/%u", i, i);
+    activate(&extra[i], 0, extra_urls[i]);
+  }
+
+  for(i = 0; i < TEST_EXTRA_RESOURCES; i++) {
+    UNIT_TEST_ASSERT(coap_get_resource_by_url(extra_urls[i],
+                                              strlen(extra_urls[i])) ==
+                     &extra[i]);
+  }
+  for(i = 0; i < TEST_RESOURCES; i++) {
+    UNIT_TEST_ASSERT(coap_get_resource_by_url(urls[i], strlen(urls[i])) ==
+                     &resources[i]);
+  }
+  for(i = 0; i < sizeof(requests) / sizeof(requests[0]); i++) {
+    UNIT_TEST_ASSERT(coap_get_resource_by_url(requests[i],
+                                              strlen(requests[i])) ==
+                     reference_lookup(requests[i]));
+  }
+
+  /* Activating a resource again rebuilds the trie, which still does not
+     have room for all resources. */
+  activate(&extra[0], 0, extra_urls[0]);
+  for(i = 0; i < TEST_EXTRA_RESOURCES; i++) {
+    UNIT_TEST_ASSERT(coap_get_resource_by_url(extra_urls[i],
+                                              strlen(extra_urls[i])) ==
+                     &extra[i]);
+  }
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(request_benchmark, "Request rate versus resources");
+UNIT_TEST(request_benchmark)
+{
+  UNIT_TEST_BEGIN();
+
+  static const unsigned sizes[] = { 16, 128, 512 };
+  static uint8_t requests[TEST_RESOURCES][TEST_REQUEST_LEN];
+  static uint16_t request_lens[TEST_RESOURCES];
+  uint8_t payload[TEST_REQUEST_LEN];
+  coap_message_t request[1];
+  coap_endpoint_t src;
+  uint64_t start, elapsed;
+  unsigned i, j, k;
+
+  printf("Resource trie %s\n", COAP_RESOURCE_TRIE_NODES ? "enabled" : "disabled");
+
+  memset(&src, 0, sizeof(src));
+  uip_ip6addr(&src.ipaddr, 0xfd00, 0, 0, 0, 0, 0, 0, 2);
+  src.port = UIP_HTONS(COAP_DEFAULT_PORT);
+
+  for(k = 0; k < sizeof(sizes) / sizeof(sizes[0]); k++) {
+    if(sizes[k] > TEST_RESOURCES) {
+      continue;
+    }
+    activate_resources(sizes[k]);
+
+    for(i = 0; i < sizes[k]; i++) {
+      coap_init_message(request, COAP_TYPE_NON, COAP_GET, coap_get_mid());
+      coap_set_header_uri_path(request, urls[i]);
+      request_lens[i] = coap_serialize_message(request, requests[i]);
+      UNIT_TEST_ASSERT(request_lens[i] > 0);
+    }
+
+    /* Send one GET request to each resource in turn. Parsing rewrites the
+       options in place, so each request is received from a copy. */
+    handled = 0;
+    start = now_ns();
+    for(j = 0; j < TEST_REQUESTS; j++) {
+      for(i = 0; i < sizes[k]; i++) {
+        memcpy(payload, requests[i], request_lens[i]);
+        coap_receive(&src, payload, request_lens[i]);
+      }
+    }
+    elapsed = now_ns() - start;
+    UNIT_TEST_ASSERT(handled == TEST_REQUESTS * sizes[k]);
+
+    printf("%4u resources: %6lu ns/request\n", sizes[k],
+           (unsigned long)(elapsed / (TEST_REQUESTS * sizes[k])));
+  }
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_coap_dispatch_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  coap_engine_init();
+
+  UNIT_TEST_RUN(request_benchmark);
+  UNIT_TEST_RUN(lookup);
+  UNIT_TEST_RUN(trie_full);
+
+  if(!UNIT_TEST_PASSED(request_benchmark) ||
+     !UNIT_TEST_PASSED(lookup) ||
+     !UNIT_TEST_PASSED(trie_full)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
@@ -0,0 +1,284 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Unit tests and copy count benchmark for queuebuf.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "net/packetbuf.h"
+#include "net/queuebuf.h"
+#include "unit-test/unit-test.h"
+/*****************************************************************************/
+/* Number of packets forwarded in each flow of the benchmark. */
+#ifdef TEST_CONF_PACKETS
+#define TEST_PACKETS TEST_CONF_PACKETS
+#else
+#define TEST_PACKETS 1000
+#endif
+
+/* Length of the forwarded packets. */
+#define TEST_LEN 100
+/*****************************************************************************/
+PROCESS(test_queuebuf_process, "Queuebuf test process");
+AUTOSTART_PROCESSES(&test_queuebuf_process);
+/*****************************************************************************/
+static void
+make_packet(uint8_t *buf, unsigned id, int len)
+{
+  int i;
+
+  for(i = 0; i < len; i++) {
+    buf[i] = (uint8_t)(id * 7 + i);
+  }
+}
+/*****************************************************************************/
+static void
+load_packet(unsigned id, int len)
+{
+  uint8_t buf[PACKETBUF_SIZE];
+  linkaddr_t addr;
+
+  make_packet(buf, id, len);
+  packetbuf_copyfrom(buf, len);
+  packetbuf_set_attr(PACKETBUF_ATTR_MAC_SEQNO, id & 0xff);
+  memset(&addr, 0, sizeof(addr));
+  addr.u8[0] = id & 0xff;
+  packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, &addr);
+}
+/*****************************************************************************/
+static int
+packetbuf_holds(unsigned id, int len)
+{
+  uint8_t buf[PACKETBUF_SIZE];
+
+  make_packet(buf, id, len);
+  return packetbuf_totlen() == len &&
+    memcmp(packetbuf_hdrptr(), buf, len) == 0 &&
+    packetbuf_attr(PACKETBUF_ATTR_MAC_SEQNO) == (id & 0xff) &&
+    packetbuf_addr(PACKETBUF_ADDR_RECEIVER)->u8[0] == (id & 0xff);
+}
+/*****************************************************************************/
+static int
+queuebuf_holds(struct queuebuf *q, unsigned id, int len)
+{
+  uint8_t buf[PACKETBUF_SIZE];
+
+  make_packet(buf, id, len);
+  return queuebuf_datalen(q) == len &&
+    memcmp(queuebuf_dataptr(q), buf, len) == 0 &&
+    queuebuf_attr(q, PACKETBUF_ATTR_MAC_SEQNO) == (id & 0xff) &&
+    queuebuf_addr(q, PACKETBUF_ADDR_RECEIVER)->u8[0] == (id & 0xff);
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(queuebuf_move, "Moving packets to and from queuebufs");
+UNIT_TEST(queuebuf_move)
+{
+  UNIT_TEST_BEGIN();
+
+  static struct queuebuf *q[QUEUEBUF_NUM];
+  uint8_t expected[PACKETBUF_SIZE];
+  int expected_len;
+  unsigned i, j;
+
+  queuebuf_init();
+
+  /* A moved packet keeps its contents and attributes. */
+  load_packet(1, TEST_LEN);
+  q[0] = queuebuf_move_from_packetbuf();
+  UNIT_TEST_ASSERT(q[0] != NULL);
+  UNIT_TEST_ASSERT(queuebuf_holds(q[0], 1, TEST_LEN));
+  UNIT_TEST_ASSERT(packetbuf_addr(PACKETBUF_ADDR_RECEIVER)->u8[0] == 1);
+
+  /* The packetbuf is usable for other packets meanwhile. */
+  load_packet(2, TEST_LEN / 2);
+  q[1] = queuebuf_new_from_packetbuf();
+  UNIT_TEST_ASSERT(q[1] != NULL);
+  UNIT_TEST_ASSERT(queuebuf_holds(q[1], 2, TEST_LEN / 2));
+  UNIT_TEST_ASSERT(packetbuf_holds(2, TEST_LEN / 2));
+
+  queuebuf_to_packetbuf(q[0]);
+  UNIT_TEST_ASSERT(packetbuf_holds(1, TEST_LEN));
+  UNIT_TEST_ASSERT(queuebuf_holds(q[0], 1, TEST_LEN));
+
+  /* Freeing a queuebuf after moving it leaves the packetbuf intact. */
+  queuebuf_move_to_packetbuf(q[1]);
+  queuebuf_free(q[1]);
+  UNIT_TEST_ASSERT(packetbuf_holds(2, TEST_LEN / 2));
+  queuebuf_free(q[0]);
+  UNIT_TEST_ASSERT(packetbuf_holds(2, TEST_LEN / 2));
+
+  /* Header and data are stored contiguously, as by packetbuf_copyto(). */
+  load_packet(3, TEST_LEN);
+  packetbuf_hdrreduce(5);
+  UNIT_TEST_ASSERT(packetbuf_hdralloc(3));
+  memset(packetbuf_hdrptr(), 0xaa, 3);
+  expected_len = packetbuf_copyto(expected);
+  q[0] = queuebuf_move_from_packetbuf();
+  UNIT_TEST_ASSERT(q[0] != NULL);
+  UNIT_TEST_ASSERT(queuebuf_datalen(q[0]) == expected_len);
+  UNIT_TEST_ASSERT(memcmp(queuebuf_dataptr(q[0]), expected,
+                          expected_len) == 0);
+  queuebuf_free(q[0]);
+
+  /* A move that fails for lack of queuebufs leaves the packetbuf alone. */
+  for(i = 0; i < QUEUEBUF_NUM; i++) {
+    load_packet(10 + i, TEST_LEN);
+    q[i] = queuebuf_move_from_packetbuf();
+    UNIT_TEST_ASSERT(q[i] != NULL);
+  }
+  load_packet(99, TEST_LEN);
+  UNIT_TEST_ASSERT(queuebuf_move_from_packetbuf() == NULL);
+  UNIT_TEST_ASSERT(packetbuf_holds(99, TEST_LEN));
+  for(i = 0; i < QUEUEBUF_NUM; i++) {
+    UNIT_TEST_ASSERT(queuebuf_holds(q[i], 10 + i, TEST_LEN));
+    queuebuf_free(q[i]);
+  }
+  UNIT_TEST_ASSERT(queuebuf_numfree() == QUEUEBUF_NUM);
+
+  /* Storage keeps circulating between the packetbuf and queuebufs. */
+  for(j = 0; j < 1000; j++) {
+    unsigned n = 1 + j % QUEUEBUF_NUM;
+    for(i = 0; i < n; i++) {
+      load_packet(j + i, TEST_LEN - i);
+      q[i] = (i & 1) ? queuebuf_new_from_packetbuf() :
+        queuebuf_move_from_packetbuf();
+      UNIT_TEST_ASSERT(q[i] != NULL);
+    }
+    for(i = 0; i < n; i++) {
+      queuebuf_move_to_packetbuf(q[i]);
+      queuebuf_free(q[i]);
+      UNIT_TEST_ASSERT(packetbuf_holds(j + i, TEST_LEN - i));
+    }
+  }
+  UNIT_TEST_ASSERT(queuebuf_numfree() == QUEUEBUF_NUM);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(forward_copies, "Bytes copied per forwarded packet");
+UNIT_TEST(forward_copies)
+{
+  UNIT_TEST_BEGIN();
+
+  struct queuebuf *q, *backup;
+  uint32_t copied[3];
+  unsigned i;
+
+  printf("Queuebuf zero copy %s\n",
+         QUEUEBUF_ZERO_COPY ? "enabled" : "disabled");
+
+  queuebuf_init();
+
+  /* CSMA: the packet is queued, then loaded into the packetbuf for
+     framing at each of its transmissions (one here). */
+  queuebuf_copied_bytes = 0;
+  for(i = 0; i < TEST_PACKETS; i++) {
+    load_packet(i, TEST_LEN);
+    q = queuebuf_move_from_packetbuf();
+    UNIT_TEST_ASSERT(q != NULL);
+    queuebuf_to_packetbuf(q);
+    queuebuf_free(q);
+  }
+  copied[0] = queuebuf_copied_bytes;
+  UNIT_TEST_ASSERT(packetbuf_holds(i - 1, TEST_LEN));
+
+  /* TSCH: the packet is queued, transmitted straight from its queuebuf
+     and loaded into the packetbuf for the sent callback. */
+  queuebuf_copied_bytes = 0;
+  for(i = 0; i < TEST_PACKETS; i++) {
+    load_packet(i, TEST_LEN);
+    q = queuebuf_move_from_packetbuf();
+    UNIT_TEST_ASSERT(q != NULL);
+    UNIT_TEST_ASSERT(((uint8_t *)queuebuf_dataptr(q))[1] ==
+                     (uint8_t)(i * 7 + 1));
+    queuebuf_move_to_packetbuf(q);
+    queuebuf_free(q);
+  }
+  copied[1] = queuebuf_copied_bytes;
+  UNIT_TEST_ASSERT(packetbuf_holds(i - 1, TEST_LEN));
+
+  /* 6LoWPAN fragments: the packetbuf is backed up around the MAC send
+     and restored afterwards. The MAC here queues like TSCH. */
+  queuebuf_copied_bytes = 0;
+  for(i = 0; i < TEST_PACKETS; i++) {
+    load_packet(i, TEST_LEN);
+    backup = queuebuf_new_from_packetbuf();
+    UNIT_TEST_ASSERT(backup != NULL);
+    q = queuebuf_move_from_packetbuf();
+    UNIT_TEST_ASSERT(q != NULL);
+    queuebuf_move_to_packetbuf(backup);
+    queuebuf_free(backup);
+    queuebuf_free(q);
+  }
+  copied[2] = queuebuf_copied_bytes;
+  UNIT_TEST_ASSERT(packetbuf_holds(i - 1, TEST_LEN));
+
+  printf("CSMA:      %4lu bytes/packet\n",
+         (unsigned long)(copied[0] / TEST_PACKETS));
+  printf("TSCH:      %4lu bytes/packet\n",
+         (unsigned long)(copied[1] / TEST_PACKETS));
+  printf("Fragments: %4lu bytes/packet\n",
+         (unsigned long)(copied[2] / TEST_PACKETS));
+
+  if(QUEUEBUF_ZERO_COPY) {
+    UNIT_TEST_ASSERT(copied[0] == TEST_PACKETS * TEST_LEN);
+    UNIT_TEST_ASSERT(copied[1] == 0);
+    UNIT_TEST_ASSERT(copied[2] == TEST_PACKETS * TEST_LEN);
+  }
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_queuebuf_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(queuebuf_move);
+  UNIT_TEST_RUN(forward_copies);
+
+  if(!UNIT_TEST_PASSED(queuebuf_move) ||
+     !UNIT_TEST_PASSED(forward_copies)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*****************************************************************************/
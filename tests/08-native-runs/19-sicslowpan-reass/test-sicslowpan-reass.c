@@ -0,0 +1,305 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Unit tests and benchmark for 6LoWPAN fragment reassembly.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "contiki.h"
+#include "net/ipv6/sicslowpan.h"
+#include "net/ipv6/uip.h"
+#include "net/netstack.h"
+#include "net/packetbuf.h"
+#include "unit-test/unit-test.h"
+/*****************************************************************************/
+/* Number of rounds of the interleaved reassembly benchmark. */
+#ifdef TEST_CONF_ROUNDS
+#define TEST_ROUNDS TEST_CONF_ROUNDS
+#else
+#define TEST_ROUNDS 1000
+#endif
+
+/* Length of the fragmented IPv6 packets and of their fragments. */
+#define TEST_LEN 400
+#define TEST_FRAG_LEN 96
+#define TEST_FRAGS ((TEST_LEN + TEST_FRAG_LEN - 1) / TEST_FRAG_LEN)
+
+/* Number of senders interleaving their packets. */
+#define TEST_SENDERS 8
+/*****************************************************************************/
+PROCESS(test_sicslowpan_reass_process, "6LoWPAN reassembly test process");
+AUTOSTART_PROCESSES(&test_sicslowpan_reass_process);
+
+static uint8_t packets[TEST_SENDERS][TEST_LEN];
+static unsigned delivered[TEST_SENDERS];
+static unsigned delivered_bad;
+/*****************************************************************************/
+static uint64_t
+now_ns(void)
+{
+  struct timeval tv;
+
+  gettimeofday(&tv, NULL);
+  return (uint64_t)tv.tv_sec * 1000000000 + (uint64_t)tv.tv_usec * 1000;
+}
+/*****************************************************************************/
+static void
+make_packet(uint8_t *buf, unsigned sender)
+{
+  unsigned i;
+
+  memset(buf, 0, UIP_IPH_LEN);
+  buf[0] = 0x60;
+  buf[4] = (TEST_LEN - UIP_IPH_LEN) >> 8;
+  buf[5] = (TEST_LEN - UIP_IPH_LEN) & 0xff;
+  buf[6] = UIP_PROTO_NONE;
+  buf[7] = 64;
+  /* Source fd00::<sender>, destination ff02::1:2 (not joined) */
+  buf[8] = 0xfd;
+  buf[23] = sender + 1;
+  buf[24] = 0xff;
+  buf[25] = 0x02;
+  buf[37] = 0x01;
+  buf[39] = 0x02;
+  for(i = UIP_IPH_LEN; i < TEST_LEN; i++) {
+    buf[i] = (uint8_t)(sender * 31 + i);
+  }
+}
+/*****************************************************************************/
+static void
+sniffer_input(void)
+{
+  unsigned i;
+
+  for(i = 0; i < TEST_SENDERS; i++) {
+    if(uip_len == TEST_LEN && memcmp(uip_buf, packets[i], TEST_LEN) == 0) {
+      delivered[i]++;
+      return;
+    }
+  }
+  delivered_bad++;
+}
+NETSTACK_SNIFFER(sniffer, sniffer_input, NULL);
+/*****************************************************************************/
+/* Pass fragment number frag of a sender's packet to 6LoWPAN. */
+static void
+input_fragment(unsigned sender, uint16_t tag, unsigned frag)
+{
+  uint8_t frame[PACKETBUF_SIZE];
+  linkaddr_t addr;
+  unsigned start, len, hdr_len;
+
+  start = frag * TEST_FRAG_LEN;
+  len = TEST_LEN - start < TEST_FRAG_LEN ? TEST_LEN - start : TEST_FRAG_LEN;
+  frame[0] = (frag == 0 ? SICSLOWPAN_DISPATCH_FRAG1 : SICSLOWPAN_DISPATCH_FRAGN) |
+    (TEST_LEN >> 8);
+  frame[1] = TEST_LEN & 0xff;
+  frame[2] = tag >> 8;
+  frame[3] = tag & 0xff;
+  if(frag == 0) {
+    frame[4] = SICSLOWPAN_DISPATCH_IPV6;
+    hdr_len = SICSLOWPAN_FRAG1_HDR_LEN + 1;
+  } else {
+    frame[4] = start >> 3;
+    hdr_len = SICSLOWPAN_FRAGN_HDR_LEN;
+  }
+  memcpy(frame + hdr_len, packets[sender] + start, len);
+
+  packetbuf_copyfrom(frame, hdr_len + len);
+  memset(&addr, 0, sizeof(addr));
+  addr.u8[0] = sender + 1;
+  packetbuf_set_addr(PACKETBUF_ADDR_SENDER, &addr);
+  sicslowpan_driver.input();
+}
+/*****************************************************************************/
+static void
+reset_counts(void)
+{
+  memset(delivered, 0, sizeof(delivered));
+  delivered_bad = 0;
+  memset(&sicslowpan_reass_stats, 0, sizeof(sicslowpan_reass_stats));
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(reass_order, "Reassembly of reordered fragments");
+UNIT_TEST(reass_order)
+{
+  UNIT_TEST_BEGIN();
+
+  static const uint8_t orders[][TEST_FRAGS + 2] = {
+    { 0, 1, 2, 3, 4 },
+    { 4, 3, 2, 1, 0 },
+    { 1, 3, 1, 0, 2, 4 },
+    { 2, 0, 4, 4, 0, 1, 3 },
+  };
+  static const uint8_t lengths[] = { 5, 5, 6, 7 };
+  unsigned i, j;
+
+  reset_counts();
+  for(i = 0; i < sizeof(lengths); i++) {
+    for(j = 0; j < lengths[i]; j++) {
+      input_fragment(0, 100 + i, orders[i][j]);
+    }
+    UNIT_TEST_ASSERT(delivered[0] == i + 1);
+  }
+  UNIT_TEST_ASSERT(delivered_bad == 0);
+  UNIT_TEST_ASSERT(sicslowpan_reass_stats.completed == sizeof(lengths));
+  UNIT_TEST_ASSERT(sicslowpan_reass_stats.drops == 0);
+
+  /* A fragment beyond the packet is dropped. */
+  input_fragment(0, 200, 0);
+  input_fragment(0, 200, 1);
+  packetbuf_copyfrom((uint8_t []){ SICSLOWPAN_DISPATCH_FRAGN | (TEST_LEN >> 8),
+                                   TEST_LEN & 0xff, 0, 200, TEST_LEN >> 3,
+                                   0, 0, 0, 0, 0, 0, 0, 0 }, 13);
+  sicslowpan_driver.input();
+  UNIT_TEST_ASSERT(sicslowpan_reass_stats.drops == 1);
+  input_fragment(0, 200, 2);
+  input_fragment(0, 200, 3);
+  input_fragment(0, 200, 4);
+  UNIT_TEST_ASSERT(delivered[0] == sizeof(lengths) + 1);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(reass_evict, "Eviction of the least recently used packet");
+UNIT_TEST(reass_evict)
+{
+  UNIT_TEST_BEGIN();
+
+  unsigned i, frag;
+
+  reset_counts();
+
+  /* Start one packet more than there are contexts. The first packet
+     sees no further fragments and is evicted by the last one. */
+  input_fragment(0, 1, 0);
+  for(i = 1; i < TEST_SENDERS; i++) {
+    input_fragment(i, 1, 0);
+    input_fragment(i, 1, 1);
+  }
+  for(i = 1; i < TEST_SENDERS; i++) {
+    input_fragment(i, 1, 2);
+  }
+  UNIT_TEST_ASSERT(sicslowpan_reass_stats.evictions == 0);
+  input_fragment(1, 2, 0);
+  UNIT_TEST_ASSERT(sicslowpan_reass_stats.evictions == 1);
+  for(frag = 1; frag < TEST_FRAGS; frag++) {
+    input_fragment(1, 2, frag);
+  }
+  for(i = 1; i < TEST_SENDERS; i++) {
+    for(frag = 3; frag < TEST_FRAGS; frag++) {
+      input_fragment(i, 1, frag);
+    }
+  }
+  for(frag = 1; frag < TEST_FRAGS; frag++) {
+    input_fragment(0, 1, frag);
+  }
+  UNIT_TEST_ASSERT(delivered[0] == 0);
+  UNIT_TEST_ASSERT(delivered[1] == 2);
+  for(i = 2; i < TEST_SENDERS; i++) {
+    UNIT_TEST_ASSERT(delivered[i] == 1);
+  }
+  UNIT_TEST_ASSERT(delivered_bad == 0);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(reass_benchmark, "Interleaved reassembly from many senders");
+UNIT_TEST(reass_benchmark)
+{
+  UNIT_TEST_BEGIN();
+
+  uint64_t start, elapsed;
+  unsigned round, frag, i, total;
+
+  reset_counts();
+
+  /* All senders transmit one packet per round, with their fragments
+     interleaved, as seen by a border router. */
+  start = now_ns();
+  for(round = 0; round < TEST_ROUNDS; round++) {
+    for(frag = 0; frag < TEST_FRAGS; frag++) {
+      for(i = 0; i < TEST_SENDERS; i++) {
+        input_fragment(i, round, frag);
+      }
+    }
+  }
+  elapsed = now_ns() - start;
+
+  for(total = 0, i = 0; i < TEST_SENDERS; i++) {
+    total += delivered[i];
+  }
+  printf("%u senders: %u/%u packets reassembled, %lu ns/packet\n",
+         TEST_SENDERS, total, TEST_SENDERS * TEST_ROUNDS,
+         (unsigned long)(elapsed / (TEST_SENDERS * TEST_ROUNDS)));
+  printf("drops %u, timeouts %u, evictions %u\n",
+         sicslowpan_reass_stats.drops, sicslowpan_reass_stats.timeouts,
+         sicslowpan_reass_stats.evictions);
+  UNIT_TEST_ASSERT(delivered_bad == 0);
+  UNIT_TEST_ASSERT(total == TEST_SENDERS * TEST_ROUNDS);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_sicslowpan_reass_process, ev, data)
+{
+  unsigned i;
+
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  for(i = 0; i < TEST_SENDERS; i++) {
+    make_packet(packets[i], i);
+  }
+  netstack_sniffer_add(&sniffer);
+
+  UNIT_TEST_RUN(reass_order);
+  UNIT_TEST_RUN(reass_evict);
+  UNIT_TEST_RUN(reass_benchmark);
+
+  if(!UNIT_TEST_PASSED(reass_order) ||
+     !UNIT_TEST_PASSED(reass_evict) ||
+     !UNIT_TEST_PASSED(reass_benchmark)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*****************************************************************************/
@@ -0,0 +1,360 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Unit tests and throughput benchmark for the SLIP engine of the
+ *      native border router.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+
+#include "contiki.h"
+#include "net/mac/mac.h"
+#include "net/packetbuf.h"
+#include "unit-test/unit-test.h"
+/*****************************************************************************/
+/* Number of frames sent each way in the benchmark. */
+#ifdef TEST_CONF_FRAMES
+#define TEST_FRAMES TEST_CONF_FRAMES
+#else
+#define TEST_FRAMES 100000
+#endif
+
+/* Length of the benchmark frames, and how many are queued per flush. */
+#define TEST_LEN 100
+#define TEST_BATCH 16
+
+#define SLIP_END     0300
+#define SLIP_ESC     0333
+#define SLIP_ESC_END 0334
+#define SLIP_ESC_ESC 0335
+/*****************************************************************************/
+/* The parts of the border router that the SLIP engine depends on */
+int slip_config_verbose = 0;
+int slip_config_flowcontrol = 0;
+const char *slip_config_siodev = NULL;
+const char *slip_config_host = NULL;
+const char *slip_config_port = NULL;
+uint16_t slip_config_basedelay = 0;
+speed_t slip_config_b_rate = B115200;
+uint8_t command_context;
+
+extern int slipfd;
+extern long slip_frames_sent, slip_frames_received, slip_writes, slip_reads;
+extern long slip_sent, slip_received;
+
+void write_to_slip(const uint8_t *buf, int len);
+void slip_flushbuf(int fd);
+int slip_empty(void);
+void serial_input(int fd);
+
+int
+devopen(const char *dev, int flags)
+{
+  return -1;
+}
+
+int
+cmd_input(const uint8_t *data, int data_len)
+{
+  return 0;
+}
+/*****************************************************************************/
+/* Collects the frames decoded by the SLIP engine */
+static uint8_t received[TEST_BATCH][PACKETBUF_SIZE];
+static int received_len[TEST_BATCH];
+static unsigned received_count;
+
+static void
+test_mac_input(void)
+{
+  if(received_count < TEST_BATCH) {
+    received_len[received_count] = packetbuf_copyto(received[received_count]);
+  }
+  received_count++;
+}
+
+static void
+test_mac_init(void)
+{
+}
+
+static void
+test_mac_send(mac_callback_t sent, void *ptr)
+{
+  mac_call_sent_callback(sent, ptr, MAC_TX_ERR, 1);
+}
+
+static int
+test_mac_on(void)
+{
+  return 1;
+}
+
+static int
+test_mac_max_payload(void)
+{
+  return PACKETBUF_SIZE;
+}
+
+const struct mac_driver test_mac_driver = {
+  "test", test_mac_init, test_mac_send, test_mac_input,
+  test_mac_on, test_mac_on, test_mac_max_payload
+};
+/*****************************************************************************/
+PROCESS(test_slip_dev_process, "SLIP test process");
+AUTOSTART_PROCESSES(&test_slip_dev_process);
+
+/* The far end of the serial line */
+static int peerfd;
+/*****************************************************************************/
+static uint64_t
+now_ns(void)
+{
+  struct timeval tv;
+
+  gettimeofday(&tv, NULL);
+  return (uint64_t)tv.tv_sec * 1000000000 + (uint64_t)tv.tv_usec * 1000;
+}
+/*****************************************************************************/
+/* Frames with a fair share of bytes to escape */
+static void
+make_frame(uint8_t *buf, unsigned id, int len)
+{
+  static const uint8_t specials[] = { SLIP_END, SLIP_ESC, SLIP_ESC_END };
+  int i;
+
+  for(i = 0; i < len; i++) {
+    buf[i] = (i + id) % 8 == 0 ? specials[(i + id) % 3] : (uint8_t)(id + i);
+  }
+  /* Keep clear of the command and debug line prefixes */
+  buf[0] = 0x41;
+}
+/*****************************************************************************/
+/* The reference encoding, one byte at a time */
+static int
+encode(uint8_t *out, const uint8_t *in, int len)
+{
+  int i, n = 0;
+
+  for(i = 0; i < len; i++) {
+    if(in[i] == SLIP_END) {
+      out[n++] = SLIP_ESC;
+      out[n++] = SLIP_ESC_END;
+    } else if(in[i] == SLIP_ESC) {
+      out[n++] = SLIP_ESC;
+      out[n++] = SLIP_ESC_ESC;
+    } else {
+      out[n++] = in[i];
+    }
+  }
+  out[n++] = SLIP_END;
+  return n;
+}
+/*****************************************************************************/
+static int
+read_all(uint8_t *buf, int size)
+{
+  int n, len = 0;
+
+  while((n = read(peerfd, buf + len, size - len)) > 0) {
+    len += n;
+  }
+  return len;
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(slip_output, "SLIP encoding and queueing");
+UNIT_TEST(slip_output)
+{
+  UNIT_TEST_BEGIN();
+
+  static uint8_t expected[TEST_BATCH * (2 * TEST_LEN + 1)];
+  static uint8_t actual[sizeof(expected)];
+  uint8_t frame[TEST_LEN];
+  long writes;
+  int i, len;
+
+  /* Several queued frames go out in a single write. */
+  len = 0;
+  for(i = 0; i < TEST_BATCH; i++) {
+    make_frame(frame, i, TEST_LEN - i);
+    write_to_slip(frame, TEST_LEN - i);
+    len += encode(expected + len, frame, TEST_LEN - i);
+  }
+  UNIT_TEST_ASSERT(!slip_empty());
+  writes = slip_writes;
+  slip_flushbuf(slipfd);
+  UNIT_TEST_ASSERT(slip_empty());
+  UNIT_TEST_ASSERT(slip_writes == writes + 1);
+  UNIT_TEST_ASSERT(read_all(actual, sizeof(actual)) == len);
+  UNIT_TEST_ASSERT(memcmp(actual, expected, len) == 0);
+
+  /* An empty frame is a lone SLIP_END. */
+  write_to_slip(frame, 0);
+  slip_flushbuf(slipfd);
+  UNIT_TEST_ASSERT(read_all(actual, sizeof(actual)) == 1);
+  UNIT_TEST_ASSERT(actual[0] == SLIP_END);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(slip_input, "SLIP decoding across reads");
+UNIT_TEST(slip_input)
+{
+  UNIT_TEST_BEGIN();
+
+  static uint8_t encoded[TEST_BATCH * (2 * TEST_LEN + 1)];
+  uint8_t frame[TEST_LEN];
+  int i, len, split;
+
+  len = 0;
+  for(i = 0; i < TEST_BATCH; i++) {
+    make_frame(frame, i, TEST_LEN - i);
+    len += encode(encoded + len, frame, TEST_LEN - i);
+  }
+
+  /* Deliver the stream in pieces that split frames and escapes at
+     every possible point. */
+  for(split = 1; split < 2 * TEST_LEN + 1; split++) {
+    received_count = 0;
+    for(i = 0; i < len; i += split) {
+      UNIT_TEST_ASSERT(write(peerfd, encoded + i,
+                             i + split < len ? split : len - i) > 0);
+      serial_input(slipfd);
+    }
+    UNIT_TEST_ASSERT(received_count == TEST_BATCH);
+    for(i = 0; i < TEST_BATCH; i++) {
+      make_frame(frame, i, TEST_LEN - i);
+      UNIT_TEST_ASSERT(received_len[i] == TEST_LEN - i);
+      UNIT_TEST_ASSERT(memcmp(received[i], frame, TEST_LEN - i) == 0);
+    }
+  }
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(slip_benchmark, "SLIP throughput");
+UNIT_TEST(slip_benchmark)
+{
+  UNIT_TEST_BEGIN();
+
+  static uint8_t buf[TEST_BATCH * (2 * TEST_LEN + 1)];
+  uint8_t frame[TEST_LEN];
+  uint64_t start, elapsed;
+  long sent, received_bytes, writes, reads;
+  unsigned i, j;
+  int len;
+
+  make_frame(frame, 0, TEST_LEN);
+
+  /* Output: queue a batch of frames per flush, as a busy border
+     router does between two polls of its descriptors. */
+  sent = slip_sent;
+  writes = slip_writes;
+  start = now_ns();
+  for(i = 0; i < TEST_FRAMES; i += TEST_BATCH) {
+    for(j = 0; j < TEST_BATCH; j++) {
+      write_to_slip(frame, TEST_LEN);
+    }
+    while(!slip_empty()) {
+      slip_flushbuf(slipfd);
+      read_all(buf, sizeof(buf));
+    }
+  }
+  elapsed = now_ns() - start;
+  printf("output: %lu frames/s, %ld bytes/write\n",
+         (unsigned long)(TEST_FRAMES * 1000000000ULL / elapsed),
+         (slip_sent - sent) / (slip_writes - writes));
+
+  /* Input: a batch of frames arrives between two polls. */
+  len = 0;
+  for(j = 0; j < TEST_BATCH; j++) {
+    len += encode(buf + len, frame, TEST_LEN);
+  }
+  received_count = 0;
+  received_bytes = slip_received;
+  reads = slip_reads;
+  start = now_ns();
+  for(i = 0; i < TEST_FRAMES; i += TEST_BATCH) {
+    UNIT_TEST_ASSERT(write(peerfd, buf, len) == len);
+    serial_input(slipfd);
+  }
+  elapsed = now_ns() - start;
+  printf("input:  %lu frames/s, %ld bytes/read\n",
+         (unsigned long)(TEST_FRAMES * 1000000000ULL / elapsed),
+         (slip_received - received_bytes) / (slip_reads - reads));
+  UNIT_TEST_ASSERT(received_count == TEST_FRAMES);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_slip_dev_process, ev, data)
+{
+  int fds[2];
+
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  if(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == -1) {
+    printf("Failed to create socket pair\n");
+    printf("=check-me= FAILED\n");
+  } else {
+    fcntl(fds[0], F_SETFL, O_NONBLOCK);
+    fcntl(fds[1], F_SETFL, O_NONBLOCK);
+    slipfd = fds[0];
+    peerfd = fds[1];
+
+    UNIT_TEST_RUN(slip_output);
+    UNIT_TEST_RUN(slip_input);
+    UNIT_TEST_RUN(slip_benchmark);
+
+    if(!UNIT_TEST_PASSED(slip_output) ||
+       !UNIT_TEST_PASSED(slip_input) ||
+       !UNIT_TEST_PASSED(slip_benchmark)) {
+      printf("=check-me= FAILED\n");
+      printf("---\n");
+    }
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*****************************************************************************/
@@ -0,0 +1,243 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      End-to-end test and throughput benchmark for the native tun6
+ *      driver: a host UDP socket sends bursts of datagrams through the
+ *      tun device to an echo server running on the node.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+
+#include "contiki.h"
+#include "net/ipv6/uip-ds6.h"
+#include "net/ipv6/simple-udp.h"
+#include "tun6-net.h"
+#include "unit-test/unit-test.h"
+/*****************************************************************************/
+/* Number of datagrams echoed in the benchmark. */
+#ifdef TEST_CONF_PACKETS
+#define TEST_PACKETS TEST_CONF_PACKETS
+#else
+#define TEST_PACKETS 20000
+#endif
+
+/* Datagrams sent by the host before the node gets to run. */
+#define TEST_BURST 16
+#define TEST_LEN 64
+#define TEST_PORT 5678
+/*****************************************************************************/
+PROCESS(test_tun6_net_process, "tun6 test");
+AUTOSTART_PROCESSES(&test_tun6_net_process);
+
+static struct simple_udp_connection echo_conn;
+static int hostfd = -1;
+static unsigned long echoed;
+static unsigned long sent, received, bad;
+static uint64_t elapsed;
+static struct tun6_net_stats before;
+/*****************************************************************************/
+static uint64_t
+now_ns(void)
+{
+  struct timeval tv;
+
+  gettimeofday(&tv, NULL);
+  return (uint64_t)tv.tv_sec * 1000000000 + (uint64_t)tv.tv_usec * 1000;
+}
+/*****************************************************************************/
+static void
+echo_callback(struct simple_udp_connection *c,
+              const uip_ipaddr_t *sender_addr,
+              uint16_t sender_port,
+              const uip_ipaddr_t *receiver_addr,
+              uint16_t receiver_port,
+              const uint8_t *data,
+              uint16_t datalen)
+{
+  echoed++;
+  simple_udp_sendto_port(c, data, datalen, sender_addr, sender_port);
+}
+/*****************************************************************************/
+static int
+host_open(const uip_ipaddr_t *node_addr)
+{
+  struct sockaddr_in6 sin6;
+  int fd;
+
+  fd = socket(AF_INET6, SOCK_DGRAM, 0);
+  if(fd == -1) {
+    return -1;
+  }
+  fcntl(fd, F_SETFL, O_NONBLOCK);
+  /* Do not let another interface on the host claim the node's prefix */
+  setsockopt(fd, SOL_SOCKET, SO_BINDTODEVICE, "tun0", sizeof("tun0"));
+
+  memset(&sin6, 0, sizeof(sin6));
+  sin6.sin6_family = AF_INET6;
+  sin6.sin6_port = htons(TEST_PORT);
+  memcpy(&sin6.sin6_addr, node_addr, sizeof(sin6.sin6_addr));
+  if(connect(fd, (struct sockaddr *)&sin6, sizeof(sin6)) == -1) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+/*****************************************************************************/
+static int
+host_send(uint32_t seq)
+{
+  uint8_t buf[TEST_LEN];
+
+  memset(buf, seq & 0xff, sizeof(buf));
+  memcpy(buf, &seq, sizeof(seq));
+  if(send(hostfd, buf, sizeof(buf), 0) != sizeof(buf)) {
+    return 0;
+  }
+  sent++;
+  return 1;
+}
+/*****************************************************************************/
+static void
+host_receive(void)
+{
+  uint8_t buf[TEST_LEN + 1];
+  uint32_t seq;
+  ssize_t len;
+
+  while((len = recv(hostfd, buf, sizeof(buf), 0)) > 0) {
+    memcpy(&seq, buf, sizeof(seq));
+    if(len != TEST_LEN || buf[TEST_LEN - 1] != (seq & 0xff)) {
+      bad++;
+    }
+    received++;
+  }
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(tun6_echo, "tun6 burst echo");
+UNIT_TEST(tun6_echo)
+{
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(sent == TEST_PACKETS);
+  UNIT_TEST_ASSERT(echoed == TEST_PACKETS);
+  UNIT_TEST_ASSERT(received == TEST_PACKETS);
+  UNIT_TEST_ASSERT(bad == 0);
+  UNIT_TEST_ASSERT(tun6_net_stats.rx_packets - before.rx_packets ==
+                   TEST_PACKETS);
+  UNIT_TEST_ASSERT(tun6_net_stats.tx_packets - before.tx_packets ==
+                   TEST_PACKETS);
+#if TUN6_NET_BATCH > 1
+  /* The bursts must not take one wakeup per packet */
+  UNIT_TEST_ASSERT(tun6_net_stats.wakeups - before.wakeups <
+                   TEST_PACKETS / 2);
+#endif
+
+  printf("%lu packets/s, %lu.%02lu packets/wakeup, %lu dropped\n",
+         (unsigned long)(TEST_PACKETS * 1000000000ULL / elapsed),
+         (unsigned long)((tun6_net_stats.rx_packets - before.rx_packets) /
+                         (tun6_net_stats.wakeups - before.wakeups)),
+         (unsigned long)((tun6_net_stats.rx_packets - before.rx_packets) *
+                         100 / (tun6_net_stats.wakeups - before.wakeups) %
+                         100),
+         (unsigned long)(tun6_net_stats.tx_dropped - before.tx_dropped));
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_tun6_net_process, ev, data)
+{
+  static struct etimer et;
+  static uint64_t start, deadline;
+  uip_ds6_addr_t *node_addr;
+  int i;
+
+  PROCESS_BEGIN();
+
+  simple_udp_register(&echo_conn, TEST_PORT, NULL, 0, echo_callback);
+
+  /* Let the host finish configuring its side of the tun device */
+  etimer_set(&et, CLOCK_SECOND * 3);
+  PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  node_addr = uip_ds6_get_global(ADDR_PREFERRED);
+  if(node_addr != NULL) {
+    hostfd = host_open(&node_addr->ipaddr);
+  }
+  if(hostfd == -1) {
+    /* Without permission to create the tun device, there is nothing
+       to exercise. */
+    printf("No route to the node through tun, skipping\n");
+    printf("=check-me= DONE\n");
+    printf("---\n");
+    PROCESS_EXIT();
+  }
+
+  before = tun6_net_stats;
+  start = now_ns();
+  deadline = start + 30 * 1000000000ULL;
+  while(sent < TEST_PACKETS && now_ns() < deadline) {
+    for(i = 0; i < TEST_BURST && sent < TEST_PACKETS; i++) {
+      if(!host_send(sent)) {
+        break;
+      }
+    }
+    /* Hand over to the main loop, which reads the burst from tun,
+       until all echoes are back */
+    while(received < sent && now_ns() < deadline) {
+      PROCESS_PAUSE();
+      host_receive();
+    }
+  }
+  elapsed = now_ns() - start;
+
+  UNIT_TEST_RUN(tun6_echo);
+
+  if(!UNIT_TEST_PASSED(tun6_echo)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*****************************************************************************/
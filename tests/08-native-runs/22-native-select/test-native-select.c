@@ -0,0 +1,310 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Tests and benchmark for the file descriptor multiplexing of the
+ *      native platform main loop.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+
+#include "contiki.h"
+#include "unit-test/unit-test.h"
+/*****************************************************************************/
+/* Descriptors registered with the main loop but never ready */
+#define TEST_IDLE_FDS 200
+
+/* Duration of the round trip benchmark */
+#define TEST_DURATION (CLOCK_SECOND * 2)
+
+/* Bytes written at once to the edge-triggered descriptor */
+#define TEST_ET_BYTES 10
+/*****************************************************************************/
+PROCESS(test_native_select_process, "native select test");
+AUTOSTART_PROCESSES(&test_native_select_process);
+
+static int idle_fds[TEST_IDLE_FDS];
+static int ping_fd, ping_peer;
+static int et_fd, et_peer;
+static unsigned long idle_calls, ping_calls, et_calls, edge_calls;
+static unsigned long rounds;
+static long timer_late;
+static int reopen_reused, reopen_polled;
+static unsigned long level_calls;
+/*****************************************************************************/
+static int
+pair(int *fd, int *peer)
+{
+  int fds[2];
+
+  if(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == -1) {
+    return 0;
+  }
+  fcntl(fds[0], F_SETFL, O_NONBLOCK);
+  fcntl(fds[1], F_SETFL, O_NONBLOCK);
+  *fd = fds[0];
+  *peer = fds[1];
+  return 1;
+}
+/*****************************************************************************/
+/* The main loop asks the idle descriptors in the order they were
+   registered, so each call stands for the callback of the next one */
+static int
+idle_set_fd(fd_set *rset, fd_set *wset)
+{
+  static int next;
+
+  FD_SET(idle_fds[next], rset);
+  next = (next + 1) % TEST_IDLE_FDS;
+  return 1;
+}
+static void
+idle_handle_fd(fd_set *rset, fd_set *wset)
+{
+  idle_calls++;
+}
+static const struct select_callback idle_callback = {
+  idle_set_fd, idle_handle_fd
+};
+/*****************************************************************************/
+static int
+ping_set_fd(fd_set *rset, fd_set *wset)
+{
+  FD_SET(ping_fd, rset);
+  return 1;
+}
+static void
+ping_handle_fd(fd_set *rset, fd_set *wset)
+{
+  char c;
+
+  if(FD_ISSET(ping_fd, rset)) {
+    ping_calls++;
+    while(read(ping_fd, &c, 1) == 1) {
+      process_poll(&test_native_select_process);
+    }
+  }
+}
+static const struct select_callback ping_callback = {
+  ping_set_fd, ping_handle_fd
+};
+/*****************************************************************************/
+static int
+et_set_fd(fd_set *rset, fd_set *wset)
+{
+  FD_SET(et_fd, rset);
+  return 1;
+}
+static void
+et_handle_fd(fd_set *rset, fd_set *wset)
+{
+  char c;
+
+  /* Deliberately leaves data behind */
+  if(FD_ISSET(et_fd, rset) && read(et_fd, &c, 1) == 1) {
+    et_calls++;
+  }
+}
+static const struct select_callback et_callback = {
+  et_set_fd, et_handle_fd, 1
+};
+static const struct select_callback level_callback = {
+  et_set_fd, et_handle_fd, 0
+};
+/*****************************************************************************/
+UNIT_TEST_REGISTER(select_timer, "Wakeup for the next etimer");
+UNIT_TEST(select_timer)
+{
+  UNIT_TEST_BEGIN();
+
+  printf("etimer fired %ld ms late\n", timer_late);
+  UNIT_TEST_ASSERT(timer_late >= 0);
+#if SELECT_CONF_EPOLL
+  UNIT_TEST_ASSERT(timer_late < CLOCK_SECOND / 20);
+#endif
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(select_ready, "Only ready descriptors are handled");
+UNIT_TEST(select_ready)
+{
+  UNIT_TEST_BEGIN();
+
+  printf("%lu round trips/s, %lu idle callbacks\n",
+         rounds * CLOCK_SECOND / TEST_DURATION, idle_calls);
+  UNIT_TEST_ASSERT(rounds > 0);
+  UNIT_TEST_ASSERT(ping_calls >= rounds);
+#if SELECT_CONF_EPOLL
+  UNIT_TEST_ASSERT(idle_calls == 0);
+#endif
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(select_edge, "Edge-triggered descriptors");
+UNIT_TEST(select_edge)
+{
+  UNIT_TEST_BEGIN();
+
+  printf("%lu edge-triggered callbacks\n", edge_calls);
+#if SELECT_CONF_EPOLL
+  /* Once per write, in spite of the data left behind */
+  UNIT_TEST_ASSERT(edge_calls == 2);
+#else
+  UNIT_TEST_ASSERT(edge_calls == 2 * TEST_ET_BYTES);
+#endif
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(select_reregister, "Registering a descriptor again");
+UNIT_TEST(select_reregister)
+{
+  UNIT_TEST_BEGIN();
+
+  printf("reopened descriptor %s, %s; %lu level-triggered callbacks\n",
+         reopen_reused ? "reused" : "not reused",
+         reopen_polled ? "polled" : "not polled", level_calls);
+  /* A descriptor closed and reopened under the same number is polled */
+  UNIT_TEST_ASSERT(reopen_polled);
+  /* Dropping the edge-triggered flag makes the data left behind count */
+  UNIT_TEST_ASSERT(level_calls == TEST_ET_BYTES);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_native_select_process, ev, data)
+{
+  static struct etimer et;
+  static clock_time_t deadline;
+  static char buf[TEST_ET_BYTES];
+  static int i;
+  int peer, old_fd;
+
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  for(i = 0; i < TEST_IDLE_FDS; i++) {
+    if(!pair(&idle_fds[i], &peer) ||
+       !select_set_callback(idle_fds[i], &idle_callback)) {
+      printf("Failed to set up the idle descriptors\n");
+      printf("=check-me= FAILED\n");
+      printf("=check-me= DONE\n");
+      PROCESS_EXIT();
+    }
+  }
+  if(!pair(&ping_fd, &ping_peer) || !pair(&et_fd, &et_peer) ||
+     !select_set_callback(ping_fd, &ping_callback) ||
+     !select_set_callback(et_fd, &et_callback)) {
+    printf("Failed to set up the descriptors\n");
+    printf("=check-me= FAILED\n");
+    printf("=check-me= DONE\n");
+    PROCESS_EXIT();
+  }
+
+  /* Nothing else to wake up the main loop in the meantime */
+  etimer_set(&et, CLOCK_SECOND / 5);
+  deadline = etimer_expiration_time(&et);
+  PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+  timer_late = (long)(clock_time() - deadline);
+
+  /* Round trips through the main loop with many idle descriptors */
+  deadline = clock_time() + TEST_DURATION;
+  while(clock_time() < deadline) {
+    if(write(ping_peer, "p", 1) != 1) {
+      break;
+    }
+    PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_POLL);
+    rounds++;
+  }
+
+  /* Two writes, separated by enough main loop iterations to drain any
+     level-triggered descriptor */
+  memset(buf, 'e', sizeof(buf));
+  for(i = 0; i < 2; i++) {
+    if(write(et_peer, buf, sizeof(buf)) != sizeof(buf)) {
+      break;
+    }
+    etimer_set(&et, CLOCK_SECOND / 10);
+    PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+    while(read(et_fd, buf, sizeof(buf)) > 0);
+  }
+  edge_calls = et_calls;
+
+  /* A driver closes its descriptor and registers the one it opens
+     next, which gets the same number */
+  old_fd = ping_fd;
+  close(ping_fd);
+  close(ping_peer);
+  if(pair(&ping_fd, &ping_peer) &&
+     select_set_callback(ping_fd, &ping_callback)) {
+    reopen_reused = ping_fd == old_fd;
+    if(write(ping_peer, "p", 1) == 1) {
+      etimer_set(&et, CLOCK_SECOND / 5);
+      PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_POLL || etimer_expired(&et));
+      reopen_polled = ev == PROCESS_EVENT_POLL;
+    }
+  }
+
+  /* The same descriptor, registered again as level-triggered */
+  if(select_set_callback(et_fd, &level_callback) &&
+     write(et_peer, buf, TEST_ET_BYTES) == TEST_ET_BYTES) {
+    etimer_set(&et, CLOCK_SECOND / 10);
+    PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+  }
+  level_calls = et_calls - edge_calls;
+
+  UNIT_TEST_RUN(select_timer);
+  UNIT_TEST_RUN(select_ready);
+  UNIT_TEST_RUN(select_edge);
+  UNIT_TEST_RUN(select_reregister);
+
+  if(!UNIT_TEST_PASSED(select_timer) ||
+     !UNIT_TEST_PASSED(select_ready) ||
+     !UNIT_TEST_PASSED(select_edge) ||
+     !UNIT_TEST_PASSED(select_reregister)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*****************************************************************************/
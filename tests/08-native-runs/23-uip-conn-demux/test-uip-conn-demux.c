@@ -0,0 +1,308 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Tests and benchmark for the demultiplexing of incoming UDP
+ *      datagrams and TCP segments to uIP connections.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "contiki.h"
+#include "net/ipv6/uip.h"
+#include "net/ipv6/uip-ds6.h"
+#include "unit-test/unit-test.h"
+/*****************************************************************************/
+/* Datagrams demultiplexed per measurement */
+#define TEST_ROUNDS 20000
+
+#define TEST_PORT 10000
+#define TEST_REMOTE_PORT 20000
+/*****************************************************************************/
+PROCESS(test_uip_conn_demux_process, "uIP connection demux test");
+AUTOSTART_PROCESSES(&test_uip_conn_demux_process);
+
+static uip_ipaddr_t remote_addr;
+static uip_ipaddr_t other_addr;
+static uip_ipaddr_t node_addr;
+/*****************************************************************************/
+static uint64_t
+now_ns(void)
+{
+  struct timeval tv;
+
+  gettimeofday(&tv, NULL);
+  return (uint64_t)tv.tv_sec * 1000000000 + (uint64_t)tv.tv_usec * 1000;
+}
+/*****************************************************************************/
+static void
+make_ip(const uip_ipaddr_t *src, uint8_t proto, uint16_t payload_len)
+{
+  uip_ext_len = 0;
+  memset(uip_buf, 0, UIP_IPH_LEN + payload_len);
+  UIP_IP_BUF->vtc = 0x60;
+  UIP_IP_BUF->len[0] = payload_len >> 8;
+  UIP_IP_BUF->len[1] = payload_len & 0xff;
+  UIP_IP_BUF->proto = proto;
+  UIP_IP_BUF->ttl = 64;
+  uip_ipaddr_copy(&UIP_IP_BUF->srcipaddr, src);
+  uip_ipaddr_copy(&UIP_IP_BUF->destipaddr, &node_addr);
+  uip_len = UIP_IPH_LEN + payload_len;
+}
+/*****************************************************************************/
+/* Feed a datagram to uIP and return the connection it was delivered to */
+static struct uip_udp_conn *
+udp_input(const uip_ipaddr_t *src, uint16_t srcport, uint16_t destport)
+{
+  make_ip(src, UIP_PROTO_UDP, UIP_UDPH_LEN + 4);
+  UIP_UDP_BUF->srcport = UIP_HTONS(srcport);
+  UIP_UDP_BUF->destport = UIP_HTONS(destport);
+  UIP_UDP_BUF->udplen = UIP_HTONS(UIP_UDPH_LEN + 4);
+  /* A zero checksum is accepted */
+  UIP_UDP_BUF->udpchksum = 0;
+
+  uip_udp_conn = NULL;
+  uip_input();
+  if(uip_udp_conn < &uip_udp_conns[0] ||
+     uip_udp_conn >= &uip_udp_conns[UIP_UDP_CONNS]) {
+    return NULL;
+  }
+  return uip_udp_conn;
+}
+/*****************************************************************************/
+static void
+tcp_input(const uip_ipaddr_t *src, uint16_t srcport, uint16_t destport,
+          uint8_t flags)
+{
+  make_ip(src, UIP_PROTO_TCP, UIP_TCPH_LEN);
+  UIP_TCP_BUF->srcport = srcport;
+  UIP_TCP_BUF->destport = destport;
+  UIP_TCP_BUF->tcpoffset = 5 << 4;
+  UIP_TCP_BUF->flags = flags;
+  UIP_TCP_BUF->tcpchksum = 0;
+  UIP_TCP_BUF->tcpchksum = ~(uip_tcpchksum());
+
+  uip_input();
+}
+/*****************************************************************************/
+static struct uip_udp_conn *
+udp_conn(uint16_t lport, const uip_ipaddr_t *ripaddr, uint16_t rport)
+{
+  struct uip_udp_conn *conn;
+
+  conn = uip_udp_new(ripaddr, rport ? UIP_HTONS(rport) : 0);
+  if(conn != NULL) {
+    conn->appstate.p = PROCESS_NONE;
+    uip_udp_bind(conn, UIP_HTONS(lport));
+  }
+  return conn;
+}
+/*****************************************************************************/
+static void
+udp_remove_all(void)
+{
+  int i;
+
+  for(i = 0; i < UIP_UDP_CONNS; i++) {
+    if(uip_udp_conns[i].lport != 0) {
+      uip_udp_remove(&uip_udp_conns[i]);
+    }
+  }
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(udp_demux, "UDP demultiplexing");
+UNIT_TEST(udp_demux)
+{
+  struct uip_udp_conn *any, *bound, *port_only;
+
+  UNIT_TEST_BEGIN();
+
+  any = udp_conn(TEST_PORT, NULL, 0);
+  bound = udp_conn(TEST_PORT, &remote_addr, TEST_REMOTE_PORT);
+  port_only = udp_conn(TEST_PORT + 1, NULL, TEST_REMOTE_PORT);
+  UNIT_TEST_ASSERT(any != NULL && bound != NULL && port_only != NULL);
+
+#if UIP_CONN_HASH_SIZE
+  /* The connection bound to the source wins */
+  UNIT_TEST_ASSERT(udp_input(&remote_addr, TEST_REMOTE_PORT,
+                             TEST_PORT) == bound);
+#else
+  /* The first matching connection wins */
+  UNIT_TEST_ASSERT(udp_input(&remote_addr, TEST_REMOTE_PORT,
+                             TEST_PORT) == any);
+#endif
+  UNIT_TEST_ASSERT(udp_input(&other_addr, TEST_REMOTE_PORT,
+                             TEST_PORT) == any);
+  UNIT_TEST_ASSERT(udp_input(&remote_addr, TEST_REMOTE_PORT + 1,
+                             TEST_PORT) == any);
+
+  /* Bound to a remote port only */
+  UNIT_TEST_ASSERT(udp_input(&other_addr, TEST_REMOTE_PORT,
+                             TEST_PORT + 1) == port_only);
+  UNIT_TEST_ASSERT(udp_input(&other_addr, TEST_REMOTE_PORT + 1,
+                             TEST_PORT + 1) == NULL);
+
+  /* Moving and removing connections */
+  uip_udp_bind(any, UIP_HTONS(TEST_PORT + 2));
+  UNIT_TEST_ASSERT(udp_input(&other_addr, TEST_REMOTE_PORT,
+                             TEST_PORT) == NULL);
+  UNIT_TEST_ASSERT(udp_input(&remote_addr, TEST_REMOTE_PORT,
+                             TEST_PORT) == bound);
+  UNIT_TEST_ASSERT(udp_input(&other_addr, TEST_REMOTE_PORT,
+                             TEST_PORT + 2) == any);
+  uip_udp_remove(any);
+  UNIT_TEST_ASSERT(udp_input(&other_addr, TEST_REMOTE_PORT,
+                             TEST_PORT + 2) == NULL);
+  uip_udp_remove(bound);
+  UNIT_TEST_ASSERT(udp_input(&remote_addr, TEST_REMOTE_PORT,
+                             TEST_PORT) == NULL);
+
+  /* Ports handed out are not in use */
+  any = udp_conn(TEST_PORT, NULL, 0);
+  bound = uip_udp_new(NULL, 0);
+  UNIT_TEST_ASSERT(bound != NULL && bound->lport != any->lport);
+
+  udp_remove_all();
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(tcp_demux, "TCP demultiplexing");
+UNIT_TEST(tcp_demux)
+{
+  struct uip_conn *conn1, *conn2;
+
+  UNIT_TEST_BEGIN();
+
+  conn1 = uip_connect(&remote_addr, UIP_HTONS(TEST_REMOTE_PORT));
+  UNIT_TEST_ASSERT(conn1 != NULL);
+  conn1->appstate.p = PROCESS_NONE;
+  conn2 = uip_connect(&remote_addr, UIP_HTONS(TEST_REMOTE_PORT));
+  UNIT_TEST_ASSERT(conn2 != NULL && conn2 != conn1);
+  conn2->appstate.p = PROCESS_NONE;
+  UNIT_TEST_ASSERT(conn1->lport != conn2->lport);
+
+  /* A reset for another peer does not match */
+  tcp_input(&other_addr, UIP_HTONS(TEST_REMOTE_PORT), conn1->lport, 0x04);
+  UNIT_TEST_ASSERT(conn1->tcpstateflags == UIP_SYN_SENT);
+  tcp_input(&remote_addr, UIP_HTONS(TEST_REMOTE_PORT + 1), conn1->lport, 0x04);
+  UNIT_TEST_ASSERT(conn1->tcpstateflags == UIP_SYN_SENT);
+
+  /* Only the connection of the reset is aborted */
+  tcp_input(&remote_addr, UIP_HTONS(TEST_REMOTE_PORT), conn1->lport, 0x04);
+  UNIT_TEST_ASSERT(conn1->tcpstateflags == UIP_CLOSED);
+  UNIT_TEST_ASSERT(conn2->tcpstateflags == UIP_SYN_SENT);
+  tcp_input(&remote_addr, UIP_HTONS(TEST_REMOTE_PORT), conn2->lport, 0x04);
+  UNIT_TEST_ASSERT(conn2->tcpstateflags == UIP_CLOSED);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(udp_benchmark, "UDP demultiplexing cost");
+UNIT_TEST(udp_benchmark)
+{
+  static const int counts[] = { 8, 64, UIP_UDP_CONNS };
+  struct uip_udp_conn *last;
+  uint64_t start;
+  unsigned long first_ns, last_ns;
+  int i, n, k;
+
+  UNIT_TEST_BEGIN();
+
+  printf("connections  first (ns)  last (ns)\n");
+  for(k = 0; k < sizeof(counts) / sizeof(counts[0]); k++) {
+    udp_remove_all();
+    last = NULL;
+    for(n = 0; n < counts[k]; n++) {
+      last = udp_conn(TEST_PORT + n, NULL, 0);
+      UNIT_TEST_ASSERT(last != NULL);
+    }
+
+    start = now_ns();
+    for(i = 0; i < TEST_ROUNDS; i++) {
+      if(udp_input(&remote_addr, TEST_REMOTE_PORT, TEST_PORT) == NULL) {
+        break;
+      }
+    }
+    first_ns = (now_ns() - start) / TEST_ROUNDS;
+    UNIT_TEST_ASSERT(i == TEST_ROUNDS);
+
+    start = now_ns();
+    for(i = 0; i < TEST_ROUNDS; i++) {
+      if(udp_input(&remote_addr, TEST_REMOTE_PORT,
+                   TEST_PORT + counts[k] - 1) != last) {
+        break;
+      }
+    }
+    last_ns = (now_ns() - start) / TEST_ROUNDS;
+    UNIT_TEST_ASSERT(i == TEST_ROUNDS);
+
+    printf("%11d  %10lu  %9lu\n", counts[k], first_ns, last_ns);
+  }
+  udp_remove_all();
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_uip_conn_demux_process, ev, data)
+{
+  uip_ds6_addr_t *addr;
+
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  uip_ip6addr(&remote_addr, 0xfd00, 0, 0, 0, 0, 0, 0, 0x100);
+  uip_ip6addr(&other_addr, 0xfd00, 0, 0, 0, 0, 0, 0, 0x200);
+  addr = uip_ds6_get_global(-1);
+  if(addr != NULL) {
+    uip_ipaddr_copy(&node_addr, &addr->ipaddr);
+  }
+
+  UNIT_TEST_RUN(udp_demux);
+  UNIT_TEST_RUN(tcp_demux);
+  UNIT_TEST_RUN(udp_benchmark);
+
+  if(!UNIT_TEST_PASSED(udp_demux) ||
+     !UNIT_TEST_PASSED(tcp_demux) ||
+     !UNIT_TEST_PASSED(udp_benchmark)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*****************************************************************************/
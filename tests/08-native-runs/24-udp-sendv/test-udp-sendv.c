@@ -0,0 +1,296 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Tests and benchmark for sending UDP datagrams gathered from
+ *      several buffers.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "contiki.h"
+#include "net/netstack.h"
+#include "net/ipv6/uip.h"
+#include "net/ipv6/simple-udp.h"
+#include "net/ipv6/udp-socket.h"
+#include "unit-test/unit-test.h"
+/*****************************************************************************/
+/* Datagrams sent per measurement */
+#define TEST_ROUNDS 100000
+
+#define TEST_PORT 5683
+#define TEST_HDR_LEN 12
+#define TEST_MAX_LEN (UIP_BUFSIZE - UIP_IPUDPH_LEN)
+/*****************************************************************************/
+PROCESS(test_udp_sendv_process, "UDP gather send test");
+AUTOSTART_PROCESSES(&test_udp_sendv_process);
+
+static struct simple_udp_connection conn;
+static struct udp_socket sock;
+static uip_ipaddr_t dest_addr;
+
+static uint8_t captured[UIP_BUFSIZE];
+static uint16_t captured_len;
+static unsigned long captured_count;
+static uint8_t capture = 1;
+
+static uint8_t test_data[TEST_MAX_LEN];
+/*****************************************************************************/
+static void
+test_init(void)
+{
+}
+static void
+test_input(void)
+{
+}
+static uint8_t
+test_output(const linkaddr_t *localdest)
+{
+  captured_count++;
+  if(capture) {
+    memcpy(captured, uip_buf, uip_len);
+    captured_len = uip_len;
+  }
+  return 0;
+}
+const struct network_driver test_network_driver = {
+  "test", test_init, test_input, test_output
+};
+/*****************************************************************************/
+static uint64_t
+now_ns(void)
+{
+  struct timeval tv;
+
+  gettimeofday(&tv, NULL);
+  return (uint64_t)tv.tv_sec * 1000000000 + (uint64_t)tv.tv_usec * 1000;
+}
+/*****************************************************************************/
+/* Plain RFC 1071 sum, independent from the one of uIP */
+static uint32_t
+sum16(uint32_t sum, const uint8_t *p, int len)
+{
+  int i;
+
+  for(i = 0; i + 1 < len; i += 2) {
+    sum += (p[i] << 8) | p[i + 1];
+  }
+  if(len & 1) {
+    sum += p[len - 1] << 8;
+  }
+  return sum;
+}
+/*****************************************************************************/
+/* Check that the captured datagram is valid and carries the payload */
+static int
+check_captured(const uint8_t *payload, int len)
+{
+  struct uip_ip_hdr *ip = (struct uip_ip_hdr *)captured;
+  struct uip_udp_hdr *udp = (struct uip_udp_hdr *)&captured[UIP_IPH_LEN];
+  uint32_t sum;
+
+  if(captured_len != UIP_IPUDPH_LEN + len ||
+     ip->proto != UIP_PROTO_UDP ||
+     uip_ntohs(udp->udplen) != UIP_UDPH_LEN + len ||
+     udp->destport != UIP_HTONS(TEST_PORT) ||
+     memcmp(&captured[UIP_IPUDPH_LEN], payload, len) != 0) {
+    return 0;
+  }
+
+  sum = UIP_PROTO_UDP + UIP_UDPH_LEN + len;
+  sum = sum16(sum, (uint8_t *)&ip->srcipaddr, 2 * sizeof(uip_ipaddr_t));
+  sum = sum16(sum, (uint8_t *)udp, UIP_UDPH_LEN + len);
+  while(sum >> 16) {
+    sum = (sum & 0xffff) + (sum >> 16);
+  }
+  return sum == 0xffff;
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(udp_sendv, "Gathered datagrams");
+UNIT_TEST(udp_sendv)
+{
+  struct uip_iov iov[4];
+  int len, a, b;
+
+  UNIT_TEST_BEGIN();
+
+  /* Fragments of all small odd and even lengths, including empty ones */
+  for(len = 1; len <= 40; len++) {
+    for(a = 0; a <= len; a++) {
+      for(b = a; b <= len; b += 3) {
+        iov[0].data = test_data;
+        iov[0].len = a;
+        iov[1].data = test_data + a;
+        iov[1].len = b - a;
+        iov[2].data = test_data + b;
+        iov[2].len = len - b;
+        captured_len = 0;
+        simple_udp_sendto_portv(&conn, iov, 3, &dest_addr, TEST_PORT);
+        UNIT_TEST_ASSERT(check_captured(test_data, len));
+      }
+    }
+  }
+
+  /* A full datagram */
+  iov[0].data = test_data;
+  iov[0].len = 1;
+  iov[1].data = test_data + 1;
+  iov[1].len = TEST_MAX_LEN - 1;
+  captured_len = 0;
+  simple_udp_sendto_portv(&conn, iov, 2, &dest_addr, TEST_PORT);
+  UNIT_TEST_ASSERT(check_captured(test_data, TEST_MAX_LEN));
+
+  /* The contiguous path still checksums correctly */
+  captured_len = 0;
+  simple_udp_sendto_port(&conn, test_data + 1, 333, &dest_addr, TEST_PORT);
+  UNIT_TEST_ASSERT(check_captured(test_data + 1, 333));
+
+  /* Payload already in place in uip_buf */
+  memcpy(&uip_buf[UIP_IPUDPH_LEN], test_data, 100);
+  iov[0].data = &uip_buf[UIP_IPUDPH_LEN];
+  iov[0].len = 100;
+  iov[1].data = test_data + 100;
+  iov[1].len = 27;
+  captured_len = 0;
+  simple_udp_sendto_portv(&conn, iov, 2, &dest_addr, TEST_PORT);
+  UNIT_TEST_ASSERT(check_captured(test_data, 127));
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(udp_socket_sendv, "Gathered datagrams on UDP sockets");
+UNIT_TEST(udp_socket_sendv)
+{
+  struct uip_iov iov[2];
+  unsigned long count;
+
+  UNIT_TEST_BEGIN();
+
+  iov[0].data = test_data;
+  iov[0].len = 7;
+  iov[1].data = test_data + 7;
+  iov[1].len = 200;
+  captured_len = 0;
+  UNIT_TEST_ASSERT(udp_socket_sendtov(&sock, iov, 2, &dest_addr,
+                                      TEST_PORT) == 207);
+  UNIT_TEST_ASSERT(check_captured(test_data, 207));
+
+  UNIT_TEST_ASSERT(udp_socket_connect(&sock, &dest_addr, TEST_PORT) == 1);
+  captured_len = 0;
+  UNIT_TEST_ASSERT(udp_socket_sendv(&sock, iov, 2) == 207);
+  UNIT_TEST_ASSERT(check_captured(test_data, 207));
+
+  /* Too long */
+  count = captured_count;
+  iov[1].len = TEST_MAX_LEN;
+  UNIT_TEST_ASSERT(udp_socket_sendv(&sock, iov, 2) == -1);
+  UNIT_TEST_ASSERT(captured_count == count);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(udp_sendv_benchmark, "Gathered datagram cost");
+UNIT_TEST(udp_sendv_benchmark)
+{
+  static const int lens[] = { 16, 64, 256, 1024 };
+  static uint8_t appbuf[TEST_MAX_LEN];
+  struct uip_iov iov[2];
+  uint64_t start;
+  unsigned long copy_ns, gather_ns;
+  int i, k;
+
+  UNIT_TEST_BEGIN();
+
+  capture = 0;
+  printf("payload  copy+send (ns)  sendv (ns)\n");
+  for(k = 0; k < sizeof(lens) / sizeof(lens[0]); k++) {
+    /* Header and payload put together by the application first */
+    start = now_ns();
+    for(i = 0; i < TEST_ROUNDS; i++) {
+      memcpy(appbuf, test_data, TEST_HDR_LEN);
+      memcpy(appbuf + TEST_HDR_LEN, test_data + TEST_HDR_LEN, lens[k]);
+      simple_udp_sendto_port(&conn, appbuf, TEST_HDR_LEN + lens[k],
+                             &dest_addr, TEST_PORT);
+    }
+    copy_ns = (now_ns() - start) / TEST_ROUNDS;
+
+    start = now_ns();
+    for(i = 0; i < TEST_ROUNDS; i++) {
+      iov[0].data = test_data;
+      iov[0].len = TEST_HDR_LEN;
+      iov[1].data = test_data + TEST_HDR_LEN;
+      iov[1].len = lens[k];
+      simple_udp_sendto_portv(&conn, iov, 2, &dest_addr, TEST_PORT);
+    }
+    gather_ns = (now_ns() - start) / TEST_ROUNDS;
+
+    printf("%7d  %14lu  %10lu\n", lens[k], copy_ns, gather_ns);
+  }
+  capture = 1;
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_udp_sendv_process, ev, data)
+{
+  int i;
+
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  for(i = 0; i < sizeof(test_data); i++) {
+    test_data[i] = i * 7 + (i >> 8);
+  }
+  uip_create_linklocal_allnodes_mcast(&dest_addr);
+  simple_udp_register(&conn, TEST_PORT + 1, NULL, TEST_PORT, NULL);
+  udp_socket_register(&sock, NULL, NULL);
+
+  UNIT_TEST_RUN(udp_sendv);
+  UNIT_TEST_RUN(udp_socket_sendv);
+  UNIT_TEST_RUN(udp_sendv_benchmark);
+
+  if(!UNIT_TEST_PASSED(udp_sendv) ||
+     !UNIT_TEST_PASSED(udp_socket_sendv) ||
+     !UNIT_TEST_PASSED(udp_sendv_benchmark)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*****************************************************************************/
@@ -0,0 +1,340 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Tests and benchmark for the Internet checksum of uIP and for
+ *      summing data while copying it into uip_buf.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "contiki.h"
+#include "net/ipv6/uip.h"
+#include "net/ipv6/uip-ds6.h"
+#include "net/ipv6/uip-icmp6.h"
+#include "unit-test/unit-test.h"
+/*****************************************************************************/
+/* Bytes summed per measurement */
+#define TEST_BYTES 100000000
+
+#define TEST_MAX_LEN (UIP_BUFSIZE - UIP_IPH_LEN - 8)
+/*****************************************************************************/
+PROCESS(test_uip_chksum_process, "uIP checksum test");
+AUTOSTART_PROCESSES(&test_uip_chksum_process);
+
+static uint8_t test_data[UIP_BUFSIZE + 8];
+static volatile uint16_t sink;
+/*****************************************************************************/
+static uint64_t
+now_ns(void)
+{
+  struct timeval tv;
+
+  gettimeofday(&tv, NULL);
+  return (uint64_t)tv.tv_sec * 1000000000 + (uint64_t)tv.tv_usec * 1000;
+}
+/*****************************************************************************/
+static uint64_t
+now_cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+  return __builtin_ia32_rdtsc();
+#else
+  return 0;
+#endif
+}
+/*****************************************************************************/
+/* The byte-pair loop uIP used before, as a reference and a baseline */
+static uint16_t
+sum_bytes(uint16_t sum, const uint8_t *data, uint16_t len)
+{
+  uint16_t t;
+  const uint8_t *dataptr;
+  const uint8_t *last_byte;
+
+  dataptr = data;
+  last_byte = data + len - 1;
+
+  while(dataptr < last_byte) {
+    t = (dataptr[0] << 8) + dataptr[1];
+    sum += t;
+    if(sum < t) {
+      sum++;
+    }
+    dataptr += 2;
+  }
+  if(dataptr == last_byte) {
+    t = (dataptr[0] << 8) + 0;
+    sum += t;
+    if(sum < t) {
+      sum++;
+    }
+  }
+  return sum;
+}
+/*****************************************************************************/
+/* Put an ICMPv6 message with a header of hdr_len bytes in uip_buf */
+static void
+build_icmp6(int hdr_len, int payload_len)
+{
+  memset(uip_buf, 0, UIP_IPH_LEN);
+  UIP_IP_BUF->vtc = 0x60;
+  UIP_IP_BUF->proto = UIP_PROTO_ICMP6;
+  memcpy(&UIP_IP_BUF->srcipaddr, test_data + 3, 2 * sizeof(uip_ipaddr_t));
+  uipbuf_set_len_field(UIP_IP_BUF, hdr_len + payload_len);
+  memcpy(&uip_buf[UIP_IPH_LEN], test_data + 100, hdr_len);
+  uip_ext_len = 0;
+  uip_len = UIP_IPH_LEN + hdr_len + payload_len;
+}
+/*****************************************************************************/
+/* ICMPv6 checksum of the message in uip_buf, with the reference sum */
+static uint16_t
+icmp6_ref(void)
+{
+  uint16_t len = uipbuf_get_len_field(UIP_IP_BUF);
+  uint16_t sum;
+
+  sum = len + UIP_PROTO_ICMP6;
+  sum = sum_bytes(sum, (uint8_t *)&UIP_IP_BUF->srcipaddr,
+                  2 * sizeof(uip_ipaddr_t));
+  sum = sum_bytes(sum, &uip_buf[UIP_IPH_LEN], len);
+  return (sum == 0) ? 0xffff : uip_htons(sum);
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(chksum, "Checksum of any length and alignment");
+UNIT_TEST(chksum)
+{
+  int len, off;
+
+  UNIT_TEST_BEGIN();
+
+  for(off = 0; off < 8; off++) {
+    for(len = 0; len <= 300; len++) {
+      UNIT_TEST_ASSERT(uip_ntohs(uip_chksum((uint16_t *)(test_data + off),
+                                            len)) ==
+                       sum_bytes(0, test_data + off, len));
+    }
+    len = TEST_MAX_LEN;
+    UNIT_TEST_ASSERT(uip_ntohs(uip_chksum((uint16_t *)(test_data + off),
+                                          len)) ==
+                     sum_bytes(0, test_data + off, len));
+  }
+
+  /* Many carries */
+  memset(uip_buf, 0xff, UIP_BUFSIZE);
+  UNIT_TEST_ASSERT(uip_ntohs(uip_chksum((uint16_t *)uip_buf, UIP_BUFSIZE)) ==
+                   sum_bytes(0, uip_buf, UIP_BUFSIZE));
+  uip_buf[5] = 0xfe;
+  UNIT_TEST_ASSERT(uip_ntohs(uip_chksum((uint16_t *)uip_buf, UIP_BUFSIZE)) ==
+                   sum_bytes(0, uip_buf, UIP_BUFSIZE));
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(copy_chksum, "Summing data while copying it");
+UNIT_TEST(copy_chksum)
+{
+  int hdr_len, len, off;
+
+  UNIT_TEST_BEGIN();
+
+  for(hdr_len = 4; hdr_len <= 9; hdr_len++) {
+    for(off = 0; off < 4; off++) {
+      for(len = 0; len <= 100; len++) {
+        build_icmp6(hdr_len, len);
+        uip_copy_chksum(UIP_IPH_LEN + hdr_len, test_data + off, len);
+        UNIT_TEST_ASSERT(memcmp(&uip_buf[UIP_IPH_LEN + hdr_len],
+                                test_data + off, len) == 0);
+        /* The first checksum uses the stored sum, the second does not */
+        UNIT_TEST_ASSERT(uip_icmp6chksum() == icmp6_ref());
+        UNIT_TEST_ASSERT(uip_icmp6chksum() == icmp6_ref());
+      }
+    }
+  }
+
+  /* Data that does not end the message is summed again */
+  build_icmp6(8, 100);
+  uip_copy_chksum(UIP_IPH_LEN + 8, test_data, 50);
+  UNIT_TEST_ASSERT(uip_icmp6chksum() == icmp6_ref());
+
+  /* A forgotten sum is not used even if it would match */
+  build_icmp6(8, 100);
+  uip_copy_chksum(UIP_IPH_LEN + 8, test_data, 100);
+  uip_buf[UIP_IPH_LEN + 50]++;
+  uip_forget_chksum();
+  UNIT_TEST_ASSERT(uip_icmp6chksum() == icmp6_ref());
+
+  /* Overlapping copies inside uip_buf, in both directions */
+  build_icmp6(8, 200);
+  memcpy(&uip_buf[UIP_IPH_LEN + 20], test_data, 200);
+  uip_copy_chksum(UIP_IPH_LEN + 8, &uip_buf[UIP_IPH_LEN + 20], 200);
+  UNIT_TEST_ASSERT(memcmp(&uip_buf[UIP_IPH_LEN + 8], test_data, 200) == 0);
+  UNIT_TEST_ASSERT(uip_icmp6chksum() == icmp6_ref());
+  build_icmp6(8, 200);
+  memcpy(&uip_buf[UIP_IPH_LEN + 1], test_data, 200);
+  uip_copy_chksum(UIP_IPH_LEN + 8, &uip_buf[UIP_IPH_LEN + 1], 200);
+  UNIT_TEST_ASSERT(memcmp(&uip_buf[UIP_IPH_LEN + 8], test_data, 200) == 0);
+  UNIT_TEST_ASSERT(uip_icmp6chksum() == icmp6_ref());
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(echo_reply, "Echo reply to a message summed on input");
+UNIT_TEST(echo_reply)
+{
+  uint8_t msg[UIP_ICMPH_LEN + 4 + 61];
+  uip_ds6_addr_t *lladdr;
+  int len;
+
+  UNIT_TEST_BEGIN();
+
+  lladdr = uip_ds6_get_link_local(-1);
+  UNIT_TEST_ASSERT(lladdr != NULL);
+
+  /* An echo request, summed while copied in like 6LoWPAN does, and
+     processed without the checksum being checked */
+  len = sizeof(msg);
+  memcpy(msg, test_data + 200, len);
+  msg[0] = ICMP6_ECHO_REQUEST;
+  msg[1] = 0;
+
+  memset(uip_buf, 0, UIP_IPH_LEN);
+  UIP_IP_BUF->vtc = 0x60;
+  UIP_IP_BUF->proto = UIP_PROTO_ICMP6;
+  UIP_IP_BUF->ttl = 64;
+  uip_ip6addr(&UIP_IP_BUF->srcipaddr, 0xfe80, 0, 0, 0, 0, 0, 0, 0x1234);
+  uip_ipaddr_copy(&UIP_IP_BUF->destipaddr, &lladdr->ipaddr);
+  uipbuf_set_len_field(UIP_IP_BUF, len);
+  uip_ext_len = 0;
+  uip_len = UIP_IPH_LEN + len;
+  uip_copy_chksum(UIP_IPH_LEN, msg, len);
+
+  uip_input();
+
+  UNIT_TEST_ASSERT(uip_len == UIP_IPH_LEN + len);
+  UNIT_TEST_ASSERT(UIP_ICMP_BUF->type == ICMP6_ECHO_REPLY);
+  UNIT_TEST_ASSERT(memcmp(&uip_buf[UIP_IPH_LEN + UIP_ICMPH_LEN],
+                          msg + UIP_ICMPH_LEN, len - UIP_ICMPH_LEN) == 0);
+  /* A message with a correct checksum sums to 0xffff */
+  UNIT_TEST_ASSERT(icmp6_ref() == 0xffff);
+  uipbuf_clear();
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(chksum_benchmark, "Checksum cost per byte");
+UNIT_TEST(chksum_benchmark)
+{
+  static const int lens[] = { 64, 256, 1024 };
+  static uint8_t appbuf[UIP_BUFSIZE];
+  uint64_t start, cycles;
+  double bytes_ns, words_ns, bytes_cpb, words_cpb, copy_ns, fused_ns;
+  int i, k, rounds;
+
+  UNIT_TEST_BEGIN();
+
+  memcpy(appbuf, test_data, sizeof(appbuf));
+  printf("len  byte-pair ns/B (cyc/B)  word ns/B (cyc/B)  "
+         "memcpy+sum ns/B  copy+sum ns/B\n");
+  for(k = 0; k < sizeof(lens) / sizeof(lens[0]); k++) {
+    rounds = TEST_BYTES / lens[k];
+
+    start = now_ns();
+    cycles = now_cycles();
+    for(i = 0; i < rounds; i++) {
+      sink = sum_bytes(0, appbuf, lens[k]);
+    }
+    bytes_cpb = (double)(now_cycles() - cycles) / TEST_BYTES;
+    bytes_ns = (double)(now_ns() - start) / TEST_BYTES;
+
+    start = now_ns();
+    cycles = now_cycles();
+    for(i = 0; i < rounds; i++) {
+      sink = uip_chksum((uint16_t *)appbuf, lens[k]);
+    }
+    words_cpb = (double)(now_cycles() - cycles) / TEST_BYTES;
+    words_ns = (double)(now_ns() - start) / TEST_BYTES;
+
+    /* Copying a payload into uip_buf and summing it afterwards */
+    start = now_ns();
+    for(i = 0; i < rounds; i++) {
+      memcpy(&uip_buf[UIP_IPUDPH_LEN], appbuf, lens[k]);
+      sink = uip_chksum((uint16_t *)&uip_buf[UIP_IPUDPH_LEN], lens[k]);
+    }
+    copy_ns = (double)(now_ns() - start) / TEST_BYTES;
+
+    start = now_ns();
+    for(i = 0; i < rounds; i++) {
+      uip_copy_chksum(UIP_IPUDPH_LEN, appbuf, lens[k]);
+    }
+    fused_ns = (double)(now_ns() - start) / TEST_BYTES;
+    uip_forget_chksum();
+
+    printf("%4d  %9.3f (%5.2f)  %11.3f (%5.2f)  %15.3f  %13.3f\n", lens[k],
+           bytes_ns, bytes_cpb, words_ns, words_cpb, copy_ns, fused_ns);
+  }
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_uip_chksum_process, ev, data)
+{
+  int i;
+
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  for(i = 0; i < sizeof(test_data); i++) {
+    test_data[i] = i * 7 + (i >> 8) * 13;
+  }
+
+  UNIT_TEST_RUN(chksum);
+  UNIT_TEST_RUN(copy_chksum);
+  UNIT_TEST_RUN(echo_reply);
+  UNIT_TEST_RUN(chksum_benchmark);
+
+  if(!UNIT_TEST_PASSED(chksum) ||
+     !UNIT_TEST_PASSED(copy_chksum) ||
+     !UNIT_TEST_PASSED(echo_reply) ||
+     !UNIT_TEST_PASSED(chksum_benchmark)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*****************************************************************************/
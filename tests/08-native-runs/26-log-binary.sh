@@ -0,0 +1,3 @@
+#!/bin/bash -e
+
+./run-one.sh 26-log-binary
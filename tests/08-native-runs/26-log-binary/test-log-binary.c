@@ -0,0 +1,290 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Tests and benchmark for deferred binary logging.
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "contiki.h"
+#include "net/ipv6/uip.h"
+#include "net/ipv6/uiplib.h"
+#include "unit-test/unit-test.h"
+
+#include "sys/log.h"
+#define LOG_MODULE "Test"
+#define LOG_LEVEL LOG_LEVEL_INFO
+/*****************************************************************************/
+/* Logs per benchmark and logs between two flushes */
+#define BENCH_LOGS 1000000
+#define BENCH_CHUNK 16
+
+#define TEST_FORMAT "d %d u %u x %04x ld %ld lu %lu lld %lld zu %zu c %c " \
+                    "%% p %p f %.3f s %s %.*s|%-6s|%*d|\n"
+#define TEST_ARGS(name) -42, 42u, 0xbeefu, -100000L, 100000UL, -(1LL << 40), \
+                        (size_t)123, 'z', (void *)&out_len, 3.25, name, \
+                        3, "abcdef", "ab", 5, 7
+/*****************************************************************************/
+PROCESS(test_log_binary_process, "Binary log test");
+AUTOSTART_PROCESSES(&test_log_binary_process);
+
+static enum { OUTPUT_PRINT, OUTPUT_CAPTURE, OUTPUT_DISCARD } output_mode;
+static char out[4096];
+static size_t out_len;
+/*****************************************************************************/
+int
+test_output(const char *format, ...)
+{
+  va_list ap;
+  int ret = 0;
+
+  va_start(ap, format);
+  if(output_mode == OUTPUT_PRINT) {
+    ret = vprintf(format, ap);
+  } else if(output_mode == OUTPUT_CAPTURE) {
+    ret = vsnprintf(&out[out_len], sizeof(out) - out_len, format, ap);
+    if(ret > 0) {
+      out_len = MIN(out_len + ret, sizeof(out) - 1);
+    }
+  }
+  va_end(ap);
+  return ret;
+}
+/*****************************************************************************/
+/* Formats the pending logs into out */
+static void
+capture(void)
+{
+  out_len = 0;
+  out[0] = '\0';
+  output_mode = OUTPUT_CAPTURE;
+  log_binary_flush();
+  output_mode = OUTPUT_PRINT;
+}
+/*****************************************************************************/
+static uint64_t
+now_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(formats, "Conversions and prefixes");
+UNIT_TEST(formats)
+{
+  char name[16];
+  char expected[512];
+  int n;
+
+  UNIT_TEST_BEGIN();
+
+  /* The string is copied, so changing it afterwards has no effect */
+  strcpy(name, "route");
+  LOG_INFO(TEST_FORMAT, TEST_ARGS(name));
+  strcpy(name, "changed");
+  LOG_DBG("below the log level\n");
+  LOG_WARN("warning %u", 1);
+  LOG_WARN_(", continued\n");
+  LOG_PRINT("%s\n", (char *)NULL);
+  capture();
+
+  n = snprintf(expected, sizeof(expected), "[INFO: Test      ] ");
+  n += snprintf(&expected[n], sizeof(expected) - n, TEST_FORMAT,
+                TEST_ARGS("route"));
+  n += snprintf(&expected[n], sizeof(expected) - n,
+                "[WARN: Test      ] warning 1, continued\n"
+                "[PRI : Test      ] (null)\n");
+  UNIT_TEST_ASSERT(!strcmp(out, expected));
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(data, "Addresses and byte arrays");
+UNIT_TEST(data)
+{
+  uip_ipaddr_t ipaddr;
+  linkaddr_t lladdr = { { 1, 2, 3, 4, 5, 6, 7, 8 } };
+  uint8_t bytes[300];
+  char expected[1024];
+  int i, n;
+
+  UNIT_TEST_BEGIN();
+
+  uip_ip6addr(&ipaddr, 0xfd00, 0, 0, 0, 0x212, 0x4b00, 0x1234, 0x5678);
+  for(i = 0; i < sizeof(bytes); i++) {
+    bytes[i] = i;
+  }
+
+  LOG_INFO("ip ");
+  LOG_INFO_6ADDR(&ipaddr);
+  LOG_INFO_(" ll ");
+  LOG_INFO_LLADDR(&lladdr);
+  LOG_INFO_(" null ");
+  LOG_INFO_6ADDR(NULL);
+  LOG_INFO_(" ");
+  LOG_INFO_LLADDR(NULL);
+  LOG_INFO_(" bytes ");
+  /* Longer than a record */
+  LOG_INFO_BYTES(bytes, sizeof(bytes));
+  LOG_INFO_("\n");
+  capture();
+
+  n = snprintf(expected, sizeof(expected), "[INFO: Test      ] ip "
+               "fd00::212:4b00:1234:5678 ll 0102.0304.0506.0708 "
+               "null (NULL IP addr) (NULL LL addr) bytes ");
+  for(i = 0; i < sizeof(bytes); i++) {
+    n += snprintf(&expected[n], sizeof(expected) - n, "%02x", bytes[i]);
+  }
+  snprintf(&expected[n], sizeof(expected) - n, "\n");
+  UNIT_TEST_ASSERT(!strcmp(out, expected));
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(overflow, "Logs dropped when the buffer is full");
+UNIT_TEST(overflow)
+{
+  char *line;
+  unsigned i, n, next;
+  uint32_t dropped;
+
+  UNIT_TEST_BEGIN();
+
+  dropped = log_binary_dropped();
+  for(i = 0; i < LOG_BINARY_BUF_SIZE; i++) {
+    LOG_INFO("%u\n", i);
+  }
+  UNIT_TEST_ASSERT(log_binary_dropped() > dropped);
+  capture();
+
+  /* The drop is reported, then the logs that fit come in order */
+  UNIT_TEST_ASSERT(!strncmp(out, "[WARN: Log       ] ", 19));
+  line = strchr(out, '\n') + 1;
+  for(next = 0; *line != '\0'; next++) {
+    UNIT_TEST_ASSERT(sscanf(line, "[INFO: Test      ] %u", &n) == 1);
+    UNIT_TEST_ASSERT(n == next);
+    line = strchr(line, '\n') + 1;
+  }
+  UNIT_TEST_ASSERT(next + log_binary_dropped() - dropped == LOG_BINARY_BUF_SIZE);
+
+  /* Logging works again once the buffer is drained */
+  LOG_INFO("after\n");
+  capture();
+  UNIT_TEST_ASSERT(!strcmp(out, "[INFO: Test      ] after\n"));
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(benchmark, "Cost of a log where it happens");
+UNIT_TEST(benchmark)
+{
+  static char text[128];
+  uip_ipaddr_t ipaddr;
+  uint64_t t, record_ns, drain_ns, text_ns;
+  uint32_t dropped;
+  int i, j, n;
+
+  UNIT_TEST_BEGIN();
+
+  dropped = log_binary_dropped();
+  uip_ip6addr(&ipaddr, 0xfd00, 0, 0, 0, 0x212, 0x4b00, 0x1234, 0x5678);
+
+  /* The route lookup logs of uip-ds6-route.c */
+  record_ns = drain_ns = 0;
+  output_mode = OUTPUT_DISCARD;
+  for(i = 0; i < BENCH_LOGS; i += BENCH_CHUNK) {
+    t = now_ns();
+    for(j = 0; j < BENCH_CHUNK; j++) {
+      LOG_INFO("Looking up route for ");
+      LOG_INFO_6ADDR(&ipaddr);
+      LOG_INFO_("\n");
+    }
+    record_ns += now_ns() - t;
+    t = now_ns();
+    log_binary_flush();
+    drain_ns += now_ns() - t;
+  }
+  output_mode = OUTPUT_PRINT;
+
+  /* Formatting the same text, as without binary logging, but leaving
+     out the output itself */
+  t = now_ns();
+  for(i = 0; i < BENCH_LOGS; i++) {
+    n = snprintf(text, sizeof(text), "[%-4s: %-10s] ", "INFO", LOG_MODULE);
+    n += snprintf(&text[n], sizeof(text) - n, "Looking up route for ");
+    n += uiplib_ipaddr_snprint(&text[n], sizeof(text) - n, &ipaddr);
+    snprintf(&text[n], sizeof(text) - n, "\n");
+  }
+  text_ns = now_ns() - t;
+
+  printf("BENCH: recording %.1f ns/log, formatting later %.1f ns/log, "
+         "formatting in place %.1f ns/log\n",
+         (double)record_ns / BENCH_LOGS, (double)drain_ns / BENCH_LOGS,
+         (double)text_ns / BENCH_LOGS);
+  UNIT_TEST_ASSERT(log_binary_dropped() == dropped);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_log_binary_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  /* Print the logs of the startup first */
+  log_binary_flush();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(formats);
+  UNIT_TEST_RUN(data);
+  UNIT_TEST_RUN(overflow);
+  UNIT_TEST_RUN(benchmark);
+
+  if(!UNIT_TEST_PASSED(formats) ||
+     !UNIT_TEST_PASSED(data) ||
+     !UNIT_TEST_PASSED(overflow) ||
+     !UNIT_TEST_PASSED(benchmark)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*****************************************************************************/
@@ -0,0 +1,389 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Tests of the CSMA neighbor queues and their transmission order,
+ *      using a radio driver that acknowledges all unicast frames.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "contiki.h"
+#include "net/netstack.h"
+#include "net/packetbuf.h"
+#include "net/mac/csma/csma.h"
+#include "net/mac/csma/csma-output.h"
+#include "unit-test/unit-test.h"
+/*****************************************************************************/
+/* Number of lookups per neighbor in the benchmark. */
+#define TEST_LOOKUPS 20000
+
+/* Neighbors used by the fairness test. */
+#define BUSY_NEIGHBOR 1
+#define QUIET_NEIGHBOR_1 2
+#define QUIET_NEIGHBOR_2 3
+
+#define CAPPED_NEIGHBOR 10
+#define CAPPED_PACKETS 100
+/*****************************************************************************/
+PROCESS(test_csma_process, "CSMA queue test process");
+AUTOSTART_PROCESSES(&test_csma_process);
+
+/* The receivers of the transmitted frames, in order. */
+static uint8_t tx_order[64];
+static unsigned tx_count;
+
+static unsigned sent_count;
+static unsigned dropped_count;
+
+static uint8_t prepared_dsn;
+static int ack_pending;
+/*****************************************************************************/
+static int
+radio_init(void)
+{
+  return 1;
+}
+/*****************************************************************************/
+static int
+radio_prepare(const void *payload, unsigned short payload_len)
+{
+  prepared_dsn = ((const uint8_t *)payload)[2];
+  return 0;
+}
+/*****************************************************************************/
+static int
+radio_transmit(unsigned short transmit_len)
+{
+  if(tx_count < sizeof(tx_order)) {
+    tx_order[tx_count] =
+      packetbuf_addr(PACKETBUF_ADDR_RECEIVER)->u8[LINKADDR_SIZE - 1];
+  }
+  tx_count++;
+  ack_pending = !packetbuf_holds_broadcast();
+  return RADIO_TX_OK;
+}
+/*****************************************************************************/
+static int
+radio_send(const void *payload, unsigned short payload_len)
+{
+  radio_prepare(payload, payload_len);
+  return radio_transmit(payload_len);
+}
+/*****************************************************************************/
+static int
+radio_read(void *buf, unsigned short buf_len)
+{
+  uint8_t *ack = buf;
+
+  if(!ack_pending || buf_len < CSMA_ACK_LEN) {
+    return 0;
+  }
+  ack_pending = 0;
+  ack[0] = FRAME802154_ACKFRAME;
+  ack[1] = 0;
+  ack[2] = prepared_dsn;
+  return CSMA_ACK_LEN;
+}
+/*****************************************************************************/
+static int
+radio_channel_clear(void)
+{
+  return 1;
+}
+/*****************************************************************************/
+static int
+radio_receiving_packet(void)
+{
+  return 0;
+}
+/*****************************************************************************/
+static int
+radio_pending_packet(void)
+{
+  return ack_pending;
+}
+/*****************************************************************************/
+static int
+radio_on(void)
+{
+  return 1;
+}
+/*****************************************************************************/
+static int
+radio_off(void)
+{
+  return 1;
+}
+/*****************************************************************************/
+static radio_result_t
+radio_get_value(radio_param_t param, radio_value_t *value)
+{
+  if(param == RADIO_CONST_MAX_PAYLOAD_LEN) {
+    *value = 125;
+    return RADIO_RESULT_OK;
+  }
+  return RADIO_RESULT_NOT_SUPPORTED;
+}
+/*****************************************************************************/
+static radio_result_t
+radio_set_value(radio_param_t param, radio_value_t value)
+{
+  return RADIO_RESULT_NOT_SUPPORTED;
+}
+/*****************************************************************************/
+static radio_result_t
+radio_get_object(radio_param_t param, void *dest, size_t size)
+{
+  return RADIO_RESULT_NOT_SUPPORTED;
+}
+/*****************************************************************************/
+static radio_result_t
+radio_set_object(radio_param_t param, const void *src, size_t size)
+{
+  return RADIO_RESULT_NOT_SUPPORTED;
+}
+/*****************************************************************************/
+const struct radio_driver test_radio_driver = {
+  radio_init,
+  radio_prepare,
+  radio_transmit,
+  radio_send,
+  radio_read,
+  radio_channel_clear,
+  radio_receiving_packet,
+  radio_pending_packet,
+  radio_on,
+  radio_off,
+  radio_get_value,
+  radio_set_value,
+  radio_get_object,
+  radio_set_object
+};
+/*****************************************************************************/
+static void
+make_lladdr(linkaddr_t *lladdr, unsigned id)
+{
+  memset(lladdr, 0, sizeof(*lladdr));
+  lladdr->u8[0] = 0x02;
+  lladdr->u8[LINKADDR_SIZE - 1] = id;
+}
+/*****************************************************************************/
+static void
+packet_sent(void *ptr, int status, int transmissions)
+{
+  if(status == MAC_TX_OK) {
+    sent_count++;
+  } else {
+    dropped_count++;
+  }
+}
+/*****************************************************************************/
+static void
+send_to(unsigned id)
+{
+  static uint8_t payload[100];
+  linkaddr_t addr;
+
+  make_lladdr(&addr, id);
+  packetbuf_clear();
+  packetbuf_copyfrom(payload, sizeof(payload));
+  packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, &addr);
+  NETSTACK_MAC.send(packet_sent, NULL);
+}
+/*****************************************************************************/
+static uint64_t
+now_ns(void)
+{
+  struct timeval tv;
+
+  gettimeofday(&tv, NULL);
+  return (uint64_t)tv.tv_sec * 1000000000 + (uint64_t)tv.tv_usec * 1000;
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(fairness, "Round robin between neighbors");
+UNIT_TEST(fairness)
+{
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(sent_count == 12);
+  UNIT_TEST_ASSERT(dropped_count == 0);
+
+  printf("Transmission order:");
+  for(unsigned i = 0; i < tx_count; i++) {
+    printf(" %u", tx_order[i]);
+  }
+  printf("\n");
+
+#if CSMA_CONF_WITH_DRR
+  /* The neighbors with few packets are served in the first rounds,
+     instead of after the busy neighbor. */
+  static const uint8_t expected[] = {
+    BUSY_NEIGHBOR, QUIET_NEIGHBOR_1, QUIET_NEIGHBOR_2,
+    BUSY_NEIGHBOR, QUIET_NEIGHBOR_1, QUIET_NEIGHBOR_2
+  };
+  UNIT_TEST_ASSERT(memcmp(tx_order, expected, sizeof(expected)) == 0);
+#endif /* CSMA_CONF_WITH_DRR */
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(queue_cap, "Queue depth cap and drop counters");
+UNIT_TEST(queue_cap)
+{
+  struct csma_output_stats stats;
+  linkaddr_t addr;
+  uint8_t queued;
+  uint16_t dropped;
+
+  UNIT_TEST_BEGIN();
+
+  for(unsigned i = 0; i < CAPPED_PACKETS; i++) {
+    send_to(CAPPED_NEIGHBOR);
+  }
+
+  make_lladdr(&addr, CAPPED_NEIGHBOR);
+  UNIT_TEST_ASSERT(csma_output_neighbor_stats(&addr, &queued, &dropped));
+  printf("Queued %u packets, dropped %u\n", queued, dropped);
+  UNIT_TEST_ASSERT(queued + dropped == CAPPED_PACKETS);
+  UNIT_TEST_ASSERT(dropped_count == dropped);
+
+  csma_output_get_stats(&stats);
+  UNIT_TEST_ASSERT(stats.dropped_queue_full + stats.dropped_no_buffer ==
+                   dropped);
+#if CSMA_CONF_WITH_DRR
+  /* Some packet buffers are left for the other neighbors. The packets
+     beyond the neighbor's share are dropped for lack of buffers. */
+  UNIT_TEST_ASSERT(queued < QUEUEBUF_CONF_NUM);
+  UNIT_TEST_ASSERT(stats.dropped_no_buffer == dropped);
+  UNIT_TEST_ASSERT(stats.dropped_queue_full == 0);
+#endif /* CSMA_CONF_WITH_DRR */
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(lookup, "Neighbor queue lookup");
+UNIT_TEST(lookup)
+{
+  struct csma_output_stats stats;
+  linkaddr_t addr;
+  uint8_t queued;
+  uint16_t dropped;
+  unsigned found = 0;
+
+  UNIT_TEST_BEGIN();
+
+  /* Queue one packet for each of the neighbors that fit, and one for
+     a neighbor that does not. */
+  for(unsigned i = 0; i <= CSMA_CONF_MAX_NEIGHBOR_QUEUES; i++) {
+    send_to(100 + i);
+  }
+  csma_output_get_stats(&stats);
+  UNIT_TEST_ASSERT(stats.dropped_no_neighbor == 1);
+
+  for(unsigned i = 0; i < CSMA_CONF_MAX_NEIGHBOR_QUEUES; i++) {
+    make_lladdr(&addr, 100 + i);
+    UNIT_TEST_ASSERT(csma_output_neighbor_stats(&addr, &queued, &dropped));
+    UNIT_TEST_ASSERT(queued == 1);
+  }
+  make_lladdr(&addr, 100 + CSMA_CONF_MAX_NEIGHBOR_QUEUES);
+  UNIT_TEST_ASSERT(!csma_output_neighbor_stats(&addr, &queued, &dropped));
+
+  uint64_t start = now_ns();
+  for(unsigned n = 0; n < TEST_LOOKUPS; n++) {
+    for(unsigned i = 0; i < CSMA_CONF_MAX_NEIGHBOR_QUEUES; i++) {
+      make_lladdr(&addr, 100 + i);
+      found += csma_output_neighbor_stats(&addr, &queued, &dropped);
+    }
+  }
+  uint64_t elapsed = now_ns() - start;
+  UNIT_TEST_ASSERT(found == TEST_LOOKUPS * CSMA_CONF_MAX_NEIGHBOR_QUEUES);
+
+  printf("%u neighbor queues: %lu ns per lookup\n",
+         CSMA_CONF_MAX_NEIGHBOR_QUEUES,
+         (unsigned long)(elapsed / found));
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_csma_process, ev, data)
+{
+  static struct etimer et;
+  static unsigned expected_count;
+
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  /* A busy neighbor queues its packets before two quiet ones. */
+  for(unsigned i = 0; i < 8; i++) {
+    send_to(BUSY_NEIGHBOR);
+  }
+  for(unsigned i = 0; i < 2; i++) {
+    send_to(QUIET_NEIGHBOR_1);
+    send_to(QUIET_NEIGHBOR_2);
+  }
+  expected_count = 12;
+  while(sent_count + dropped_count < expected_count) {
+    etimer_set(&et, 1);
+    PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+  }
+  UNIT_TEST_RUN(fairness);
+
+  expected_count = sent_count + dropped_count + CAPPED_PACKETS;
+  UNIT_TEST_RUN(queue_cap);
+  while(sent_count + dropped_count < expected_count) {
+    etimer_set(&et, 1);
+    PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+  }
+
+  expected_count = sent_count + dropped_count +
+    CSMA_CONF_MAX_NEIGHBOR_QUEUES + 1;
+  UNIT_TEST_RUN(lookup);
+  while(sent_count + dropped_count < expected_count) {
+    etimer_set(&et, 1);
+    PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+  }
+
+  if(!UNIT_TEST_PASSED(fairness) ||
+     !UNIT_TEST_PASSED(queue_cap) ||
+     !UNIT_TEST_PASSED(lookup)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
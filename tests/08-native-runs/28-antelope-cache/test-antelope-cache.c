@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Tests of the Antelope tuple page cache, which also report the
+ *      number of file system calls made by inserts and scans.
+ */
+
+#include <stdio.h>
+
+#include "contiki.h"
+#include "cfs/cfs-coffee.h"
+#include "antelope.h"
+#include "storage.h"
+#include "unit-test/unit-test.h"
+/*****************************************************************************/
+/* Number of rows inserted into the test relation. */
+#define TEST_ROWS 500
+
+/* Rows removed by the remove test. */
+#define REMOVED_ROWS 10
+/*****************************************************************************/
+PROCESS(test_antelope_process, "Antelope cache test process");
+AUTOSTART_PROCESSES(&test_antelope_process);
+/*****************************************************************************/
+static db_handle_t handle;
+/*****************************************************************************/
+static void
+print_stats(const char *operation)
+{
+  storage_stats_t stats;
+
+  storage_get_stats(&stats);
+  printf("%s: %lu opens, %lu reads, %lu writes, %lu seeks\n", operation,
+         stats.opens, stats.reads, stats.writes, stats.seeks);
+}
+/*****************************************************************************/
+/* Runs a query to the end and returns the number of rows, or -1 if
+   the rows are not the consecutive rows starting at first_id. */
+static long
+run_query(const char *query, int first_id)
+{
+  attribute_value_t value;
+  db_result_t result;
+  long rows;
+
+  if(DB_ERROR(db_query(&handle, query))) {
+    return -1;
+  }
+
+  rows = 0;
+  while(db_processing(&handle)) {
+    result = db_process(&handle);
+    if(result == DB_GOT_ROW) {
+      if(DB_ERROR(db_get_value(&value, &handle, 0)) ||
+         VALUE_INT(&value) != first_id + rows ||
+         DB_ERROR(db_get_value(&value, &handle, 1)) ||
+         VALUE_LONG(&value) != (first_id + rows) * 1000L) {
+        rows = -1;
+        break;
+      }
+      rows++;
+    } else if(result != DB_OK) {
+      if(result != DB_FINISHED) {
+        rows = -1;
+      }
+      break;
+    }
+  }
+
+  db_free(&handle);
+  return rows;
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(test_insert, "Insert rows");
+UNIT_TEST(test_insert)
+{
+  relation_t *rel;
+  attribute_value_t values[2];
+  unsigned char row[6];
+  tuple_id_t tuple_id;
+  tuple_id_t amount;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(db_query(NULL, "CREATE RELATION r;") == DB_OK);
+  UNIT_TEST_ASSERT(db_query(NULL,
+                            "CREATE ATTRIBUTE id DOMAIN INT IN r;") == DB_OK);
+  UNIT_TEST_ASSERT(db_query(NULL,
+                            "CREATE ATTRIBUTE val DOMAIN LONG IN r;") == DB_OK);
+
+  rel = relation_load("r");
+  UNIT_TEST_ASSERT(rel != NULL);
+  UNIT_TEST_ASSERT(rel->row_length == sizeof(row));
+
+  storage_reset_stats();
+
+  for(i = 0; i < TEST_ROWS; i++) {
+    values[0].domain = DOMAIN_INT;
+    VALUE_INT(&values[0]) = i;
+    values[1].domain = DOMAIN_LONG;
+    VALUE_LONG(&values[1]) = i * 1000L;
+    UNIT_TEST_ASSERT(relation_insert(rel, values) == DB_OK);
+
+    /* The appended rows must be visible before they are written back. */
+    UNIT_TEST_ASSERT(storage_get_row_amount(rel, &amount) == DB_OK);
+    UNIT_TEST_ASSERT(amount == i + 1);
+  }
+
+  print_stats("Insert");
+
+  /* Read a row in the middle of the relation while it is loaded. */
+  tuple_id = TEST_ROWS / 2;
+  UNIT_TEST_ASSERT(storage_get_row(rel, &tuple_id, row) == DB_OK);
+  UNIT_TEST_ASSERT(((row[0] << 8) | row[1]) == TEST_ROWS / 2);
+
+  tuple_id = TEST_ROWS;
+  UNIT_TEST_ASSERT(storage_get_row(rel, &tuple_id, row) == DB_FINISHED);
+
+  UNIT_TEST_ASSERT(relation_release(rel) == DB_OK);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(test_scan, "Scan rows");
+UNIT_TEST(test_scan)
+{
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(run_query("SELECT id, val FROM r;", 0) == TEST_ROWS);
+  print_stats("Scan");
+
+  UNIT_TEST_ASSERT(run_query("SELECT id, val FROM r "
+                             "WHERE id >= 100 AND id < 200;", 100) == 100);
+  print_stats("Select");
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(test_remove, "Remove rows");
+UNIT_TEST(test_remove)
+{
+  UNIT_TEST_BEGIN();
+
+  /* The remaining rows are appended to a result relation, which then
+     replaces the original relation. */
+  UNIT_TEST_ASSERT(run_query("REMOVE FROM r WHERE id < 10;", REMOVED_ROWS) ==
+                   TEST_ROWS - REMOVED_ROWS);
+  print_stats("Remove");
+
+  UNIT_TEST_ASSERT(run_query("SELECT id, val FROM r;", REMOVED_ROWS) ==
+                   TEST_ROWS - REMOVED_ROWS);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_antelope_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  cfs_coffee_format();
+  db_init();
+
+  UNIT_TEST_RUN(test_insert);
+  UNIT_TEST_RUN(test_scan);
+  UNIT_TEST_RUN(test_remove);
+
+  if(!UNIT_TEST_PASSED(test_insert) ||
+     !UNIT_TEST_PASSED(test_scan) ||
+     !UNIT_TEST_PASSED(test_remove)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*****************************************************************************/
@@ -0,0 +1,251 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Tests of batched inserts into Antelope relations, with a
+ *      benchmark that compares them to inserts of single rows.
+ */
+
+#include <stdio.h>
+#include <sys/time.h>
+
+#include "contiki.h"
+#include "cfs/cfs-coffee.h"
+#include "antelope.h"
+#include "storage.h"
+#include "unit-test/unit-test.h"
+/*****************************************************************************/
+/* Number of rows inserted by the benchmark. */
+#define TEST_ROWS 10000
+
+/* Number of rows passed to each relation_insert_batch() call. */
+#define TEST_BATCH 100
+/*****************************************************************************/
+PROCESS(test_antelope_process, "Antelope bulk insert test process");
+AUTOSTART_PROCESSES(&test_antelope_process);
+/*****************************************************************************/
+static db_handle_t handle;
+static attribute_value_t values[TEST_BATCH * 2];
+/*****************************************************************************/
+static unsigned long
+time_us(void)
+{
+  struct timeval tv;
+
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec * 1000000UL + tv.tv_usec;
+}
+/*****************************************************************************/
+static int
+create_relation(const char *name)
+{
+  return db_query(NULL, "CREATE RELATION %s;", name) == DB_OK &&
+         db_query(NULL, "CREATE ATTRIBUTE id DOMAIN INT IN %s;", name) ==
+         DB_OK &&
+         db_query(NULL, "CREATE ATTRIBUTE val DOMAIN LONG IN %s;", name) ==
+         DB_OK &&
+         db_query(NULL, "CREATE INDEX %s.id TYPE MAXHEAP;", name) == DB_OK;
+}
+/*****************************************************************************/
+static void
+set_row(attribute_value_t *row, int id)
+{
+  row[0].domain = DOMAIN_INT;
+  VALUE_INT(&row[0]) = id;
+  row[1].domain = DOMAIN_LONG;
+  VALUE_LONG(&row[1]) = id * 1000L;
+}
+/*****************************************************************************/
+static void
+print_result(const char *method, unsigned long us)
+{
+  storage_stats_t stats;
+
+  storage_get_stats(&stats);
+  printf("%s: %d rows in %lu us, %lu reads, %lu writes, %lu seeks\n",
+         method, TEST_ROWS, us, stats.reads, stats.writes, stats.seeks);
+}
+/*****************************************************************************/
+/* Runs a query to the end and returns the number of rows, or -1 if
+   the rows are not the consecutive rows starting at first_id. */
+static long
+run_query(const char *query, int first_id)
+{
+  attribute_value_t value;
+  db_result_t result;
+  long rows;
+
+  if(DB_ERROR(db_query(&handle, query))) {
+    return -1;
+  }
+
+  rows = 0;
+  while(db_processing(&handle)) {
+    result = db_process(&handle);
+    if(result == DB_GOT_ROW) {
+      if(DB_ERROR(db_get_value(&value, &handle, 0)) ||
+         VALUE_INT(&value) != first_id + rows ||
+         DB_ERROR(db_get_value(&value, &handle, 1)) ||
+         VALUE_LONG(&value) != (first_id + rows) * 1000L) {
+        rows = -1;
+        break;
+      }
+      rows++;
+    } else if(result != DB_OK) {
+      if(result != DB_FINISHED) {
+        rows = -1;
+      }
+      break;
+    }
+  }
+
+  db_free(&handle);
+  return rows;
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(test_insert_bench, "Insert benchmark");
+UNIT_TEST(test_insert_bench)
+{
+  relation_t *rel;
+  unsigned long start;
+  int i, j;
+
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(create_relation("single"));
+  UNIT_TEST_ASSERT(create_relation("batch"));
+
+  rel = relation_load("single");
+  UNIT_TEST_ASSERT(rel != NULL);
+
+  storage_reset_stats();
+  start = time_us();
+  for(i = 0; i < TEST_ROWS; i++) {
+    set_row(values, i);
+    UNIT_TEST_ASSERT(relation_insert(rel, values) == DB_OK);
+  }
+  print_result("Single", time_us() - start);
+
+  UNIT_TEST_ASSERT(relation_release(rel) == DB_OK);
+
+  rel = relation_load("batch");
+  UNIT_TEST_ASSERT(rel != NULL);
+
+  storage_reset_stats();
+  start = time_us();
+  for(i = 0; i < TEST_ROWS; i += TEST_BATCH) {
+    for(j = 0; j < TEST_BATCH; j++) {
+      set_row(&values[j * 2], i + j);
+    }
+    UNIT_TEST_ASSERT(relation_insert_batch(rel, values, TEST_BATCH) == DB_OK);
+  }
+  print_result("Batch", time_us() - start);
+
+  UNIT_TEST_ASSERT(relation_cardinality(rel) == TEST_ROWS);
+  UNIT_TEST_ASSERT(relation_release(rel) == DB_OK);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(test_batch_contents, "Batch-inserted rows");
+UNIT_TEST(test_batch_contents)
+{
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(run_query("SELECT id, val FROM batch;", 0) == TEST_ROWS);
+
+  /* A narrow range is looked up through the max-heap index. */
+  UNIT_TEST_ASSERT(run_query("SELECT id, val FROM batch "
+                             "WHERE id >= 5000 AND id < 5010;", 5000) == 10);
+  UNIT_TEST_ASSERT(run_query("SELECT id, val FROM single "
+                             "WHERE id >= 5000 AND id < 5010;", 5000) == 10);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(test_multi_row_insert, "Multi-row INSERT");
+UNIT_TEST(test_multi_row_insert)
+{
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(db_query(NULL, "CREATE RELATION multi;") == DB_OK);
+  UNIT_TEST_ASSERT(db_query(NULL,
+                            "CREATE ATTRIBUTE id DOMAIN INT IN multi;") ==
+                   DB_OK);
+  UNIT_TEST_ASSERT(db_query(NULL,
+                            "CREATE ATTRIBUTE val DOMAIN LONG IN multi;") ==
+                   DB_OK);
+
+  UNIT_TEST_ASSERT(db_query(NULL, "INSERT (0, 0) INTO multi;") == DB_OK);
+  UNIT_TEST_ASSERT(db_query(NULL, "INSERT (1, 1000), (2, 2000), (3, 3000) "
+                            "INTO multi;") == DB_OK);
+
+  /* Rows of different lengths, and rows beyond the value limit. */
+  UNIT_TEST_ASSERT(db_query(NULL, "INSERT (4, 4000), (5) INTO multi;") ==
+                   DB_PARSING_ERROR);
+  UNIT_TEST_ASSERT(db_query(NULL, "INSERT (4, 4000), (5, 5000), (6, 6000), "
+                            "(7, 7000), (8, 8000) INTO multi;") ==
+                   DB_PARSING_ERROR);
+  /* Rows that do not match the attributes of the relation. */
+  UNIT_TEST_ASSERT(db_query(NULL, "INSERT (4), (5) INTO multi;") ==
+                   DB_RELATIONAL_ERROR);
+
+  UNIT_TEST_ASSERT(run_query("SELECT id, val FROM multi;", 0) == 4);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_antelope_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  cfs_coffee_format();
+  db_init();
+
+  UNIT_TEST_RUN(test_insert_bench);
+  UNIT_TEST_RUN(test_batch_contents);
+  UNIT_TEST_RUN(test_multi_row_insert);
+
+  if(!UNIT_TEST_PASSED(test_insert_bench) ||
+     !UNIT_TEST_PASSED(test_batch_contents) ||
+     !UNIT_TEST_PASSED(test_multi_row_insert)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*****************************************************************************/
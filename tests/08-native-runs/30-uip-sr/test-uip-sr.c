@@ -0,0 +1,318 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Tests of the source routing graph at the root, with the node
+ *      hash index and the path length cache.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "contiki.h"
+#include "lib/random.h"
+#include "net/ipv6/uip.h"
+#include "net/ipv6/uip-sr.h"
+#include "net/routing/routing.h"
+#include "unit-test/unit-test.h"
+/*****************************************************************************/
+/* Nodes of the random graph, besides the root */
+#define TEST_NODES 48
+
+/* Parent changes in the random graph */
+#define TEST_UPDATES 2000
+
+#define TEST_LIFETIME 3600
+
+/* Identifiers of the nodes of the fixed graph */
+#define NODE_A 0x101
+#define NODE_B 0x102
+#define NODE_C 0x103
+#define NODE_D 0x104
+#define NODE_E 0x105
+#define NODE_F 0x106
+#define NODE_G 0x107
+#define NODE_UNKNOWN 0x1ff
+/*****************************************************************************/
+PROCESS(test_uip_sr_process, "uIP source routing test");
+AUTOSTART_PROCESSES(&test_uip_sr_process);
+
+static uip_ipaddr_t root_addr;
+/*****************************************************************************/
+static uint64_t
+now_ns(void)
+{
+  struct timeval tv;
+
+  gettimeofday(&tv, NULL);
+  return (uint64_t)tv.tv_sec * 1000000000 + (uint64_t)tv.tv_usec * 1000;
+}
+/*****************************************************************************/
+/* The address of a node, in the prefix of the DAG */
+static uip_ipaddr_t *
+node_addr(uint16_t id)
+{
+  static uip_ipaddr_t addr;
+
+  memcpy(&addr, &root_addr, 8);
+  memset(((uint8_t *)&addr) + 8, 0, 8);
+  addr.u8[8] = 0x02;
+  addr.u8[14] = id >> 8;
+  addr.u8[15] = id & 0xff;
+  return &addr;
+}
+/*****************************************************************************/
+static uip_sr_node_t *
+update(uint16_t child, uint16_t parent)
+{
+  uip_ipaddr_t parent_addr;
+
+  if(parent == 0) {
+    uip_ipaddr_copy(&parent_addr, &root_addr);
+  } else {
+    uip_ipaddr_copy(&parent_addr, node_addr(parent));
+  }
+  return uip_sr_update_node(NULL, node_addr(child), &parent_addr,
+                            TEST_LIFETIME);
+}
+/*****************************************************************************/
+static uip_sr_node_t *
+get(uint16_t id)
+{
+  return uip_sr_get_node(NULL, id == 0 ? &root_addr : node_addr(id));
+}
+/*****************************************************************************/
+/* Number of hops to the root, walking the parents every time */
+static int
+walk_length(const uip_sr_node_t *node, const uip_sr_node_t *root_node)
+{
+  int len;
+
+  for(len = 0; node != NULL && node != root_node && len <= UIP_SR_LINK_NUM;
+      len++) {
+    node = node->parent;
+  }
+  return node != NULL && node == root_node ? len : -1;
+}
+/*****************************************************************************/
+/* The number of hops to the root of a node, from its identifier */
+static int
+length(uint16_t id)
+{
+  return uip_sr_path_length(get(id), get(0));
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(lookup, "Node lookup");
+UNIT_TEST(lookup)
+{
+  uip_sr_node_t *node;
+  uip_ipaddr_t addr;
+  uint16_t id;
+
+  UNIT_TEST_BEGIN();
+
+  /* Root <- A <- B <- C, root <- D */
+  UNIT_TEST_ASSERT(update(NODE_A, 0) != NULL);
+  UNIT_TEST_ASSERT(update(NODE_B, NODE_A) != NULL);
+  UNIT_TEST_ASSERT(update(NODE_C, NODE_B) != NULL);
+  UNIT_TEST_ASSERT(update(NODE_D, 0) != NULL);
+  UNIT_TEST_ASSERT(uip_sr_num_nodes() == 5);
+
+  for(id = NODE_A; id <= NODE_D; id++) {
+    node = get(id);
+    UNIT_TEST_ASSERT(node != NULL);
+    UNIT_TEST_ASSERT(memcmp(node->link_identifier,
+                            ((uint8_t *)node_addr(id)) + 8, 8) == 0);
+  }
+  UNIT_TEST_ASSERT(get(NODE_B)->parent == get(NODE_A));
+  UNIT_TEST_ASSERT(get(0) != NULL && get(0)->parent == NULL);
+  UNIT_TEST_ASSERT(get(NODE_UNKNOWN) == NULL);
+
+  /* Same link identifier in another prefix */
+  node_addr(NODE_A)->u8[0] ^= 0x01;
+  UNIT_TEST_ASSERT(uip_sr_get_node(NULL, node_addr(NODE_A)) != NULL);
+
+  /* An expired leaf is removed, and no longer found */
+  uip_ipaddr_copy(&addr, node_addr(NODE_C));
+  uip_sr_expire_parent(NULL, &addr, node_addr(NODE_B));
+  uip_sr_periodic(UIP_SR_REMOVAL_DELAY);
+  uip_sr_periodic(1);
+  UNIT_TEST_ASSERT(get(NODE_C) == NULL);
+  UNIT_TEST_ASSERT(get(NODE_B) != NULL);
+  UNIT_TEST_ASSERT(uip_sr_num_nodes() == 4);
+  node = update(NODE_C, NODE_B);
+  UNIT_TEST_ASSERT(node != NULL && node == get(NODE_C));
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(invalidation, "Path lengths after graph changes");
+UNIT_TEST(invalidation)
+{
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(length(0) == 0);
+  UNIT_TEST_ASSERT(length(NODE_A) == 1);
+  UNIT_TEST_ASSERT(length(NODE_C) == 3);
+  UNIT_TEST_ASSERT(length(NODE_D) == 1);
+
+  /* A parent change shortens the path of the children */
+  update(NODE_B, 0);
+  UNIT_TEST_ASSERT(length(NODE_B) == 1);
+  UNIT_TEST_ASSERT(length(NODE_C) == 2);
+  update(NODE_B, NODE_D);
+  UNIT_TEST_ASSERT(length(NODE_C) == 3);
+
+  /* E hangs from an unknown F, until F gets a path */
+  update(NODE_E, NODE_F);
+  UNIT_TEST_ASSERT(length(NODE_F) == -1);
+  UNIT_TEST_ASSERT(length(NODE_E) == -1);
+  UNIT_TEST_ASSERT(!uip_sr_is_addr_reachable(NULL, node_addr(NODE_E)));
+  update(NODE_F, NODE_C);
+  UNIT_TEST_ASSERT(length(NODE_E) == 5);
+  UNIT_TEST_ASSERT(uip_sr_is_addr_reachable(NULL, node_addr(NODE_E)));
+
+  /* A parent that would make a loop is not taken */
+  update(NODE_D, NODE_E);
+  UNIT_TEST_ASSERT(get(NODE_D)->parent == get(0));
+  UNIT_TEST_ASSERT(length(NODE_E) == 5);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(srh, "Source routing header from the cached path");
+UNIT_TEST(srh)
+{
+  struct uip_routing_hdr *rh_hdr;
+  uip_ipaddr_t addr;
+
+  UNIT_TEST_BEGIN();
+
+  /* A packet from the root to E, over D, B, C and F */
+  memset(uip_buf, 0, UIP_IPUDPH_LEN);
+  UIP_IP_BUF->vtc = 0x60;
+  UIP_IP_BUF->proto = UIP_PROTO_UDP;
+  UIP_IP_BUF->ttl = 64;
+  uip_ipaddr_copy(&UIP_IP_BUF->srcipaddr, &root_addr);
+  uip_ipaddr_copy(&UIP_IP_BUF->destipaddr, node_addr(NODE_E));
+  uip_len = UIP_IPUDPH_LEN;
+  uipbuf_set_len_field(UIP_IP_BUF, uip_len - UIP_IPH_LEN);
+  uip_ext_len = 0;
+
+  UNIT_TEST_ASSERT(NETSTACK_ROUTING.ext_header_update());
+  UNIT_TEST_ASSERT(UIP_IP_BUF->proto == UIP_PROTO_ROUTING);
+  rh_hdr = (struct uip_routing_hdr *)UIP_IP_PAYLOAD(0);
+  UNIT_TEST_ASSERT(rh_hdr->seg_left == length(NODE_E) - 1);
+  uip_ipaddr_copy(&addr, node_addr(NODE_D));
+  UNIT_TEST_ASSERT(uip_ipaddr_cmp(&UIP_IP_BUF->destipaddr, &addr));
+
+  /* No header to a node without a path */
+  update(NODE_G, NODE_UNKNOWN);
+  uip_ipaddr_copy(&UIP_IP_BUF->destipaddr, node_addr(NODE_G));
+  UNIT_TEST_ASSERT(!NETSTACK_ROUTING.ext_header_update());
+  uipbuf_clear();
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(random_graph, "Cached path lengths in a random graph");
+UNIT_TEST(random_graph)
+{
+  uip_sr_node_t *root_node;
+  uip_sr_node_t *node;
+  uint64_t start;
+  unsigned long checks, mismatches;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  uip_sr_free_all();
+  for(i = 1; i <= TEST_NODES; i++) {
+    update(i, random_rand() % i);
+  }
+
+  checks = 0;
+  mismatches = 0;
+  start = now_ns();
+  for(i = 0; i < TEST_UPDATES; i++) {
+    update(1 + random_rand() % TEST_NODES, random_rand() % (TEST_NODES + 1));
+    root_node = get(0);
+    for(node = uip_sr_node_head(); node != NULL; node = uip_sr_node_next(node)) {
+      /* Twice, to get the cached length the second time */
+      mismatches += uip_sr_path_length(node, root_node) !=
+        walk_length(node, root_node);
+      mismatches += uip_sr_path_length(node, root_node) !=
+        walk_length(node, root_node);
+      checks += 2;
+    }
+  }
+  printf("%lu path lengths checked in %lu us, %lu mismatches\n", checks,
+         (unsigned long)((now_ns() - start) / 1000), mismatches);
+  UNIT_TEST_ASSERT(uip_sr_num_nodes() == TEST_NODES + 1);
+  UNIT_TEST_ASSERT(mismatches == 0);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_uip_sr_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  if(NETSTACK_ROUTING.root_start() != 0 ||
+     !NETSTACK_ROUTING.get_root_ipaddr(&root_addr)) {
+    printf("Failed to start the DAG root\n");
+    printf("=check-me= FAILED\n");
+    printf("=check-me= DONE\n");
+    PROCESS_EXIT();
+  }
+
+  UNIT_TEST_RUN(lookup);
+  UNIT_TEST_RUN(invalidation);
+  UNIT_TEST_RUN(srh);
+  UNIT_TEST_RUN(random_graph);
+
+  if(!UNIT_TEST_PASSED(lookup) ||
+     !UNIT_TEST_PASSED(invalidation) ||
+     !UNIT_TEST_PASSED(srh) ||
+     !UNIT_TEST_PASSED(random_graph)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*****************************************************************************/
@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Tests and benchmark for the poll queue of the process scheduler,
+ *      its priority levels and the per-process statistics.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "contiki.h"
+#include "unit-test/unit-test.h"
+/*****************************************************************************/
+/* Processes polled at once */
+#define TEST_WORKERS 200
+
+/* Rounds of the benchmark, each polling a single process */
+#define TEST_ROUNDS 20000
+
+/* Time that the busy worker spends in its poll handler */
+#define TEST_BUSY_TICKS (RTIMER_SECOND / 50)
+
+/* The poll priority given to each worker */
+#define PRIORITY_OF(i) ((i) % PROCESS_PRIORITY_LEVELS)
+/*****************************************************************************/
+PROCESS(test_process_poll_process, "process poll test");
+AUTOSTART_PROCESSES(&test_process_poll_process);
+
+static struct process workers[TEST_WORKERS];
+static uint16_t poll_order[TEST_WORKERS];
+static int npolled;
+static int busy_worker = -1;
+static unsigned long round_ns;
+/*****************************************************************************/
+static uint64_t
+now_ns(void)
+{
+  struct timeval tv;
+
+  gettimeofday(&tv, NULL);
+  return (uint64_t)tv.tv_sec * 1000000000 + (uint64_t)tv.tv_usec * 1000;
+}
+/*****************************************************************************/
+PROCESS_THREAD(worker, ev, data)
+{
+  rtimer_clock_t start;
+  int i;
+
+  PROCESS_BEGIN();
+
+  while(1) {
+    PROCESS_YIELD_UNTIL(ev == PROCESS_EVENT_POLL);
+    i = PROCESS_CURRENT() - workers;
+    if(npolled < TEST_WORKERS) {
+      poll_order[npolled++] = i;
+    }
+    if(i == busy_worker) {
+      start = RTIMER_NOW();
+      while((rtimer_clock_t)(RTIMER_NOW() - start) < TEST_BUSY_TICKS);
+    }
+  }
+
+  PROCESS_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(poll_order, "Poll handlers in priority order");
+UNIT_TEST(poll_order)
+{
+#if PROCESS_POLL_QUEUE
+  int i;
+#endif /* PROCESS_POLL_QUEUE */
+
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(npolled == TEST_WORKERS);
+#if PROCESS_POLL_QUEUE
+  /* By priority, then in the order the processes were polled, which
+     was from the last worker to the first */
+  for(i = 1; i < TEST_WORKERS; i++) {
+    UNIT_TEST_ASSERT(PRIORITY_OF(poll_order[i - 1]) <
+                     PRIORITY_OF(poll_order[i]) ||
+                     (PRIORITY_OF(poll_order[i - 1]) ==
+                      PRIORITY_OF(poll_order[i]) &&
+                      poll_order[i - 1] > poll_order[i]));
+  }
+#endif /* PROCESS_POLL_QUEUE */
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(poll_stats, "Scheduler and process statistics");
+UNIT_TEST(poll_stats)
+{
+  unsigned long calls;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  printf("%lu polls, at most %u queued, %lu events\n",
+         process_stats.polls, process_stats.max_polls, process_stats.events);
+  /* System processes may have been polled in the same round */
+  UNIT_TEST_ASSERT(process_stats.polls >= TEST_WORKERS);
+#if PROCESS_POLL_QUEUE
+  UNIT_TEST_ASSERT(process_stats.max_polls >= TEST_WORKERS);
+#endif /* PROCESS_POLL_QUEUE */
+
+  /* The initialization event and the poll */
+  calls = 0;
+  for(i = 0; i < TEST_WORKERS; i++) {
+    calls += workers[i].calls;
+  }
+  UNIT_TEST_ASSERT(calls == 2 * TEST_WORKERS);
+
+  printf("busy worker: %lu calls, %lu rtimer ticks\n",
+         workers[busy_worker].calls, workers[busy_worker].runtime);
+  UNIT_TEST_ASSERT(workers[busy_worker].runtime >= TEST_BUSY_TICKS);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(poll_benchmark, "Cost of polling one of many processes");
+UNIT_TEST(poll_benchmark)
+{
+  UNIT_TEST_BEGIN();
+
+  printf("%lu ns per poll round with %d processes\n", round_ns,
+         TEST_WORKERS + 1);
+  UNIT_TEST_ASSERT(round_ns > 0);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_process_poll_process, ev, data)
+{
+  static uint64_t start;
+  static int i;
+
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  for(i = 0; i < TEST_WORKERS; i++) {
+    workers[i].thread = process_thread_worker;
+#if !PROCESS_CONF_NO_PROCESS_NAMES
+    workers[i].name = "worker";
+#endif
+    process_start(&workers[i], NULL);
+    process_set_priority(&workers[i], PRIORITY_OF(i));
+  }
+
+  /* Poll all workers at once. The poll handlers run before the next
+     event is delivered. */
+  memset(&process_stats, 0, sizeof(process_stats));
+  busy_worker = TEST_WORKERS / 2;
+  for(i = TEST_WORKERS - 1; i >= 0; i--) {
+    process_poll(&workers[i]);
+  }
+  process_post(PROCESS_CURRENT(), PROCESS_EVENT_CONTINUE, NULL);
+  PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_CONTINUE);
+
+  UNIT_TEST_RUN(poll_order);
+  UNIT_TEST_RUN(poll_stats);
+
+  /* Poll one worker per round, with all the others idle */
+  busy_worker = -1;
+  start = now_ns();
+  for(i = 0; i < TEST_ROUNDS; i++) {
+    process_poll(&workers[i % TEST_WORKERS]);
+    process_post(PROCESS_CURRENT(), PROCESS_EVENT_CONTINUE, NULL);
+    PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_CONTINUE);
+  }
+  round_ns = (now_ns() - start) / TEST_ROUNDS;
+
+  UNIT_TEST_RUN(poll_benchmark);
+
+  if(!UNIT_TEST_PASSED(poll_order) ||
+     !UNIT_TEST_PASSED(poll_stats) ||
+     !UNIT_TEST_PASSED(poll_benchmark)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*****************************************************************************/
@@ -0,0 +1,258 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Tests of the event timer heap: expiry order, timers that expire
+ *      in the same tick, timers stopped or reset inside the heap, and
+ *      timers that do not fit in the heap.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "unit-test/unit-test.h"
+/*****************************************************************************/
+#define TEST_TIMERS 24
+
+/* Time unit of the timer intervals */
+#define TEST_TICK (CLOCK_SECOND / 100)
+/*****************************************************************************/
+PROCESS(test_etimer_heap_process, "etimer heap test");
+AUTOSTART_PROCESSES(&test_etimer_heap_process);
+
+static struct etimer timers[TEST_TIMERS];
+static struct etimer guard;
+static clock_time_t expiry[TEST_TIMERS];
+static clock_time_t fired_at[TEST_TIMERS];
+static uint8_t fired[TEST_TIMERS];
+static uint8_t order[TEST_TIMERS];
+static int nfired;
+static int expected;
+static int late_order;
+static clock_time_t ties_spread;
+/*****************************************************************************/
+static void
+set_timer(int i, clock_time_t interval)
+{
+  etimer_set(&timers[i], interval);
+  expiry[i] = etimer_expiration_time(&timers[i]);
+}
+/*****************************************************************************/
+static void
+start_round(int n)
+{
+  memset(fired, 0, sizeof(fired));
+  nfired = 0;
+  expected = n;
+  late_order = 0;
+}
+/*****************************************************************************/
+/* Records a fired timer. A timer may only fire after one that expires
+   later if both had expired already. */
+static void
+record(struct etimer *et)
+{
+  int i = et - timers;
+  int prev;
+
+  if(i < 0 || i >= TEST_TIMERS) {
+    return;
+  }
+  fired[i]++;
+  fired_at[i] = clock_time();
+  if(nfired > 0) {
+    prev = order[nfired - 1];
+    if((long)(expiry[i] - expiry[prev]) < 0 &&
+       (long)(fired_at[prev] - expiry[i]) < 0) {
+      late_order++;
+    }
+  }
+  if(nfired < TEST_TIMERS) {
+    order[nfired++] = i;
+  }
+}
+/*****************************************************************************/
+static int
+count_fired(void)
+{
+  int i, n;
+
+  for(i = 0, n = 0; i < TEST_TIMERS; i++) {
+    n += fired[i];
+  }
+  return n;
+}
+/*****************************************************************************/
+static int
+early(void)
+{
+  int i, n;
+
+  for(i = 0, n = 0; i < TEST_TIMERS; i++) {
+    n += fired[i] && (long)(fired_at[i] - expiry[i]) < 0;
+  }
+  return n;
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(heap_order, "Expiry order and same-tick ties");
+UNIT_TEST(heap_order)
+{
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  printf("order:");
+  for(i = 0; i < nfired; i++) {
+    printf(" %u", order[i]);
+  }
+  printf("\n");
+  UNIT_TEST_ASSERT(nfired == expected);
+  UNIT_TEST_ASSERT(count_fired() == expected);
+  UNIT_TEST_ASSERT(late_order == 0);
+  UNIT_TEST_ASSERT(early() == 0);
+  /* The timers that expire in the same tick fire together */
+  UNIT_TEST_ASSERT(ties_spread <= 1);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(heap_update, "Stopping and resetting timers in the heap");
+UNIT_TEST(heap_update)
+{
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(nfired == expected);
+  UNIT_TEST_ASSERT(fired[4] == 0);
+  UNIT_TEST_ASSERT(etimer_expired(&timers[4]));
+  UNIT_TEST_ASSERT(fired[2] == 1 && fired[5] == 1);
+  /* The reset timer fires last, the adjusted one before the others */
+  UNIT_TEST_ASSERT(order[nfired - 1] == 2);
+  UNIT_TEST_ASSERT(order[0] == 5);
+  UNIT_TEST_ASSERT(late_order == 0);
+  UNIT_TEST_ASSERT(early() == 0);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(heap_full, "Timers that do not fit in the heap");
+UNIT_TEST(heap_full)
+{
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(nfired == expected);
+  UNIT_TEST_ASSERT(fired[3] == 0 && fired[TEST_TIMERS - 1] == 0);
+  UNIT_TEST_ASSERT(count_fired() == expected);
+  UNIT_TEST_ASSERT(late_order == 0);
+  UNIT_TEST_ASSERT(early() == 0);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_etimer_heap_process, ev, data)
+{
+  static const uint8_t intervals[] = { 7, 2, 9, 4, 4, 10, 1, 4, 6, 3 };
+  static int i;
+
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  /* Out of order, with three timers expiring at the same time */
+  start_round(sizeof(intervals));
+  for(i = 0; i < sizeof(intervals); i++) {
+    set_timer(i, intervals[i] * TEST_TICK);
+  }
+  etimer_set(&guard, 20 * TEST_TICK);
+  while(nfired < expected) {
+    PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_TIMER);
+    if(data == &guard) {
+      break;
+    }
+    record(data);
+  }
+  ties_spread = MAX(MAX(fired_at[3], fired_at[4]), fired_at[7]) -
+    MIN(MIN(fired_at[3], fired_at[4]), fired_at[7]);
+  etimer_stop(&guard);
+  UNIT_TEST_RUN(heap_order);
+
+  /* Stop a timer below the root, reset one to expire last, and
+     adjust one to expire first */
+  start_round(7);
+  for(i = 0; i < 8; i++) {
+    set_timer(i, (i + 2) * TEST_TICK);
+  }
+  etimer_stop(&timers[4]);
+  set_timer(2, 12 * TEST_TICK);
+  etimer_adjust(&timers[5], -6 * TEST_TICK);
+  expiry[5] = etimer_expiration_time(&timers[5]);
+  etimer_set(&guard, 20 * TEST_TICK);
+  while(nfired < expected) {
+    PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_TIMER);
+    if(data == &guard) {
+      break;
+    }
+    record(data);
+  }
+  etimer_stop(&guard);
+  UNIT_TEST_RUN(heap_update);
+
+  /* More timers than fit in the heap, two of them stopped */
+  start_round(TEST_TIMERS - 2);
+  for(i = 0; i < TEST_TIMERS; i++) {
+    set_timer(i, ((i * 7) % TEST_TIMERS + 1) * TEST_TICK);
+  }
+  etimer_stop(&timers[3]);
+  etimer_stop(&timers[TEST_TIMERS - 1]);
+  etimer_set(&guard, (TEST_TIMERS + 10) * TEST_TICK);
+  while(nfired < expected) {
+    PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_TIMER);
+    if(data == &guard) {
+      break;
+    }
+    record(data);
+  }
+  etimer_stop(&guard);
+  UNIT_TEST_RUN(heap_full);
+
+  if(!UNIT_TEST_PASSED(heap_order) ||
+     !UNIT_TEST_PASSED(heap_update) ||
+     !UNIT_TEST_PASSED(heap_full)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*****************************************************************************/
@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Tests of the cache of expanded LLSEC key schedules in CSMA.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "net/packetbuf.h"
+#include "net/mac/csma/csma.h"
+#include "net/mac/csma/csma-security.h"
+#include "unit-test/unit-test.h"
+/*****************************************************************************/
+PROCESS(test_key_cache_process, "CSMA key cache test process");
+AUTOSTART_PROCESSES(&test_key_cache_process);
+
+static const uint8_t key_a[16] = {
+  0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+  0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f
+};
+static const uint8_t key_b[16] = {
+  0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7,
+  0xf8, 0xf9, 0xfa, 0xfb, 0xfc, 0xfd, 0xfe, 0xff
+};
+static const uint8_t payload[] = "key cache test payload";
+
+static uint8_t frame[PACKETBUF_SIZE];
+static uint16_t frame_len;
+
+static struct csma_security_key_cache_stats last_stats;
+static uint32_t hits;
+static uint32_t misses;
+static uint8_t entries;
+/*****************************************************************************/
+/* Updates hits and misses with the cache use since the previous call. */
+static void
+read_stats(void)
+{
+  struct csma_security_key_cache_stats stats;
+
+  csma_security_get_key_cache_stats(&stats);
+  hits = stats.hits - last_stats.hits;
+  misses = stats.misses - last_stats.misses;
+  entries = stats.entries;
+  last_stats = stats;
+}
+/*****************************************************************************/
+/* Secures a frame with a key index as another node would, and keeps a
+   copy of it in frame. */
+static int
+create_frame(uint8_t index)
+{
+  linkaddr_t node_addr;
+  int hdr_len;
+
+  /* The nonce of outgoing frames uses the address of this node. */
+  linkaddr_copy(&node_addr, &linkaddr_node_addr);
+  linkaddr_node_addr.u8[LINKADDR_SIZE - 1] ^= 0xff;
+
+  packetbuf_clear();
+  packetbuf_copyfrom(payload, sizeof(payload));
+  packetbuf_set_addr(PACKETBUF_ADDR_SENDER, &linkaddr_node_addr);
+  packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, &node_addr);
+  packetbuf_set_attr(PACKETBUF_ATTR_SECURITY_LEVEL, CSMA_LLSEC_SECURITY_LEVEL);
+  packetbuf_set_attr(PACKETBUF_ATTR_KEY_ID_MODE, CSMA_LLSEC_KEY_ID_MODE);
+  packetbuf_set_attr(PACKETBUF_ATTR_KEY_INDEX, index);
+  hdr_len = csma_security_create_frame();
+
+  linkaddr_copy(&linkaddr_node_addr, &node_addr);
+  if(hdr_len < 0) {
+    return 0;
+  }
+  frame_len = packetbuf_totlen();
+  memcpy(frame, packetbuf_hdrptr(), frame_len);
+  return 1;
+}
+/*****************************************************************************/
+/* Parses and authenticates the frame kept by create_frame. */
+static int
+parse_frame(void)
+{
+  packetbuf_clear();
+  packetbuf_copyfrom(frame, frame_len);
+  return csma_security_parse_frame() >= 0 &&
+    packetbuf_datalen() == sizeof(payload) &&
+    memcmp(packetbuf_dataptr(), payload, sizeof(payload)) == 0;
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(alternate, "Alternating key indices");
+UNIT_TEST(alternate)
+{
+  UNIT_TEST_BEGIN();
+
+  unsigned i;
+
+  UNIT_TEST_ASSERT(csma_security_set_key(1, key_a));
+  UNIT_TEST_ASSERT(csma_security_set_key(2, key_b));
+  UNIT_TEST_ASSERT(csma_security_set_key(3, key_a));
+  read_stats();
+  UNIT_TEST_ASSERT(entries == 0);
+
+  /* Two indices fit in the cache: only their first use expands a key. */
+  for(i = 0; i < 10; i++) {
+    UNIT_TEST_ASSERT(create_frame(1 + (i & 1)));
+  }
+  read_stats();
+  UNIT_TEST_ASSERT(misses == 2);
+  UNIT_TEST_ASSERT(hits == 8);
+  UNIT_TEST_ASSERT(entries == 2);
+
+  /* Received frames use the same cache. */
+  UNIT_TEST_ASSERT(create_frame(1));
+  UNIT_TEST_ASSERT(parse_frame());
+  read_stats();
+  UNIT_TEST_ASSERT(misses == 0);
+  UNIT_TEST_ASSERT(hits == 2);
+
+  /* Three indices in turn evict each other from a cache of two: once
+     index 3 is used, each use evicts the index that comes next. */
+  for(i = 0; i < 6; i++) {
+    UNIT_TEST_ASSERT(create_frame(1 + (i % 3)));
+  }
+  read_stats();
+  UNIT_TEST_ASSERT(hits == 2);
+  UNIT_TEST_ASSERT(misses == 4);
+  UNIT_TEST_ASSERT(entries == 2);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(set_key, "Invalidation when a key is replaced");
+UNIT_TEST(set_key)
+{
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(csma_security_set_key(1, key_a));
+  UNIT_TEST_ASSERT(csma_security_set_key(2, key_b));
+  UNIT_TEST_ASSERT(create_frame(1));
+  UNIT_TEST_ASSERT(create_frame(2));
+  UNIT_TEST_ASSERT(create_frame(1));
+  read_stats();
+  UNIT_TEST_ASSERT(entries == 2);
+
+  /* Replacing key 1 drops its schedule only. */
+  UNIT_TEST_ASSERT(csma_security_set_key(1, key_b));
+  read_stats();
+  UNIT_TEST_ASSERT(entries == 1);
+  UNIT_TEST_ASSERT(create_frame(2));
+  read_stats();
+  UNIT_TEST_ASSERT(hits == 1 && misses == 0);
+  UNIT_TEST_ASSERT(create_frame(1));
+  read_stats();
+  UNIT_TEST_ASSERT(hits == 0 && misses == 1);
+
+  /* The frame was secured with the new key: setting the same key again
+     forces a fresh expansion, which must authenticate it. */
+  UNIT_TEST_ASSERT(csma_security_set_key(1, key_b));
+  UNIT_TEST_ASSERT(parse_frame());
+  read_stats();
+  UNIT_TEST_ASSERT(hits == 0 && misses == 1);
+
+  /* With the old key back in place, the frame is not authentic. */
+  UNIT_TEST_ASSERT(create_frame(1));
+  UNIT_TEST_ASSERT(csma_security_set_key(1, key_a));
+  UNIT_TEST_ASSERT(!parse_frame());
+  read_stats();
+  UNIT_TEST_ASSERT(hits == 1 && misses == 1);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_key_cache_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(alternate);
+  UNIT_TEST_RUN(set_key);
+
+  if(!UNIT_TEST_PASSED(alternate) ||
+     !UNIT_TEST_PASSED(set_key)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
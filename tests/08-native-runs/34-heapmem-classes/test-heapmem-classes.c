@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Tests of the size classes of the heap memory module.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "lib/heapmem.h"
+#include "unit-test/unit-test.h"
+/*****************************************************************************/
+/* Size of the small objects, which have a size class. */
+#define SMALL_SIZE 32
+
+/* Size of the large objects, which are above the size classes. */
+#define LARGE_SIZE 512
+/*****************************************************************************/
+PROCESS(test_heapmem_classes_process, "Heapmem size class test process");
+AUTOSTART_PROCESSES(&test_heapmem_classes_process);
+
+/* The size of a chunk header, found from the statistics. */
+static size_t header_size;
+/*****************************************************************************/
+static size_t
+chunk_footprint(size_t size)
+{
+  return header_size + size;
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(class_reuse, "Reuse of chunks in the same size class");
+UNIT_TEST(class_reuse)
+{
+  UNIT_TEST_BEGIN();
+
+  heapmem_stats_t stats;
+
+  char *small1 = heapmem_alloc(SMALL_SIZE);
+  char *large = heapmem_alloc(LARGE_SIZE);
+  char *small2 = heapmem_alloc(SMALL_SIZE);
+  char *last = heapmem_alloc(SMALL_SIZE);
+  UNIT_TEST_ASSERT(small1 != NULL && large != NULL &&
+                   small2 != NULL && last != NULL);
+
+  heapmem_stats(&stats);
+  header_size = stats.overhead / stats.chunks;
+  UNIT_TEST_ASSERT(stats.chunks == 4);
+
+  /* Freed small chunks are kept in their size class... */
+  UNIT_TEST_ASSERT(heapmem_free(small1));
+  UNIT_TEST_ASSERT(heapmem_free(small2));
+  heapmem_stats(&stats);
+  UNIT_TEST_ASSERT(stats.free_chunks == 2);
+  UNIT_TEST_ASSERT(stats.classed_chunks == 2);
+
+  /* ...and reused by allocations of the same size, most recently
+     freed first. */
+  UNIT_TEST_ASSERT(heapmem_alloc(SMALL_SIZE - 4) == small2);
+  UNIT_TEST_ASSERT(heapmem_alloc(SMALL_SIZE) == small1);
+  heapmem_stats(&stats);
+  UNIT_TEST_ASSERT(stats.free_chunks == 0);
+
+  /* A freed large chunk is not kept in a size class. */
+  UNIT_TEST_ASSERT(heapmem_free(large));
+  heapmem_stats(&stats);
+  UNIT_TEST_ASSERT(stats.free_chunks == 1);
+  UNIT_TEST_ASSERT(stats.classed_chunks == 0);
+
+  UNIT_TEST_ASSERT(heapmem_free(small1));
+  UNIT_TEST_ASSERT(heapmem_free(small2));
+  UNIT_TEST_ASSERT(heapmem_free(last));
+  heapmem_trim();
+  heapmem_stats(&stats);
+  UNIT_TEST_ASSERT(stats.footprint == 0);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(stats_trim, "Statistics and trimming of the heap");
+UNIT_TEST(stats_trim)
+{
+  UNIT_TEST_BEGIN();
+
+  heapmem_stats_t stats;
+  heapmem_stats_t stats_again;
+  char *ptrs[4];
+
+  for(int i = 0; i < 4; i++) {
+    ptrs[i] = heapmem_alloc(SMALL_SIZE);
+    UNIT_TEST_ASSERT(ptrs[i] != NULL);
+  }
+
+  /* Two adjacent chunks in a size class are not coalesced when freed,
+     but are reported as one free chunk. */
+  UNIT_TEST_ASSERT(heapmem_free(ptrs[1]));
+  UNIT_TEST_ASSERT(heapmem_free(ptrs[2]));
+  heapmem_stats(&stats);
+  UNIT_TEST_ASSERT(stats.footprint == 4 * chunk_footprint(SMALL_SIZE));
+  UNIT_TEST_ASSERT(stats.free_chunks == 1);
+  UNIT_TEST_ASSERT(stats.classed_chunks == 1);
+  UNIT_TEST_ASSERT(stats.available ==
+                   HEAPMEM_CONF_ARENA_SIZE - 2 * chunk_footprint(SMALL_SIZE)
+                   - header_size);
+
+  /* The last chunk is released when freed, which leaves the free
+     chunks before it at the end of the heap. Obtaining statistics does
+     not release them. */
+  UNIT_TEST_ASSERT(heapmem_free(ptrs[3]));
+  heapmem_stats(&stats);
+  UNIT_TEST_ASSERT(stats.footprint == 3 * chunk_footprint(SMALL_SIZE));
+  UNIT_TEST_ASSERT(stats.free_chunks == 1);
+  heapmem_stats(&stats_again);
+  UNIT_TEST_ASSERT(memcmp(&stats, &stats_again, sizeof(stats)) == 0);
+
+  /* Trimming returns them to the unused part of the arena. */
+  heapmem_trim();
+  heapmem_stats(&stats);
+  UNIT_TEST_ASSERT(stats.footprint == chunk_footprint(SMALL_SIZE));
+  UNIT_TEST_ASSERT(stats.free_chunks == 0);
+  UNIT_TEST_ASSERT(stats.available ==
+                   HEAPMEM_CONF_ARENA_SIZE - chunk_footprint(SMALL_SIZE));
+
+  UNIT_TEST_ASSERT(heapmem_free(ptrs[0]));
+  heapmem_stats(&stats);
+  UNIT_TEST_ASSERT(stats.footprint == 0);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(reclaim, "Reclaiming size class chunks");
+UNIT_TEST(reclaim)
+{
+  UNIT_TEST_BEGIN();
+
+  static char *ptrs[HEAPMEM_CONF_ARENA_SIZE / SMALL_SIZE];
+  heapmem_stats_t stats;
+  int count;
+
+  /* Fill the heap with small objects. */
+  for(count = 0; count < sizeof(ptrs) / sizeof(ptrs[0]); count++) {
+    ptrs[count] = heapmem_alloc(SMALL_SIZE);
+    if(ptrs[count] == NULL) {
+      break;
+    }
+  }
+  UNIT_TEST_ASSERT(count > 1);
+  UNIT_TEST_ASSERT(heapmem_alloc(LARGE_SIZE) == NULL);
+
+  /* Free all but the last object. The freed chunks stay in their size
+     class, so only a merge of them can satisfy a large allocation. */
+  for(int i = 0; i < count - 1; i++) {
+    UNIT_TEST_ASSERT(heapmem_free(ptrs[i]));
+  }
+  heapmem_stats(&stats);
+  UNIT_TEST_ASSERT(stats.classed_chunks == 1);
+  UNIT_TEST_ASSERT(stats.largest_free >= LARGE_SIZE);
+
+  char *large = heapmem_alloc(LARGE_SIZE);
+  UNIT_TEST_ASSERT(large != NULL);
+  UNIT_TEST_ASSERT(large == ptrs[0]);
+
+  UNIT_TEST_ASSERT(heapmem_free(large));
+  UNIT_TEST_ASSERT(heapmem_free(ptrs[count - 1]));
+  heapmem_trim();
+  heapmem_stats(&stats);
+  UNIT_TEST_ASSERT(stats.footprint == 0);
+  UNIT_TEST_ASSERT(stats.available == HEAPMEM_CONF_ARENA_SIZE);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_heapmem_classes_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(class_reuse);
+  UNIT_TEST_RUN(stats_trim);
+  UNIT_TEST_RUN(reclaim);
+
+  if(!UNIT_TEST_PASSED(class_reuse) ||
+     !UNIT_TEST_PASSED(stats_trim) ||
+     !UNIT_TEST_PASSED(reclaim)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}